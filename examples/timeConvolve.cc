@@ -20,6 +20,7 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <chrono>
 #include <iostream>
 #include <sstream>
 #include <ctime>
@@ -43,6 +44,11 @@ const unsigned DefNIter = 10;
 const unsigned MinKernelSize = 5;
 const unsigned MaxKernelSize = 15;
 const unsigned DeltaKernelSize = 5;
+const int MaxNumThreads = 8;
+const double LargeSigma = 8;
+const unsigned MinLargeKernelSize = 21;
+const unsigned MaxLargeKernelSize = 61;
+const unsigned DeltaLargeKernelSize = 20;
 
 template <class ImageClass>
 void timeConvolution(ImageClass &image, unsigned int nIter) {
@@ -98,6 +104,61 @@ void timeConvolution(ImageClass &image, unsigned int nIter) {
         std::cout << imWidth << "\t" << imHeight << "\t" << kSize << "\t" << kSize << "\t" << mOps << "\t"
                   << secPerIter << "\t" << mOpsPerSec << std::endl;
     }
+
+    // clock() counts the CPU time of all threads, so use the elapsed time here
+    std::cout << std::endl << "Separable Kernel, multithreaded" << std::endl;
+    std::cout << "ImWid\tImHt\tKerWid\tKerHt\tThreads\tMOps\tCnvSec\tMOpsPerSec" << std::endl;
+
+    for (unsigned kSize = MinKernelSize; kSize <= MaxKernelSize; kSize += DeltaKernelSize) {
+        afwMath::GaussianFunction1<KernelType> gaussFunc(Sigma);
+        afwMath::SeparableKernel separableKernel(kSize, kSize, gaussFunc, gaussFunc);
+
+        for (int nThreads = 1; nThreads <= MaxNumThreads; nThreads *= 2) {
+            afwMath::ConvolutionControl convolutionControl;
+            convolutionControl.setNumThreads(nThreads);
+
+            auto const startTime = std::chrono::steady_clock::now();
+            for (unsigned int iter = 0; iter < nIter; ++iter) {
+                afwMath::convolve(resImage, image, separableKernel, convolutionControl);
+            }
+            std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - startTime;
+            double secPerIter = elapsed.count() / static_cast<double>(nIter);
+
+            double mOps =
+                    static_cast<double>((imHeight + 1 - kSize) * (imWidth + 1 - kSize) * kSize * kSize) /
+                    1.0e6;
+            double mOpsPerSec = mOps / secPerIter;
+            std::cout << imWidth << "\t" << imHeight << "\t" << kSize << "\t" << kSize << "\t" << nThreads
+                      << "\t" << mOps << "\t" << secPerIter << "\t" << mOpsPerSec << std::endl;
+        }
+    }
+
+    std::cout << std::endl << "Large Analytic Kernel, direct and using FFTs" << std::endl;
+    std::cout << "ImWid\tImHt\tKerWid\tKerHt\tUseFFT\tMOps\tCnvSec\tMOpsPerSec" << std::endl;
+
+    for (unsigned kSize = MinLargeKernelSize; kSize <= MaxLargeKernelSize; kSize += DeltaLargeKernelSize) {
+        afwMath::GaussianFunction2<KernelType> gaussFunc(LargeSigma, LargeSigma, 0);
+        afwMath::AnalyticKernel analyticKernel(kSize, kSize, gaussFunc);
+
+        for (bool useFft : {false, true}) {
+            afwMath::ConvolutionControl convolutionControl;
+            convolutionControl.setMinFftKernelArea(useFft ? 1 : 0);
+
+            auto const startTime = std::chrono::steady_clock::now();
+            for (unsigned int iter = 0; iter < nIter; ++iter) {
+                afwMath::convolve(resImage, image, analyticKernel, convolutionControl);
+            }
+            std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - startTime;
+            double secPerIter = elapsed.count() / static_cast<double>(nIter);
+
+            double mOps =
+                    static_cast<double>((imHeight + 1 - kSize) * (imWidth + 1 - kSize) * kSize * kSize) /
+                    1.0e6;
+            double mOpsPerSec = mOps / secPerIter;
+            std::cout << imWidth << "\t" << imHeight << "\t" << kSize << "\t" << kSize << "\t" << useFft
+                      << "\t" << mOps << "\t" << secPerIter << "\t" << mOpsPerSec << std::endl;
+        }
+    }
 }
 
 int main(int argc, char **argv) {
@@ -38,6 +38,7 @@ MaxIter = 20
 MaxTime = 1.0  # seconds
 WarpSubregion = True  # set False to warp more pixels
 SaveImages = False
+NumThreadsList = (1, 2, 4, 8)  # the first entry is the reference for the speedup
 DegPerRad = 180.0 / math.pi
 
 
@@ -193,6 +194,39 @@ def run():
                             "warpedExposure%03d.fits" % (testNum,))
                     testNum += 1
 
+    print()
+    print("Scaling with the number of threads")
+    print("interp  kernel   threads  goodPix time/iter  speedup")
+    print(" (pix)                              (sec)")
+    kernelName = "lanczos3"
+    destWcs = makeWcs(
+        projName="TAN",
+        destCtrInd=destCtrInd,
+        skyOffset=(0.0, 0.0),
+        rotAng=45.0,
+        scaleFac=1.2,
+        srcWcs=srcWcs,
+        srcCtrInd=srcCtrInd,
+    )
+    destExposure.setWcs(destWcs)
+    for interpLength in (0, 10):
+        serialTime = None
+        for numThreads in NumThreadsList:
+            warpingControl = afwMath.WarpingControl(
+                kernelName,
+                maskKernelName,
+                cacheSize,
+                interpLength,
+            )
+            warpingControl.setNumThreads(numThreads)
+            dTime, nIter, goodPix = timeWarp(
+                destExposure, srcExposure, warpingControl)
+            timePerIter = dTime/float(nIter)
+            if serialTime is None:
+                serialTime = timePerIter
+            print("%5d  %10s  %5d  %8d %6.2f  %7.2f" % (
+                interpLength, kernelName, numThreads, goodPix, timePerIter, serialTime/timePerIter))
+
 
 if __name__ == "__main__":
     run()
@@ -24,6 +24,7 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
 
 #include "lsst/afw/cameraGeom/DetectorCollection.h"
 #include "lsst/afw/cameraGeom/TransformMap.h"
@@ -81,6 +82,9 @@ public:
      * @param[in] point  position to use in lookup (lsst::geom::Point2D)
      * @param[in] cameraSys  camera coordinate system of `point`
      * @returns a list of zero or more Detectors that overlap the specified point
+     *
+     * The first call builds a focal-plane index of the detectors, so that later calls
+     * only need to transform `point` to the pixels of the detectors near it.
      */
     DetectorList findDetectors(lsst::geom::Point2D const &point, CameraSys const &cameraSys) const;
 
@@ -91,6 +95,8 @@ public:
      * @param[in] cameraSys the camera coordinate system of the points in `pointList`
      * @returns a list of lists; each list contains the names of all detectors
      *    which contain the corresponding point
+     *
+     * This uses the same focal-plane index of the detectors as findDetectors.
      */
     std::vector<DetectorList> findDetectorsList(std::vector<lsst::geom::Point2D> const &pointList,
                                                 CameraSys const &cameraSys) const;
@@ -179,6 +185,12 @@ private:
     // Deserialization factory.
     class Factory;
 
+    // Focal-plane index of the detectors, used by findDetectors and findDetectorsList.
+    class DetectorIndex;
+
+    // Return the detector index, building it on first use.
+    DetectorIndex const & getDetectorIndex() const;
+
     // Constructor used by Camera::Builder.
     // Some arguments passed by value to make moves possible.
     Camera(std::string const & name, DetectorList detectors,
@@ -194,6 +206,8 @@ private:
     std::string _name;
     std::string _pupilFactoryName;
     std::shared_ptr<TransformMap const> _transformMap;
+    mutable std::once_flag _detectorIndexFlag;
+    mutable std::unique_ptr<DetectorIndex const> _detectorIndex;
 };
 
 
@@ -22,6 +22,8 @@
 #if !defined(LSST_AFW_CAMERAGEOM_TRANSFORMMAP_H)
 #define LSST_AFW_CAMERAGEOM_TRANSFORMMAP_H
 
+#include <map>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -56,6 +58,10 @@ namespace cameraGeom {
  * providing static `make` member functions for construction (in Python, these
  * are exposed as regular constructors).
  *
+ * A TransformMap may be shared between threads.  The simplified mappings it caches are only copied
+ * (under a lock) and never used directly: the non-affine paths of @ref transform and @ref getTransform
+ * apply a per-call copy, because AST objects must not be used by more than one thread at a time.
+ *
  * @exceptsafe Unless otherwise specified, all methods guarantee only basic
  *             exception safety.
  */
@@ -147,6 +153,10 @@ public:
      * @returns the transformed value. Equivalent to
      *          `getTransform(fromSys, toSys).applyForward(point)`.
      *
+     * The simplified mapping between each pair of systems is cached on first use.  If it is affine
+     * (to within rounding error, as is the case between PIXELS and FOCAL_PLANE), points are
+     * transformed with an equivalent lsst::geom::AffineTransform instead of AST.
+     *
      * @throws lsst::pex::exceptions::InvalidParameterError Thrown if either
      *         `fromSys` or `toSys` is not supported.
      */
@@ -180,7 +190,8 @@ public:
      *
      * @param fromSys, toSys  Camera coordinate systems between which to transform
      * @returns a Transform that converts from `fromSys` to `toSys` in the forward direction.
-     *      The Transform will be invertible.
+     *      The Transform will be invertible.  Each call returns a new copy of the cached,
+     *      simplified mapping between the two systems.
      *
      * @throws lsst::pex::exceptions::InvalidParameterError Thrown if either
      *         `fromSys` or `toSys` is not supported.
@@ -234,13 +245,29 @@ private:
      * Return ast::Mapping that transforms between two coordinate systems.
      *
      * @param fromSys, toSys  Coordinate systems between which to transform
-     * @return an invertible Mapping that converts from `fromSys` to `toSys`
+     * @return an invertible Mapping that converts from `fromSys` to `toSys`; this is a new copy of the
+     *         cached mapping, so the caller may use it without locking
      *
      * @throws lsst::pex::exceptions::InvalidParameterError Thrown if either
      *         `fromSys` or `toSys` is not supported.
      */
     std::shared_ptr<ast::Mapping const> _getMapping(CameraSys const &fromSys, CameraSys const &toSys) const;
 
+    // A simplified Mapping between two coordinate systems, and its affine form if it has one.
+    struct CachedMapping;
+
+    /*
+     * Return the CachedMapping that transforms between two coordinate systems, creating it on first use.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError Thrown if either
+     *         `fromSys` or `toSys` is not supported.
+     */
+    std::shared_ptr<CachedMapping const> _getCachedMapping(CameraSys const &fromSys,
+                                                           CameraSys const &toSys) const;
+
+    // Return a copy of a CachedMapping's mapping, made while holding _mappingCacheMutex.
+    std::shared_ptr<ast::Mapping const> _copyMapping(CachedMapping const &cached) const;
+
     std::string getPersistenceName() const override;
 
     std::string getPythonModule() const override;
@@ -263,6 +290,11 @@ private:
      */
     CameraSysFrameIdMap _frameIds;
 
+    // Mappings already computed, keyed by (from, to) frame ID; guarded by _mappingCacheMutex, which
+    // must also be held while copying one of the mappings (see _copyMapping).
+    mutable std::map<std::pair<int, int>, std::shared_ptr<CachedMapping const>> _mappingCache;
+    mutable std::mutex _mappingCacheMutex;
+
 };
 
 
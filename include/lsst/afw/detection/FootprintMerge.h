@@ -49,8 +49,8 @@ class FootprintMerge;
  *  existing FootprintMerge, the Footprint will be added to it.  If not, then a new FootprintMerge will be
  *  created and added to the vector.
  *
- *  The search algorithm uses a brute force approach over the current list.  This should be fine if we
- *  are operating on smallish number of objects, such as at the tract level.
+ *  The search for overlapping FootprintMerges uses a uniform grid over their bounding boxes, so each
+ *  Footprint is only tested against the FootprintMerges near it.
  *
  */
 class FootprintMergeList final {
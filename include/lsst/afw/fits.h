@@ -574,6 +574,29 @@ public:
     /// Return the number of row in a table.
     std::size_t countRows();
 
+    /// Return the number of bytes in each row of a binary table (not including any heap).
+    std::size_t getTableRowBytes();
+
+    /**
+     *  Write raw bytes to consecutive rows of a binary table.
+     *
+     *  @param[in] firstRow  Index of the first row to write.
+     *  @param[in] nBytes    Number of bytes to write; should be a multiple of getTableRowBytes().
+     *  @param[in] data      Rows in FITS binary table format: big-endian, with any TZEROn offsets
+     *                       already applied.
+     */
+    void writeTableBytes(std::size_t firstRow, std::size_t nBytes, unsigned char const* data);
+
+    /**
+     *  Read raw bytes from consecutive rows of a binary table.
+     *
+     *  @param[in]  firstRow  Index of the first row to read.
+     *  @param[in]  nBytes    Number of bytes to read; should be a multiple of getTableRowBytes().
+     *  @param[out] data      Rows in FITS binary table format: big-endian, without any TZEROn or TSCALn
+     *                        conversions applied.
+     */
+    void readTableBytes(std::size_t firstRow, std::size_t nBytes, unsigned char* data);
+
     /// Write an array value to a binary table.
     template <typename T>
     void writeTableArray(std::size_t row, int col, int nElements, T const* value);
@@ -244,12 +244,34 @@ public:
     /// within the polygon.
     ///
     /// Note that the center of the lower-left pixel is 0,0.
+    ///
+    /// The fractions are computed exactly by integrating along the polygon's edges, one row at a time.
     std::shared_ptr<afw::image::Image<float>> createImage(lsst::geom::Box2I const& bbox) const;
     std::shared_ptr<afw::image::Image<float>> createImage(lsst::geom::Extent2I const& extent) const {
         return createImage(lsst::geom::Box2I(lsst::geom::Point2I(0, 0), extent));
     }
     //@}
 
+    /// Create an image of the coverage of many polygons
+    ///
+    /// Each pixel receives the sum over the polygons of the fraction of the pixel within the polygon,
+    /// as computed by createImage (so for e.g. the valid polygons of the inputs to a coadd, it is the
+    /// number of inputs covering the pixel).
+    static std::shared_ptr<afw::image::Image<float>> createCoverageImage(
+            std::vector<std::shared_ptr<Polygon>> const& polygons, lsst::geom::Box2I const& bbox);
+
+    /// Set bits in a mask where it is covered by any of many polygons
+    ///
+    /// @param[in] polygons  Polygons to rasterize.
+    /// @param[in,out] mask  Mask to modify.
+    /// @param[in] bitmask  Bits to set in each pixel covered by a polygon.
+    /// @param[in] minCoverage  Minimum fraction of a pixel that must lie within a single polygon for
+    ///                         the pixel to be considered covered; pixels that don't overlap a polygon
+    ///                         are never covered by it.
+    static void setCoverageMask(std::vector<std::shared_ptr<Polygon>> const& polygons,
+                                afw::image::Mask<afw::image::MaskPixel>& mask, afw::image::MaskPixel bitmask,
+                                double minCoverage = 0.0);
+
     /// Whether Polygon is persistable which is always true
     bool isPersistable() const noexcept override { return true; }
 
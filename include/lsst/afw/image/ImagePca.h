@@ -79,6 +79,13 @@ public:
      * Return the mean of the images in ImagePca's list
      */
     std::shared_ptr<ImageT> getMean() const;
+    /**
+     * Calculate the PCA decomposition of the images
+     *
+     * The matrix of inner products of the images is accumulated from blocks of pixels packed into a
+     * matrix (one column per image), and the eigen images of floating-point images are computed from
+     * the same blocks as a single matrix product.
+     */
     virtual void analyze();
     /**
      * Update the bad pixels (i.e. those for which (value & mask) != 0) based on the current PCA
@@ -100,6 +107,21 @@ public:
     /// Return Eigen images
     ImageList const& getEigenImages() const { return _eigenImages; }
 
+    /**
+     * Number of threads used by analyze to process blocks of pixels in parallel
+     *
+     * 0 means one thread per hardware thread.  The results only depend on the number of threads
+     * through the order in which the inner products are summed.
+     */
+    int getNumThreads() const { return _numThreads; }
+    void setNumThreads(int numThreads) {
+        if (numThreads < 0) {
+            throw LSST_EXCEPT(lsst::pex::exceptions::InvalidParameterError,
+                              "numThreads must be non-negative, not " + std::to_string(numThreads));
+        }
+        _numThreads = numThreads;
+    }
+
 private:
     double getFlux(int i) const { return _fluxList[i]; }
 
@@ -111,6 +133,8 @@ private:
 
     std::vector<double> _eigenValues;  // Eigen values
     ImageList _eigenImages;            // Eigen images
+
+    int _numThreads;  // number of threads used by analyze
 };
 
 /**
@@ -71,7 +71,9 @@ public:
               _undersampleStyle(THROW_EXCEPTION),
               _sctrl(new StatisticsControl(sctrl)),
               _prop(prop),
-              _actrl(new ApproximateControl(actrl)) {
+              _actrl(new ApproximateControl(actrl)),
+              _numThreads(1),
+              _sharedHistogram(false) {
         if (nxSample <= 0 || nySample <= 0) {
             throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
                               str(boost::format("You must specify at least one point, not %dx%d") % nxSample %
@@ -97,7 +99,9 @@ public:
               _undersampleStyle(THROW_EXCEPTION),
               _sctrl(new StatisticsControl(sctrl)),
               _prop(stringToStatisticsProperty(prop)),
-              _actrl(new ApproximateControl(actrl)) {
+              _actrl(new ApproximateControl(actrl)),
+              _numThreads(1),
+              _sharedHistogram(false) {
         if (nxSample <= 0 || nySample <= 0) {
             throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
                               str(boost::format("You must specify at least one point, not %dx%d") % nxSample %
@@ -127,7 +131,9 @@ public:
               _undersampleStyle(undersampleStyle),
               _sctrl(new StatisticsControl(sctrl)),
               _prop(prop),
-              _actrl(new ApproximateControl(actrl)) {
+              _actrl(new ApproximateControl(actrl)),
+              _numThreads(1),
+              _sharedHistogram(false) {
         if (nxSample <= 0 || nySample <= 0) {
             throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
                               str(boost::format("You must specify at least one point, not %dx%d") % nxSample %
@@ -157,7 +163,9 @@ public:
               _undersampleStyle(math::stringToUndersampleStyle(undersampleStyle)),
               _sctrl(new StatisticsControl(sctrl)),
               _prop(stringToStatisticsProperty(prop)),
-              _actrl(new ApproximateControl(actrl)) {
+              _actrl(new ApproximateControl(actrl)),
+              _numThreads(1),
+              _sharedHistogram(false) {
         if (nxSample <= 0 || nySample <= 0) {
             throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
                               str(boost::format("You must specify at least one point, not %dx%d") % nxSample %
@@ -219,6 +227,31 @@ public:
     std::shared_ptr<ApproximateControl> getApproximateControl() { return _actrl; }
     std::shared_ptr<ApproximateControl const> getApproximateControl() const { return _actrl; }
 
+    /**
+     * Number of threads used to measure the statistics of the cells in parallel
+     *
+     * 0 means one thread per hardware thread.  The statistics do not depend on the number of threads.
+     */
+    int getNumThreads() const { return _numThreads; }
+    void setNumThreads(int numThreads) {
+        if (numThreads < 0) {
+            throw LSST_EXCEPT(lsst::pex::exceptions::InvalidParameterError,
+                              str(boost::format("numThreads must be non-negative, not %d") % numThreads));
+        }
+        _numThreads = numThreads;
+    }
+
+    /**
+     * Should the cell medians be estimated from histograms accumulated in a single pass over the image?
+     *
+     * This is much cheaper than measuring each cell with makeStatistics, but the medians are only
+     * accurate to a small fraction of the width of the histograms' bins, which are chosen from the
+     * spread of the pixel values over the whole image.  It is only used when the statistics property
+     * is MEDIAN and the StatisticsControl is NaN-safe and unweighted; otherwise it is ignored.
+     */
+    bool getSharedHistogram() const { return _sharedHistogram; }
+    void setSharedHistogram(bool sharedHistogram) { _sharedHistogram = sharedHistogram; }
+
 private:
     Interpolate::Style _style;           // style of interpolation to use
     int _nxSample;                       // number of grid squares to divide image into to sample in x
@@ -227,6 +260,8 @@ private:
     std::shared_ptr<StatisticsControl> _sctrl;   // statistics control object
     Property _prop;                              // statistics Property
     std::shared_ptr<ApproximateControl> _actrl;  // approximate control object
+    int _numThreads;                             // number of threads used to measure the cells
+    bool _sharedHistogram;                       // estimate the cell medians from one pass over the image?
 };
 
 /**
@@ -519,9 +554,16 @@ private:
     lsst::afw::image::MaskedImage<InternalPixelT>
             _statsImage;  // statistical properties for the grid of subimages
     mutable std::vector<std::vector<double>> _gridColumns;  // interpolated columns for the bicubic spline
+    struct RowInterpolants;
+    mutable std::shared_ptr<RowInterpolants const> _rowInterpolants;  // row interpolants used by getImage
 
     void _setGridColumns(Interpolate::Style const interpStyle, UndersampleStyle const undersampleStyle,
-                         int const iX, std::vector<int> const& ypix) const;
+                         int const iX) const;
+    /**
+     * Compute the interpolants for all the rows of the image (setting _gridColumns)
+     */
+    std::shared_ptr<RowInterpolants const> _makeRowInterpolants(
+            Interpolate::Style const interpStyle, UndersampleStyle const undersampleStyle) const;
 
 #if defined(LSST_makeBackground_getImage)
     BOOST_PP_SEQ_FOR_EACH(LSST_makeBackground_getImage, override, LSST_makeBackground_getImage_types);
@@ -87,6 +87,24 @@ public:
     virtual ndarray::Array<double, 1, 1> evaluate(ndarray::Array<double const, 1> const& x,
                                                   ndarray::Array<double const, 1> const& y) const;
 
+    /**
+     *  Evaluate the field on a grid of points
+     *
+     *  @param[in]  x         array of x coordinates of the grid columns
+     *  @param[in]  y         array of y coordinates of the grid rows
+     *  @returns an array of output values with shape (y.size, x.size), whose [i][j] element is the
+     *           field evaluated at (x[j], y[i])
+     *
+     *  The default implementation makes a single call to the vectorized evaluate; subclasses may
+     *  override it to exploit the structure of the grid.  This is used by fillImage, addToImage,
+     *  multiplyImage and divideImage.
+     *
+     *  There is no bounds-checking on the given positions; this is the responsibility
+     *  of the user, who can almost always do it more efficiently.
+     */
+    virtual ndarray::Array<double, 2, 2> evaluateGrid(ndarray::Array<double const, 1> const& x,
+                                                      ndarray::Array<double const, 1> const& y) const;
+
     /**
      * Compute the integral of this function over its bounding-box.
      *
@@ -193,6 +193,15 @@ public:
     /// @copydoc BoundedField::evaluate
     double evaluate(lsst::geom::Point2D const& position) const override;
 
+    /**
+     *  @copydoc BoundedField::evaluateGrid
+     *
+     *  The Chebyshev polynomials are evaluated once for each grid column and row, and the field is
+     *  computed from them with matrix products.
+     */
+    ndarray::Array<double, 2, 2> evaluateGrid(ndarray::Array<double const, 1> const& x,
+                                              ndarray::Array<double const, 1> const& y) const override;
+
     using BoundedField::evaluate;
 
     /// @copydoc BoundedField::integrate
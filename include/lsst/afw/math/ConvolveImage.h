@@ -30,6 +30,7 @@
  * @todo Consider adding a flag to convolve indicating which specialized version of basicConvolve was used.
  *   This would only be used for unit testing and trace messages suffice (barely), so not a high priority.
  */
+#include <cassert>
 #include <limits>
 #include <sstream>
 
@@ -57,17 +58,55 @@ public:
                        )
             : _doNormalize(doNormalize),
               _doCopyEdge(doCopyEdge),
-              _maxInterpolationDistance(maxInterpolationDistance) {}
+              _maxInterpolationDistance(maxInterpolationDistance),
+              _numThreads(1),
+              _minFftKernelArea(1024),
+              _doBasisConvolution(false) {}
 
     bool getDoNormalize() const { return _doNormalize; }
     bool getDoCopyEdge() const { return _doCopyEdge; }
     int getMaxInterpolationDistance() const { return _maxInterpolationDistance; };
+    /**
+     * Number of threads used to convolve bands of rows in parallel
+     *
+     * 0 means one thread per hardware thread.  The output does not depend on the number of threads.
+     * At present spatially invariant separable kernels, kernels convolved using FFTs, and spatially
+     * varying kernels convolved using interpolation are convolved in parallel.
+     */
+    int getNumThreads() const { return _numThreads; }
+    /**
+     * Minimum number of kernel pixels (width * height) for which a spatially invariant kernel is
+     * convolved using FFTs rather than directly
+     *
+     * 0 means never use FFTs.  Separable and delta function kernels are always convolved directly,
+     * as are images with integer pixels or with non-finite input pixels.
+     */
+    int getMinFftKernelArea() const { return _minFftKernelArea; }
+    /**
+     * Convolve a spatially varying LinearCombinationKernel by convolving the %image with each basis kernel
+     * and summing the results weighted by the spatial model at each pixel?
+     *
+     * This is exact rather than interpolated, and is faster than computing the kernel %image over and
+     * over again when the basis kernels are cheap to convolve (e.g. delta functions) or few.
+     * Convolving a MaskedImage requires the variance to be convolved with the product of each
+     * overlapping pair of basis kernels.
+     */
+    bool getDoBasisConvolution() const { return _doBasisConvolution; }
 
     void setDoNormalize(bool doNormalize) { _doNormalize = doNormalize; }
     void setDoCopyEdge(bool doCopyEdge) { _doCopyEdge = doCopyEdge; }
     void setMaxInterpolationDistance(int maxInterpolationDistance) {
         _maxInterpolationDistance = maxInterpolationDistance;
     }
+    void setNumThreads(int numThreads) {
+        assert(numThreads >= 0);
+        _numThreads = numThreads;
+    }
+    void setMinFftKernelArea(int minFftKernelArea) {
+        assert(minFftKernelArea >= 0);
+        _minFftKernelArea = minFftKernelArea;
+    }
+    void setDoBasisConvolution(bool doBasisConvolution) { _doBasisConvolution = doBasisConvolution; }
 
 private:
     bool _doNormalize;              ///< normalize the kernel to sum=1?
@@ -75,6 +114,9 @@ private:
                                     ///< instead of setting them to the standard edge pixel?
     int _maxInterpolationDistance;  ///< maximum width or height of a region
                                     ///< over which to attempt interpolation
+    int _numThreads;                ///< number of threads to use; 0 for one per hardware thread
+    int _minFftKernelArea;          ///< minimum kernel width * height for which to use FFTs; 0 for never
+    bool _doBasisConvolution;       ///< convolve spatially varying LinearCombinationKernels basis by basis?
 };
 
 /**
@@ -131,9 +173,11 @@ inline typename OutImageT::SinglePixel convolveAtAPoint(
  * to the lower left corner of the sub-image, but it will almost certainly change to be
  * the lower left corner of the parent image.
  *
- * All convolution is performed in real space. This allows convolution to handle masked pixels
- * and spatially varying kernels. Although convolution of an Image with a spatially invariant kernel could,
- * in fact, be performed in Fourier space, the code does not do this.
+ * Convolution is normally performed in real space. This allows convolution to handle masked pixels
+ * and spatially varying kernels. Large spatially invariant kernels (see
+ * ConvolutionControl::getMinFftKernelArea) are instead applied to the %image and variance using FFTs,
+ * while the mask is still smeared in real space; the results agree with real space convolution
+ * to within floating point rounding error.
  *
  * Note that mask bits are smeared by convolution; all nonzero pixels in the kernel smear the mask, even
  * pixels that have very small values. Larger kernels smear the mask more and are also slower to convolve.
@@ -160,7 +204,8 @@ inline typename OutImageT::SinglePixel convolveAtAPoint(
  *   convolution with a kernel of size nCols x 1, followed by convolution with a kernel of size 1 x nRows.
  * - Convolution with spatially invariant versions of the other kernels is performed by computing
  *   the kernel %image once and convolving with that. The code has been optimized for cache performance
- *   and so should be fairly efficient.
+ *   and so should be fairly efficient. Large kernels are applied by overlap-save FFTs of tiles of the
+ *   %image, whose cost barely depends on the kernel size.
  * - Convolution with a spatially varying LinearCombinationKernel is performed by convolving the %image
  *   by each basis kernel and combining the result by solving the spatial model. This will be efficient
  *   provided the kernel does not contain too many or very large basis kernels.
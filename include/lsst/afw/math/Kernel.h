@@ -1021,6 +1021,16 @@ protected:
 
     void setKernelParameter(unsigned int ind, double value) const override;
 
+    /**
+     * Set the center and the cached kernel function values to those of another kernel
+     *
+     * Intended for use by clone(). The cache is shared rather than recomputed, which is safe
+     * because a cache is never modified once it has been computed.
+     *
+     * @param kernel  kernel with the same dimensions and kernel functions as this one
+     */
+    void copyCtrAndCache(SeparableKernel const &kernel);
+
 private:
     /**
      * Compute the column and row arrays in place, where kernel(col, row) = colList(col) * rowList(row)
@@ -1045,10 +1055,11 @@ private:
     mutable std::vector<double> _kernelX;  // used by SeparableKernel::basicComputeVectors
     mutable std::vector<double> _kernelY;
     //
-    // Cached values of the row- and column- kernels
+    // Cached values of the row- and column- kernels; null if there is no cache.
+    // computeCache replaces rather than modifies them, so clones may share them between threads.
     //
-    mutable std::vector<std::vector<double>> _kernelRowCache;
-    mutable std::vector<std::vector<double>> _kernelColCache;
+    std::shared_ptr<std::vector<std::vector<double>> const> _kernelRowCache;
+    std::shared_ptr<std::vector<std::vector<double>> const> _kernelColCache;
 
     virtual void _setKernelXY() override {
         lsst::geom::Extent2I const dim = getDimensions();
@@ -80,6 +80,16 @@ public:
     ndarray::Array<double, 1, 1> evaluate(ndarray::Array<double const, 1> const & x,
                                           ndarray::Array<double const, 1> const & y) const override;
 
+    /**
+     *  @copydoc BoundedField::evaluateGrid
+     *
+     *  When the grid is spaced by one pixel in both dimensions (as when filling an image), the SkyWcs
+     *  is evaluated once per grid point and the neighboring grid points are reused to compute the
+     *  pixel area.
+     */
+    ndarray::Array<double, 2, 2> evaluateGrid(ndarray::Array<double const, 1> const & x,
+                                              ndarray::Array<double const, 1> const & y) const override;
+
     /// PixelAreaBoundedField is persistable if and only if the nested SkyWcs
     /// is.
     bool isPersistable() const noexcept override;
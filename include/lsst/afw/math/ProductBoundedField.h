@@ -62,6 +62,10 @@ public:
     ndarray::Array<double, 1, 1> evaluate(ndarray::Array<double const, 1> const& x,
                                           ndarray::Array<double const, 1> const& y) const override;
 
+    /// @copydoc BoundedField::evaluateGrid
+    ndarray::Array<double, 2, 2> evaluateGrid(ndarray::Array<double const, 1> const& x,
+                                              ndarray::Array<double const, 1> const& y) const override;
+
     using BoundedField::evaluate;
 
     /**
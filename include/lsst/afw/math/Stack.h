@@ -27,9 +27,12 @@
 /*
  * Functions to stack images
  */
+#include <string>
 #include <vector>
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/Mask.h"
+#include "lsst/afw/image/MaskedImageFitsReader.h"
+#include "lsst/afw/image/ExposureFitsReader.h"
 #include "lsst/afw/math/Statistics.h"
 
 namespace lsst {
@@ -154,6 +157,92 @@ void statisticsStack(lsst::afw::image::MaskedImage<PixelT>& out,  ///< Output im
                      image::MaskPixel excuse = 0    ///< bitmask to excuse from marking as clipped
 );
 
+/**
+ * Compute some statistics of a stack of Masked Images that are read from FITS files a strip at a time
+ *
+ * @param[out] out         Output MaskedImage; its dimensions must match those of the inputs.
+ * @param[in] readers      Readers for the MaskedImages to process.
+ * @param[in] flags        Statistics requested.
+ * @param[in] sctrl        Control structure.
+ * @param[in] wvector      Vector of weights.
+ * @param[in] clipped      Mask to set for pixels that were clipped (NOT rejected
+ *                         due to masks).
+ * @param[in] maskMap      Vector of pairs of mask pixel values, as for the in-memory statisticsStack.
+ * @param[in] stripHeight  Number of rows to read from each input at a time.
+ *
+ * Only a strip of stripHeight rows of each input is in memory at once (plus the next strip, which is read
+ * on a separate thread while the current one is stacked), so the memory needed is proportional to
+ * stripHeight*readers.size() rather than to the size of the inputs.  The results are identical to those
+ * of the in-memory statisticsStack.
+ *
+ * The inputs are read in LOCAL coordinates, so only their dimensions need agree.
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if the inputs' dimensions differ from out's,
+ *         or stripHeight is not positive.
+ * @throws lsst::afw::fits::FitsError if the inputs cannot be read.
+ */
+template <typename PixelT>
+void statisticsStack(lsst::afw::image::MaskedImage<PixelT>& out,
+                     std::vector<std::shared_ptr<lsst::afw::image::MaskedImageFitsReader>> const& readers,
+                     Property flags, StatisticsControl const& sctrl,
+                     std::vector<lsst::afw::image::VariancePixel> const& wvector, image::MaskPixel clipped,
+                     std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const& maskMap,
+                     int stripHeight = 256);
+
+/**
+ * Compute some statistics of a stack of Exposures' Masked Images, reading them a strip at a time
+ *
+ * As for the version taking a vector of MaskedImageFitsReader.
+ */
+template <typename PixelT>
+void statisticsStack(lsst::afw::image::MaskedImage<PixelT>& out,
+                     std::vector<std::shared_ptr<lsst::afw::image::ExposureFitsReader>> const& readers,
+                     Property flags, StatisticsControl const& sctrl,
+                     std::vector<lsst::afw::image::VariancePixel> const& wvector, image::MaskPixel clipped,
+                     std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const& maskMap,
+                     int stripHeight = 256);
+
+/**
+ * Compute some statistics of a stack of Masked Images in FITS files, reading them a strip at a time
+ *
+ * As for the version taking a vector of MaskedImageFitsReader; the files may contain MaskedImages
+ * or Exposures.
+ */
+template <typename PixelT>
+void statisticsStack(lsst::afw::image::MaskedImage<PixelT>& out, std::vector<std::string> const& fileNames,
+                     Property flags, StatisticsControl const& sctrl,
+                     std::vector<lsst::afw::image::VariancePixel> const& wvector, image::MaskPixel clipped,
+                     std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const& maskMap,
+                     int stripHeight = 256);
+
+/**
+ * Compute some statistics of a stack of Masked Images read from FITS files a strip at a time
+ *
+ * As for the versions taking a maskMap, with the mask map of the in-memory statisticsStack taking an
+ * excuse mask: input pixels with any bit of sctrl.getAndMask() not in excuse set the clipped bits in
+ * the output.
+ */
+template <typename PixelT>
+void statisticsStack(lsst::afw::image::MaskedImage<PixelT>& out,
+                     std::vector<std::shared_ptr<lsst::afw::image::MaskedImageFitsReader>> const& readers,
+                     Property flags, StatisticsControl const& sctrl = StatisticsControl(),
+                     std::vector<lsst::afw::image::VariancePixel> const& wvector =
+                             std::vector<lsst::afw::image::VariancePixel>(0),
+                     image::MaskPixel clipped = 0, image::MaskPixel excuse = 0, int stripHeight = 256);
+template <typename PixelT>
+void statisticsStack(lsst::afw::image::MaskedImage<PixelT>& out,
+                     std::vector<std::shared_ptr<lsst::afw::image::ExposureFitsReader>> const& readers,
+                     Property flags, StatisticsControl const& sctrl = StatisticsControl(),
+                     std::vector<lsst::afw::image::VariancePixel> const& wvector =
+                             std::vector<lsst::afw::image::VariancePixel>(0),
+                     image::MaskPixel clipped = 0, image::MaskPixel excuse = 0, int stripHeight = 256);
+template <typename PixelT>
+void statisticsStack(lsst::afw::image::MaskedImage<PixelT>& out, std::vector<std::string> const& fileNames,
+                     Property flags, StatisticsControl const& sctrl = StatisticsControl(),
+                     std::vector<lsst::afw::image::VariancePixel> const& wvector =
+                             std::vector<lsst::afw::image::VariancePixel>(0),
+                     image::MaskPixel clipped = 0, image::MaskPixel excuse = 0, int stripHeight = 256);
+
 /**
  * A function to compute some statistics of a stack of std::vectors
  */
@@ -109,6 +109,9 @@ public:
               _isNanSafe(isNanSafe),
               _useWeights(useWeights),
               _calcErrorFromInputVariance(false),
+              _batchedStack(false),
+              _numThreads(1),
+              _quantileTolerance(0.0),
               _maskPropagationThresholds() {
         try {
             _noGoodPixelsMask = lsst::afw::image::Mask<>::getPlaneBitMask("NO_DATA");
@@ -130,6 +133,11 @@ public:
     void setMaskPropagationThreshold(int bit, double threshold);
     //@}
 
+    /// All the mask propagation thresholds, indexed by bit; bits beyond the end are not propagated
+    std::vector<double> const &getMaskPropagationThresholds() const noexcept {
+        return _maskPropagationThresholds;
+    }
+
     double getNumSigmaClip() const noexcept { return _numSigmaClip; }
     int getNumIter() const noexcept { return _numIter; }
     int getAndMask() const noexcept { return _andMask; }
@@ -138,6 +146,30 @@ public:
     bool getWeighted() const noexcept { return _useWeights == WEIGHTS_TRUE ? true : false; }
     bool getWeightedIsSet() const noexcept { return _useWeights != WEIGHTS_NONE ? true : false; }
     bool getCalcErrorFromInputVariance() const noexcept { return _calcErrorFromInputVariance; }
+    /**
+     * Should statisticsStack use the column-batched engine?
+     *
+     * The batched engine gathers a tile of pixels from every input at once and evaluates the
+     * statistic in place, rather than building a Statistics object for each output pixel.
+     * The output is identical to that of the per-pixel code; requests it cannot handle
+     * fall back to the per-pixel code.
+     */
+    bool getBatchedStack() const noexcept { return _batchedStack; }
+    /**
+     * Number of threads used by statisticsStack to process bands of rows in parallel
+     *
+     * 0 means one thread per hardware thread.  The output does not depend on the number of threads.
+     */
+    int getNumThreads() const noexcept { return _numThreads; }
+    /**
+     * Maximum acceptable error in the order statistics used for MEDIAN and IQRANGE (and to start
+     * the clipped statistics)
+     *
+     * 0 (the default) means the exact values.  A positive tolerance allows the quantiles of large
+     * floating-point images to be estimated in fewer passes; the actual error bound is available
+     * from Statistics::getQuantileErrorBound().
+     */
+    double getQuantileTolerance() const noexcept { return _quantileTolerance; }
 
     void setNumSigmaClip(double numSigmaClip) {
         assert(numSigmaClip > 0);
@@ -154,6 +186,15 @@ public:
     void setCalcErrorFromInputVariance(bool calcErrorFromInputVariance) noexcept {
         _calcErrorFromInputVariance = calcErrorFromInputVariance;
     }
+    void setBatchedStack(bool batchedStack) noexcept { _batchedStack = batchedStack; }
+    void setNumThreads(int numThreads) {
+        assert(numThreads >= 0);
+        _numThreads = numThreads;
+    }
+    void setQuantileTolerance(double quantileTolerance) {
+        assert(quantileTolerance >= 0.0);
+        _quantileTolerance = quantileTolerance;
+    }
 
 private:
     friend class Statistics;
@@ -165,6 +206,9 @@ private:
     bool _isNanSafe;                   // Check for NaNs & Infs before running (slower)
     WeightsBoolean _useWeights;        // Calculate weighted statistics (enum because of 3-valued logic)
     bool _calcErrorFromInputVariance;  // Calculate errors from the input variances, if available
+    bool _batchedStack;                // Use the column-batched engine in statisticsStack
+    int _numThreads;                   // Number of threads to use in statisticsStack
+    double _quantileTolerance;         // Maximum acceptable error in the quantiles; 0 for exact
     std::vector<double> _maskPropagationThresholds;  // Thresholds for when to propagate mask bits,
                                                      // treated like a dict (unset bits are set to 1.0)
 };
@@ -281,6 +325,13 @@ public:
      */
     double getValue(Property const prop = NOTHING) const;
     lsst::afw::image::MaskPixel getOrMask() const noexcept { return _allPixelOrMask; }
+    /**
+     * Upper bound on the error in MEDIAN and in each of the quartiles used for IQRANGE
+     *
+     * This is 0 unless a positive StatisticsControl::getQuantileTolerance() was used.  IQRANGE's
+     * error is bounded by twice this value.
+     */
+    double getQuantileErrorBound() const noexcept { return _quantileErrorBound; }
 
 private:
     long _flags;  // The desired calculation
@@ -297,6 +348,7 @@ private:
     int _nClipped;                                // number of pixels clipped
     int _nMasked;                                 // number of pixels masked
     double _iqrange;                              // the image's interquartile range
+    double _quantileErrorBound;                   // bound on the error in the median and quartiles
     lsst::afw::image::MaskPixel _allPixelOrMask;  //  the 'or' of all masked pixels
 
     StatisticsControl _sctrl;        // the control structure
@@ -85,9 +85,8 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage,
  * A version of basicConvolve that should be used when convolving a LinearCombinationKernel
  *
  * The Algorithm:
- * - If the kernel is spatially varying and contains only DeltaFunctionKernels
- *   then convolves the input Image by each basis kernel in turn, solves the spatial model
- *   for that component and adds in the appropriate amount of the convolved %image.
+ * - If the kernel is spatially varying and convolutionControl.getDoBasisConvolution() is true
+ *   then uses convolveWithBasisKernels.
  * - In all other cases uses normal convolution
  *
  * @param[out] convolvedImage convolved %image
@@ -148,6 +147,71 @@ void convolveWithBruteForce(OutImageT& convolvedImage, InImageT const& inImage,
                             lsst::afw::math::Kernel const& kernel,
                             lsst::afw::math::ConvolutionControl const& convolutionControl);
 
+/**
+ * Convolve an Image or MaskedImage with a spatially invariant Kernel using FFTs
+ *
+ * The output is divided into tiles, each of which is computed from the Fourier transform of the input
+ * pixels it depends upon (the overlap-save method).  The %image and variance planes are convolved with
+ * the kernel and the square of the kernel respectively, and each mask pixel is set to the OR of the
+ * input mask pixels under the non-zero kernel pixels, exactly as convolveWithBruteForce does.
+ * The results agree with those of convolveWithBruteForce to within floating point rounding error,
+ * and the same border of pixels is left unset.
+ *
+ * Falls back to convolveWithBruteForce if the kernel is spatially varying, if the output pixels are not
+ * floating point, or if any input %image or variance pixel is not finite (as a NaN would otherwise
+ * spread over a whole tile rather than just the pixels whose kernel footprint includes it).
+ *
+ * @param[out] convolvedImage convolved %image
+ * @param[in] inImage %image to convolve
+ * @param[in] kernel convolution kernel
+ * @param[in] convolutionControl convolution control parameters
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if convolvedImage dimensions != inImage dimensions
+ * @throws lsst::pex::exceptions::InvalidParameterError if inImage smaller than kernel in width or height
+ * @throws lsst::pex::exceptions::InvalidParameterError if kernel width or height < 1
+ * @throws std::bad_alloc when allocation of CPU memory fails
+ *
+ * @warning Low-level convolution function that does not set edge pixels.
+ */
+template <typename OutImageT, typename InImageT>
+void convolveWithFft(OutImageT& convolvedImage, InImageT const& inImage,
+                     lsst::afw::math::Kernel const& kernel,
+                     lsst::afw::math::ConvolutionControl const& convolutionControl);
+
+/**
+ * Convolve an Image or MaskedImage with a spatially varying LinearCombinationKernel by convolving
+ * the input with each basis kernel in turn
+ *
+ * The convolved %image is the sum of the basis-convolved images weighted by the spatial model
+ * (the kernel parameters) at each pixel, divided by the kernel sum if convolutionControl.getDoNormalize().
+ * For a MaskedImage the variance also includes the variance plane convolved with the product of
+ * each pair of basis kernels that overlap, and the mask is the OR of the basis-convolved masks whose
+ * weights are non-zero.  This matches convolveWithBruteForce to within rounding error, except that
+ * mask bits are smeared over the union of the basis kernels rather than the non-zero pixels of
+ * their sum, which differ only where the basis kernels exactly cancel.
+ *
+ * The basis kernels are convolved using basicConvolve, so they use the fast paths for their own
+ * types. Bands of rows of the output are computed in parallel using convolutionControl.getNumThreads()
+ * threads; the bands are fixed, so the result does not depend on the number of threads.
+ *
+ * @param[out] convolvedImage convolved %image
+ * @param[in] inImage %image to convolve
+ * @param[in] kernel convolution kernel
+ * @param[in] convolutionControl convolution control parameters
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if convolvedImage dimensions != inImage dimensions
+ * @throws lsst::pex::exceptions::InvalidParameterError if inImage smaller than kernel in width or height
+ * @throws lsst::pex::exceptions::InvalidParameterError if kernel width or height < 1
+ * @throws lsst::pex::exceptions::InvalidParameterError if kernel is not spatially varying
+ * @throws std::bad_alloc when allocation of CPU memory fails
+ *
+ * @warning Low-level convolution function that does not set edge pixels.
+ */
+template <typename OutImageT, typename InImageT>
+void convolveWithBasisKernels(OutImageT& convolvedImage, InImageT const& inImage,
+                              lsst::afw::math::LinearCombinationKernel const& kernel,
+                              lsst::afw::math::ConvolutionControl const& convolutionControl);
+
 // I would prefer this to be nested in KernelImagesForRegion but SWIG doesn't support that
 class RowOfKernelImagesForRegion;
 
@@ -395,8 +459,12 @@ private:
  *
  * The algorithm is as follows:
  * - divide the image into regions whose size is no larger than maxInterpolationDistance
- * - for each region:
- *   - convolve it using convolveRegionWithInterpolation (which see)
+ * - for each row of regions:
+ *   - compute the kernel images at the corners of the regions
+ *   - convolve each region using convolveRegionWithInterpolation (which see); the regions of a row
+ *     are convolved in parallel using convolutionControl.getNumThreads() threads,
+ *     each with its own ConvolveWithInterpolationWorkingImages. The result does not depend
+ *     on the number of threads.
  *
  * Note that this routine will also work with spatially invariant kernels, but not efficiently.
  *
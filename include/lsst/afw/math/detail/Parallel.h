@@ -0,0 +1,110 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2008-2019 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_AFW_MATH_DETAIL_PARALLEL_H
+#define LSST_AFW_MATH_DETAIL_PARALLEL_H
+/*
+ * Minimal support for running independent pieces of a computation on several threads
+ */
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+/**
+ * Return the number of threads to use for a request of nThreads
+ *
+ * @param nThreads  requested number of threads; 0 means one per hardware thread
+ */
+inline int getNumThreads(int nThreads) {
+    if (nThreads <= 0) {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return nThreads;
+}
+
+/**
+ * Split [begin, end) into contiguous bands and call function(bandBegin, bandEnd) on each band,
+ * with the bands running in parallel
+ *
+ * @param begin     start of the range
+ * @param end       end of the range (exclusive)
+ * @param nThreads  maximum number of threads to use (see getNumThreads); there are never more
+ *                  bands than elements in the range.  The calling thread processes the first band.
+ * @param function  callable with signature void(int bandBegin, int bandEnd); it is called exactly
+ *                  once per band, so any scratch space it allocates is private to its thread.
+ *
+ * The bands do not depend on anything but [begin, end) and the number of threads, and each element
+ * is processed exactly once, so as long as function writes only to the outputs for its own band the
+ * result is independent of the number of threads.
+ *
+ * If any call to function throws, the first such exception is rethrown once all the threads have
+ * finished.
+ */
+template <typename Function>
+void parallelFor(int begin, int end, int nThreads, Function const &function) {
+    int const nBand = std::min(getNumThreads(nThreads), std::max(1, end - begin));
+    if (nBand == 1) {
+        function(begin, end);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(nBand);
+    auto runBand = [&](int iBand) {
+        int const bandBegin = begin + static_cast<long>(end - begin) * iBand / nBand;
+        int const bandEnd = begin + static_cast<long>(end - begin) * (iBand + 1) / nBand;
+        try {
+            function(bandBegin, bandEnd);
+        } catch (...) {
+            errors[iBand] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(nBand - 1);
+    for (int iBand = 1; iBand < nBand; ++iBand) {
+        threads.emplace_back(runBand, iBand);
+    }
+    runBand(0);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (auto const &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_MATH_DETAIL_PARALLEL_H
@@ -0,0 +1,262 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2008-2019 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_AFW_MATH_DETAIL_PIXELMOMENTS_H
+#define LSST_AFW_MATH_DETAIL_PIXELMOMENTS_H
+/*
+ * Single-pass accumulation of the unweighted moments of runs of contiguous pixels
+ *
+ * This is for internal use by the statistics code only, and is only in a header file so that
+ * Statistics.cc and Stack.cc compute identical sums.
+ */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "lsst/afw/image/LsstImageTypes.h"
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+/**
+ * Accumulate the number, sum, sum of squares, min, max, and OR of the masks of a set of pixels
+ *
+ * The pixels are passed in as runs of contiguous values (e.g. the rows of an Image).  Pixel j of each
+ * run is added to lane j%N_LANES, and the lanes are only combined (in a fixed order) when the results
+ * are retrieved.  The lanes are independent and the per-pixel work is branch-free, so the compiler is
+ * free to interleave or vectorise the lanes for whatever instruction set it's targeting, but the order
+ * in which values are summed (and hence the result) doesn't depend on how the loop was compiled.
+ *
+ * A pixel is used if its mask has no bits in andMask set, it's finite (if checkFinite), and its value
+ * is within cliplimit of center (if doClip).  The sums are of (value - center).
+ */
+class MomentAccumulator {
+public:
+    static int const N_LANES = 8;
+
+    /**
+     * @param center      subtracted from each value before summing (e.g. a crude estimate of the mean),
+     *                    and the center of the clipping range
+     * @param cliplimit   maximum allowed |value - center| (if doClip)
+     * @param andMask     reject pixels with any of these mask bits set
+     * @param min         initial value for the minimum
+     * @param max         initial value for the maximum
+     */
+    MomentAccumulator(double center, double cliplimit, image::MaskPixel andMask,
+                      double min = std::numeric_limits<double>::max(),
+                      double max = -std::numeric_limits<double>::max())
+            : _center(center), _cliplimit(cliplimit), _andMask(andMask) {
+        for (int k = 0; k < N_LANES; ++k) {
+            _n[k] = 0;
+            _sum[k] = 0.0;
+            _sumSq[k] = 0.0;
+            _min[k] = min;
+            _max[k] = max;
+            _orMask[k] = 0x0;
+        }
+    }
+
+    /**
+     * Add a run of pixels
+     *
+     * @param values  the pixel values
+     * @param masks   the mask values, or nullptr if no pixel is masked
+     * @param size    the number of pixels
+     */
+    template <bool checkFinite, bool doClip, bool doMinMax, typename PixelT>
+    void accumulate(PixelT const *values, image::MaskPixel const *masks, int const size) {
+        static_assert(std::is_floating_point<PixelT>::value, "MomentAccumulator requires floating point");
+        if (masks) {
+            accumulateRun<checkFinite, doClip, doMinMax, true>(values, masks, size);
+        } else {
+            accumulateRun<checkFinite, doClip, doMinMax, false>(values, masks, size);
+        }
+    }
+
+    /**
+     * Add the number of rejected pixels with each mask bit set to rejectedByBit
+     *
+     * The arguments and template parameters are as for accumulate().  Only the first
+     * rejectedByBit.size() bits are counted.
+     */
+    template <bool checkFinite, bool doClip, typename PixelT>
+    void countRejected(PixelT const *values, image::MaskPixel const *masks, int const size,
+                       std::vector<double> &rejectedByBit) const {
+        int const nBits = rejectedByBit.size();
+        if (!masks || nBits == 0) {
+            return;
+        }
+        for (int j = 0; j < size; ++j) {
+            if (!isGood<checkFinite, doClip>(values[j], masks[j], _center, _cliplimit, _andMask)) {
+                for (int bit = 0; bit < nBits; ++bit) {
+                    if (masks[j] & (1 << bit)) {
+                        rejectedByBit[bit] += 1.0;
+                    }
+                }
+            }
+        }
+    }
+
+    //@{
+    /// Return the results, combining the lanes
+    int getN() const {
+        int n = 0;
+        for (int k = 0; k < N_LANES; ++k) {
+            n += _n[k];
+        }
+        return n;
+    }
+    double getSum() const { return reduceSum(_sum); }
+    double getSumSq() const { return reduceSum(_sumSq); }
+    double getMin() const {
+        double min = _min[0];
+        for (int k = 1; k < N_LANES; ++k) {
+            if (_min[k] < min) {
+                min = _min[k];
+            }
+        }
+        return min;
+    }
+    double getMax() const {
+        double max = _max[0];
+        for (int k = 1; k < N_LANES; ++k) {
+            if (_max[k] > max) {
+                max = _max[k];
+            }
+        }
+        return max;
+    }
+    image::MaskPixel getOrMask() const {
+        image::MaskPixel orMask = 0x0;
+        for (int k = 0; k < N_LANES; ++k) {
+            orMask |= _orMask[k];
+        }
+        return orMask;
+    }
+    //@}
+
+private:
+    /// Should we use this pixel?  N.b. the finiteness test is that of Statistics, in single precision
+    template <bool checkFinite, bool doClip, typename PixelT>
+    static bool isGood(PixelT const value, image::MaskPixel const mask, double const center,
+                       double const cliplimit, image::MaskPixel const andMask) {
+        // |x| <= FLT_MAX is equivalent to std::isfinite(x), but is easier for the compiler to vectorise;
+        // and we use & not && to avoid branches for the same reason
+        bool const isFinite =
+                !checkFinite || std::fabs(static_cast<float>(value)) <= std::numeric_limits<float>::max();
+        bool const inClipRange = !doClip || std::fabs(value - center) <= cliplimit;
+        return isFinite & ((mask & andMask) == 0) & inClipRange;
+    }
+
+    /// Add a single pixel to one lane, without branching
+    template <bool checkFinite, bool doClip, bool doMinMax, typename PixelT>
+    static void addPixel(PixelT const value, image::MaskPixel const mask, double const center,
+                         double const cliplimit, image::MaskPixel const andMask, int &n, double &sum,
+                         double &sumSq, double &min, double &max, image::MaskPixel &orMask) {
+        bool const good = isGood<checkFinite, doClip>(value, mask, center, cliplimit, andMask);
+        double const delta = good ? value - center : 0.0;  // n.b. value may be NaN
+        sum += delta;
+        sumSq += delta * delta;
+        n += good ? 1 : 0;
+        orMask |= good ? mask : 0x0;
+        if (doMinMax) {
+            min = (good && value < min) ? value : min;
+            max = (good && value > max) ? value : max;
+        }
+    }
+
+    template <bool checkFinite, bool doClip, bool doMinMax, bool hasMask, typename PixelT>
+    void accumulateRun(PixelT const *values, image::MaskPixel const *masks, int const size) {
+        // work on local copies of the lanes, which the compiler can keep in registers
+        int n[N_LANES];
+        double sum[N_LANES], sumSq[N_LANES], min[N_LANES], max[N_LANES];
+        image::MaskPixel orMask[N_LANES];
+        for (int k = 0; k < N_LANES; ++k) {
+            n[k] = _n[k];
+            sum[k] = _sum[k];
+            sumSq[k] = _sumSq[k];
+            min[k] = _min[k];
+            max[k] = _max[k];
+            orMask[k] = _orMask[k];
+        }
+
+        double const center = _center;
+        double const cliplimit = _cliplimit;
+        image::MaskPixel const andMask = _andMask;
+        int const nBlock = size - size % N_LANES;
+        for (int j = 0; j < nBlock; j += N_LANES) {
+            // The lanes are independent, so this loop can be vectorised
+            for (int k = 0; k < N_LANES; ++k) {
+                addPixel<checkFinite, doClip, doMinMax>(values[j + k], hasMask ? masks[j + k] : 0x0, center,
+                                                        cliplimit, andMask, n[k], sum[k], sumSq[k], min[k],
+                                                        max[k], orMask[k]);
+            }
+        }
+        for (int j = nBlock, k = 0; j < size; ++j, ++k) {  // the last, partial, block
+            addPixel<checkFinite, doClip, doMinMax>(values[j], hasMask ? masks[j] : 0x0, center, cliplimit,
+                                                    andMask, n[k], sum[k], sumSq[k], min[k], max[k],
+                                                    orMask[k]);
+        }
+
+        for (int k = 0; k < N_LANES; ++k) {
+            _n[k] = n[k];
+            _sum[k] = sum[k];
+            _sumSq[k] = sumSq[k];
+            _min[k] = min[k];
+            _max[k] = max[k];
+            _orMask[k] = orMask[k];
+        }
+    }
+
+    static double reduceSum(double const *lanes) {
+        static_assert(N_LANES == 8, "reduceSum assumes 8 lanes");
+        // pairwise, in a fixed order
+        double const s01 = lanes[0] + lanes[1];
+        double const s23 = lanes[2] + lanes[3];
+        double const s45 = lanes[4] + lanes[5];
+        double const s67 = lanes[6] + lanes[7];
+        return (s01 + s23) + (s45 + s67);
+    }
+
+    double const _center;
+    double const _cliplimit;
+    image::MaskPixel const _andMask;
+
+    int _n[N_LANES];
+    double _sum[N_LANES];
+    double _sumSq[N_LANES];
+    double _min[N_LANES];
+    double _max[N_LANES];
+    image::MaskPixel _orMask[N_LANES];
+};
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_MATH_DETAIL_PIXELMOMENTS_H
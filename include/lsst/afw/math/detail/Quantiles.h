@@ -0,0 +1,553 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2008-2019 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_AFW_MATH_DETAIL_QUANTILES_H
+#define LSST_AFW_MATH_DETAIL_QUANTILES_H
+/*
+ * Quantiles of a vector of pixel values, as used by Statistics and statisticsStack
+ *
+ * These are for internal use by the statistics code only, and are only in a header file so that
+ * Statistics.cc and Stack.cc compute identical medians and quartiles.
+ */
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+/// The median, first and third quartiles of a set of values
+typedef std::tuple<double, double, double> MedianQuartileReturn;
+
+/**
+ * A wrapper using the nth_element() built-in to compute percentiles for an image
+ *
+ * @param img       the values; they will be reordered
+ * @param fraction the desired percentile.
+ *
+ * Specialisation for non-integral types (where ties are not a problem)
+ */
+template <typename Pixel>
+typename std::enable_if<!std::is_integral<Pixel>::value, double>::type percentile(std::vector<Pixel> &img,
+                                                                                  double const fraction) {
+    assert(fraction >= 0.0 && fraction <= 1.0);
+
+    int const n = img.size();
+
+    if (n > 1) {
+        double const idx = fraction * (n - 1);
+
+        // interpolate linearly between the adjacent values
+        // For efficiency:
+        // - if we're asked for a fraction > 0.5,
+        //    we'll do the second partial sort on shorter (upper) portion
+        // - otherwise, the shorter portion will be the lower one, we'll partial-sort that.
+
+        int const q1 = static_cast<int>(idx);
+        int const q2 = q1 + 1;
+
+        auto mid1 = img.begin() + q1;
+        auto mid2 = img.begin() + q2;
+        if (fraction > 0.5) {
+            std::nth_element(img.begin(), mid1, img.end());
+            std::nth_element(mid1, mid2, img.end());
+        } else {
+            std::nth_element(img.begin(), mid2, img.end());
+            std::nth_element(img.begin(), mid1, mid2);
+        }
+
+        double val1 = static_cast<double>(*mid1);
+        double val2 = static_cast<double>(*mid2);
+        double w1 = (static_cast<double>(q2) - idx);
+        double w2 = (idx - static_cast<double>(q1));
+        return w1 * val1 + w2 * val2;
+
+    } else if (n == 1) {
+        return img[0];
+    } else {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+/**
+ * Helper function to estimate a floating-point quantile from integer data
+ *
+ * The data has been partially sorted, using nth_element
+ *
+ * @param begin   iterator to a point which we know to be below our median
+ * @param end     iterator to a point which we know to be beyond our median
+ * @param naive   the integer value of the desired quantile
+ * @param target  the number of points that should be to the left of the quantile.
+ *                N.b. if begin isn't the start of the data, this may not be the
+ *                desired number of points.  Caveat Callor
+ */
+template <typename T>
+double computeQuantile(typename std::vector<T>::const_iterator begin,
+                       typename std::vector<T>::const_iterator end, T const naive, double const target) {
+    // investigate the cumulative histogram near naive
+    std::size_t left = 0;    // number of values less than naive
+    std::size_t middle = 0;  // number of values equal to naive
+
+    for (auto ptr = begin; ptr != end; ++ptr) {
+        auto const val = *ptr;
+        if (val < naive) {
+            ++left;
+        } else if (val == naive) {
+            ++middle;
+        }
+    }
+
+    return naive - 0.5 + (target - left) / middle;
+}
+
+/**
+ * A wrapper using the nth_element() built-in to compute percentiles for a vector
+ *
+ * @param img       the values; they will be reordered
+ * @param fraction the desired percentile.
+ *
+ * This is the specialisation for integral types where we have to handle ties carefully.
+ */
+template <typename Pixel>
+typename std::enable_if<std::is_integral<Pixel>::value, double>::type percentile(std::vector<Pixel> &img,
+                                                                                 double const fraction) {
+    assert(fraction >= 0.0 && fraction <= 1.0);
+
+    auto const n = img.size();
+
+    if (n == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    } else if (n == 1) {
+        return img[0];
+    } else {
+        // We need to handle ties.  The proper way to do this is to analyse the cumulative curve after
+        // building the histograms (which is faster than a generic partitioning algorithm), but it's a
+        // nuisance as we don't know the range of values
+        //
+        // This code looks clean enough, but actually the call to nth_element is expensive
+        // and we *still* have to go through the array a second time
+
+        double const idx = fraction * (n - 1);
+
+        auto midP = img.begin() + static_cast<int>(idx);
+        std::nth_element(img.begin(), midP, img.end());
+        auto const naiveP = *midP;  // value of desired element
+
+        return computeQuantile<Pixel>(img.begin(), img.end(), naiveP, fraction * n);
+    }
+}
+
+/**
+ * A wrapper using the nth_element() built-in to compute median and Quartiles for an image
+ *
+ * @param img       the values; they will be reordered
+ *
+ * Specialisation for non-integral types (where ties are not a problem)
+ */
+template <typename Pixel>
+typename std::enable_if<!std::is_integral<Pixel>::value, MedianQuartileReturn>::type medianAndQuartiles(
+        std::vector<Pixel> &img) {
+    int const n = img.size();
+
+    if (n > 1) {
+        double const idx50 = 0.50 * (n - 1);
+        double const idx25 = 0.25 * (n - 1);
+        double const idx75 = 0.75 * (n - 1);
+
+        // For efficiency:
+        // - partition at 50th, then partition the two half further to get 25th and 75th
+        // - to get the adjacent points (for interpolation), partition between 25/50, 50/75, 75/end
+        //   these should be much smaller partitions
+
+        int const q50a = static_cast<int>(idx50);
+        int const q50b = q50a + 1;
+        int const q25a = static_cast<int>(idx25);
+        int const q25b = q25a + 1;
+        int const q75a = static_cast<int>(idx75);
+        int const q75b = q75a + 1;
+
+        auto mid50a = img.begin() + q50a;
+        auto mid50b = img.begin() + q50b;
+        auto mid25a = img.begin() + q25a;
+        auto mid25b = img.begin() + q25b;
+        auto mid75a = img.begin() + q75a;
+        auto mid75b = img.begin() + q75b;
+
+        // get the 50th percentile, then get the 25th and 75th on the smaller partitions
+        std::nth_element(img.begin(), mid50a, img.end());
+        std::nth_element(mid50a, mid75a, img.end());
+        std::nth_element(img.begin(), mid25a, mid50a);
+
+        // and the adjacent points for each ... use the smallest segments available.
+        std::nth_element(mid50a, mid50b, mid75a);
+        std::nth_element(mid25a, mid25b, mid50a);
+        std::nth_element(mid75a, mid75b, img.end());
+
+        // interpolate linearly between the adjacent values
+        double val50a = static_cast<double>(*mid50a);
+        double val50b = static_cast<double>(*mid50b);
+        double w50a = (static_cast<double>(q50b) - idx50);
+        double w50b = (idx50 - static_cast<double>(q50a));
+        double median = w50a * val50a + w50b * val50b;
+
+        double val25a = static_cast<double>(*mid25a);
+        double val25b = static_cast<double>(*mid25b);
+        double w25a = (static_cast<double>(q25b) - idx25);
+        double w25b = (idx25 - static_cast<double>(q25a));
+        double q1 = w25a * val25a + w25b * val25b;
+
+        double val75a = static_cast<double>(*mid75a);
+        double val75b = static_cast<double>(*mid75b);
+        double w75a = (static_cast<double>(q75b) - idx75);
+        double w75b = (idx75 - static_cast<double>(q75a));
+        double q3 = w75a * val75a + w75b * val75b;
+
+        return MedianQuartileReturn(median, q1, q3);
+    } else if (n == 1) {
+        return MedianQuartileReturn(img[0], img[0], img[0]);
+    } else {
+        double const NaN = std::numeric_limits<double>::quiet_NaN();
+        return MedianQuartileReturn(NaN, NaN, NaN);
+    }
+}
+
+/**
+ * A wrapper using the nth_element() built-in to compute median and Quartiles for an image
+ *
+ * @param img       the values; they will be reordered
+ *
+ * This is the specialisation for integral types where we have to handle ties carefully.
+ */
+template <typename Pixel>
+typename std::enable_if<std::is_integral<Pixel>::value, MedianQuartileReturn>::type medianAndQuartiles(
+        std::vector<Pixel> &img) {
+    auto const n = img.size();
+
+    if (n == 0) {
+        double const NaN = std::numeric_limits<double>::quiet_NaN();
+        return MedianQuartileReturn(NaN, NaN, NaN);
+    } else if (n == 1) {
+        return MedianQuartileReturn(img[0], img[0], img[0]);
+    } else {
+        // We need to handle ties.  The proper way to do this is to analyse the cumulative curve after
+        // building the histograms (which is faster than a generic partitioning algorithm), but it's a
+        // nuisance as we don't know the range of values
+        //
+        // This code looks clean enough, but actually the call to nth_element is expensive
+        // and we *still* have to go through the array a second time.
+
+        // For efficiency:
+        // - partition at 50th, then partition the two halves further to get 25th and 75th
+
+        auto mid25 = img.begin() + static_cast<int>(0.25 * (n - 1));
+        auto mid50 = img.begin() + static_cast<int>(0.50 * (n - 1));
+        auto mid75 = img.begin() + static_cast<int>(0.75 * (n - 1));
+
+        // get the 50th percentile, then get the 25th and 75th on the smaller partitions
+        std::nth_element(img.begin(), mid50, img.end());
+        std::nth_element(img.begin(), mid25, mid50);
+        std::nth_element(mid50, mid75, img.end());
+
+        double const q1 = computeQuantile<Pixel>(img.begin(), mid50, *mid25, 0.25 * n);
+        double const median = computeQuantile<Pixel>(mid25, mid75, *mid50, 0.50 * n - (mid25 - img.begin()));
+        double const q3 = computeQuantile<Pixel>(mid50, img.end(), *mid75, 0.75 * n - (mid50 - img.begin()));
+
+        return MedianQuartileReturn(median, q1, q3);
+    }
+}
+
+/// The unsigned integer type used as a radix key for a floating-point type
+template <typename Pixel>
+struct RadixKey;
+template <>
+struct RadixKey<float> {
+    typedef std::uint32_t type;
+};
+template <>
+struct RadixKey<double> {
+    typedef std::uint64_t type;
+};
+
+/**
+ * Map a floating-point value to an unsigned integer with the same ordering
+ *
+ * Only valid for non-NaN values; -0.0 sorts just below +0.0
+ */
+template <typename Pixel>
+typename RadixKey<Pixel>::type toRadixKey(Pixel const value) {
+    typedef typename RadixKey<Pixel>::type Key;
+    Key const signBit = Key(1) << (8 * sizeof(Key) - 1);
+    Key bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & signBit) ? ~bits : (bits | signBit);
+}
+
+/// The inverse of toRadixKey
+template <typename Pixel>
+Pixel fromRadixKey(typename RadixKey<Pixel>::type const key) {
+    typedef typename RadixKey<Pixel>::type Key;
+    Key const signBit = Key(1) << (8 * sizeof(Key) - 1);
+    Key const bits = (key & signBit) ? (key & ~signBit) : ~key;
+    Pixel value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * Compute quantiles of a set of floating-point values by radix selection, without copying the values
+ *
+ * The values are visited by calling `forEachValue(fn)`, which must call `fn(value)` for every value,
+ * in any order, and the same values on every call; none of them may be NaN.  Each pass over the values
+ * histograms the next RADIX_BITS bits of the order-preserving integer keys of the values in the buckets
+ * containing the desired order statistics, so the number of passes is bounded by the number of bits
+ * in the key divided by RADIX_BITS (two passes for floats); as soon as a bucket holds no more than
+ * MAX_GATHER values they are copied into a small buffer and the order statistics found with nth_element.
+ * There may be at most 2^32 - 1 values.
+ *
+ * The quantiles are defined, and interpolated, exactly as in percentile() and medianAndQuartiles(),
+ * and are identical to their results when `tolerance` is 0.  If `tolerance` is positive, selection stops
+ * as soon as the range of values in a bucket is no larger than `tolerance`, and the centre of
+ * the bucket is used for the order statistic.
+ *
+ * @param forEachValue  functor to visit the values
+ * @param fractions     the desired quantiles, each in [0, 1]
+ * @param tolerance     the maximum acceptable error in each order statistic; 0 for exact results
+ *
+ * @returns a (quantile, maximum absolute error) pair for each of fractions;
+ *          NaN if there are no values
+ */
+template <typename Pixel, typename ForEachValue>
+std::vector<std::pair<double, double>> radixQuantiles(ForEachValue const &forEachValue,
+                                                      std::vector<double> const &fractions,
+                                                      double const tolerance = 0.0) {
+    static_assert(std::is_floating_point<Pixel>::value, "radixQuantiles requires floating point values");
+    typedef typename RadixKey<Pixel>::type Key;
+    int const KEY_BITS = 8 * sizeof(Key);
+    int const RADIX_BITS = 16;
+    std::size_t const MAX_GATHER = 1 << 14;
+
+    // The state of our search for one order statistic: the element of rank "rank" lies in a bucket
+    // of keys [low, low + 2^shift), which holds count values and has nBelow values below it
+    struct Selection {
+        std::size_t rank;
+        Key low;
+        int shift;
+        std::size_t nBelow;
+        std::size_t count;
+        bool done;
+        double value;
+        double error;
+    };
+    // One pass's work on a single bucket, shared by all the Selections in that bucket
+    struct Job {
+        Key low;
+        Key width;                     // the bucket is [low, low + width]
+        int shift;
+        int bits;                      // number of bits to histogram; 0 to gather the values instead
+        std::vector<std::uint32_t> hist;
+        std::vector<Pixel> values;
+        std::vector<int> selections;  // indices into the selections
+    };
+    auto runPass = [&forEachValue](std::vector<Job> &jobs) {
+        forEachValue([&jobs](Pixel const value) {
+            Key const key = toRadixKey(value);
+            for (auto &job : jobs) {
+                // a single (rarely true) comparison, as key >= low is unpredictable
+                if (static_cast<Key>(key - job.low) <= job.width) {
+                    if (job.bits == 0) {
+                        job.values.push_back(value);
+                    } else {
+                        ++job.hist[(key - job.low) >> (job.shift - job.bits)];
+                    }
+                }
+            }
+        });
+    };
+    // Move a selection down into the histogram bin containing its rank
+    auto descend = [](Selection &sel, Job const &job) {
+        int const shift = job.shift - job.bits;
+        std::size_t nBelow = sel.nBelow;
+        std::size_t bin = 0;
+        while (nBelow + job.hist[bin] <= sel.rank) {
+            nBelow += job.hist[bin++];
+        }
+        sel.low = job.low + (static_cast<Key>(bin) << shift);
+        sel.shift = shift;
+        sel.nBelow = nBelow;
+        sel.count = job.hist[bin];
+    };
+
+    // The first pass histograms the top bits of all the keys, and counts the values
+    std::vector<Job> jobs(1);
+    jobs[0].low = 0;
+    jobs[0].width = std::numeric_limits<Key>::max();
+    jobs[0].shift = KEY_BITS;
+    jobs[0].bits = RADIX_BITS;
+    jobs[0].hist.assign(std::size_t(1) << RADIX_BITS, 0);
+    runPass(jobs);
+    std::size_t n = 0;
+    for (auto const count : jobs[0].hist) {
+        n += count;
+    }
+
+    double const NaN = std::numeric_limits<double>::quiet_NaN();
+    if (n == 0) {
+        return std::vector<std::pair<double, double>>(fractions.size(), std::make_pair(NaN, NaN));
+    }
+
+    // The ranks we need, for interpolation as in percentile()
+    std::vector<Selection> selections;
+    auto addRank = [&selections](std::size_t const rank) {
+        for (auto const &sel : selections) {
+            if (sel.rank == rank) {
+                return;
+            }
+        }
+        selections.push_back(Selection{rank, 0, KEY_BITS, 0, 0, false, 0.0, 0.0});
+    };
+    for (auto const fraction : fractions) {
+        assert(fraction >= 0.0 && fraction <= 1.0);
+        std::size_t const q1 = static_cast<std::size_t>(fraction * (n - 1));
+        addRank(q1);
+        if (q1 + 1 < n) {
+            addRank(q1 + 1);
+        }
+    }
+    for (auto &sel : selections) {
+        descend(sel, jobs[0]);
+    }
+
+    for (;;) {
+        jobs.clear();
+        for (std::size_t i = 0; i < selections.size(); ++i) {
+            Selection &sel = selections[i];
+            if (sel.done) {
+                continue;
+            }
+            Key const width = (sel.shift == 0) ? Key(0) : ((Key(1) << sel.shift) - 1);
+            Key const high = sel.low + width;
+            double const lowValue = fromRadixKey<Pixel>(sel.low);
+            double const highValue = fromRadixKey<Pixel>(high);
+            if (sel.shift == 0) {  // all the values in the bucket are equal
+                sel.done = true;
+                sel.value = lowValue;
+                sel.error = 0.0;
+                continue;
+            } else if (tolerance > 0.0 && highValue - lowValue <= tolerance) {
+                sel.done = true;
+                sel.value = 0.5 * (lowValue + highValue);
+                sel.error = 0.5 * (highValue - lowValue);
+                continue;
+            }
+
+            Job *job = nullptr;
+            for (auto &j : jobs) {
+                if (j.low == sel.low && j.shift == sel.shift) {
+                    job = &j;
+                    break;
+                }
+            }
+            if (!job) {
+                jobs.emplace_back();
+                job = &jobs.back();
+                job->low = sel.low;
+                job->width = width;
+                job->shift = sel.shift;
+                if (sel.count <= MAX_GATHER) {
+                    job->bits = 0;
+                    job->values.reserve(sel.count);
+                } else {
+                    job->bits = std::min(RADIX_BITS, sel.shift);
+                    job->hist.assign(std::size_t(1) << job->bits, 0);
+                }
+            }
+            job->selections.push_back(i);
+        }
+        if (jobs.empty()) {
+            break;
+        }
+
+        runPass(jobs);
+
+        for (auto &job : jobs) {
+            for (int const i : job.selections) {
+                Selection &sel = selections[i];
+                if (job.bits == 0) {
+                    auto const nth = job.values.begin() + (sel.rank - sel.nBelow);
+                    std::nth_element(job.values.begin(), nth, job.values.end());
+                    sel.done = true;
+                    sel.value = *nth;
+                    sel.error = 0.0;
+                } else {
+                    descend(sel, job);
+                }
+            }
+        }
+    }
+
+    auto getSelection = [&selections](std::size_t const rank) -> Selection const & {
+        for (auto const &sel : selections) {
+            if (sel.rank == rank) {
+                return sel;
+            }
+        }
+        assert(false);
+        return selections[0];
+    };
+    std::vector<std::pair<double, double>> results;
+    for (auto const fraction : fractions) {
+        if (n == 1) {
+            Selection const &sel = getSelection(0);
+            results.emplace_back(sel.value, sel.error);
+            continue;
+        }
+        double const idx = fraction * (n - 1);
+        std::size_t const q1 = static_cast<std::size_t>(idx);
+        std::size_t const q2 = std::min(q1 + 1, n - 1);
+        Selection const &sel1 = getSelection(q1);
+        Selection const &sel2 = getSelection(q2);
+
+        // interpolate linearly between the adjacent values, as in percentile()
+        double const w1 = (static_cast<double>(q1 + 1) - idx);
+        double const w2 = (idx - static_cast<double>(q1));
+        results.emplace_back(w1 * sel1.value + w2 * sel2.value, w1 * sel1.error + w2 * sel2.error);
+    }
+    return results;
+}
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_MATH_DETAIL_QUANTILES_H
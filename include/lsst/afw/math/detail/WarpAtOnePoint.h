@@ -21,9 +21,14 @@
  * the GNU General Public License along with this program.  If not,
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
+#include <cmath>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
+#include "lsst/geom/Angle.h"
 #include "lsst/afw/math/Kernel.h"
+#include "lsst/afw/math/warpExposure.h"
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/geom/Point.h"
@@ -35,6 +40,18 @@ namespace detail {
 
 /**
  * A functor that computes one warped pixel
+ *
+ * Each functor uses its own clones of the control's warping kernels (which share the kernels' caches),
+ * so functors may be used on different threads. Constructing one calls control.getWarpingKernel and
+ * control.getMaskWarpingKernel, which update the kernel caches if the cache size has changed; call those
+ * on one thread before constructing functors on several threads.
+ *
+ * Lanczos warping kernels of order 1-5 and bilinear warping kernels with their default centers are
+ * evaluated with code specialized for their (compile-time) size: the kernel vectors are computed
+ * without virtual Function1 calls (unless the kernel has a cache) and each warped pixel is computed
+ * directly from the image planes. For a MaskedImage the mask warping kernel, if any, is applied in the
+ * same traversal of the source pixels. The arithmetic is the same as for the generic code, so the
+ * results are identical.
  */
 template <typename DestImageT, typename SrcImageT>
 class WarpAtOnePoint final {
@@ -42,9 +59,12 @@ public:
     WarpAtOnePoint(SrcImageT const &srcImage, WarpingControl const &control,
                    typename DestImageT::SinglePixel padValue)
             : _srcImage(srcImage),
-              _kernelPtr(control.getWarpingKernel()),
-              _maskKernelPtr(control.getMaskWarpingKernel()),
-              _hasMaskKernel(control.getMaskWarpingKernel()),
+              _kernelPtr(std::static_pointer_cast<SeparableKernel>(control.getWarpingKernel()->clone())),
+              _maskKernelPtr(control.hasMaskWarpingKernel()
+                                     ? std::static_pointer_cast<SeparableKernel>(
+                                               control.getMaskWarpingKernel()->clone())
+                                     : nullptr),
+              _hasMaskKernel(control.hasMaskWarpingKernel()),
               _kernelCtr(_kernelPtr->getCtr()),
               _maskKernelCtr(_maskKernelPtr ? _maskKernelPtr->getCtr() : lsst::geom::Point2I(0, 0)),
               _growFullMask(control.getGrowFullMask()),
@@ -53,7 +73,15 @@ public:
               _maskXList(_maskKernelPtr ? _maskKernelPtr->getWidth() : 0),
               _maskYList(_maskKernelPtr ? _maskKernelPtr->getHeight() : 0),
               _padValue(padValue),
-              _srcGoodBBox(_kernelPtr->shrinkBBox(srcImage.getBBox(lsst::afw::image::LOCAL))){};
+              _srcGoodBBox(_kernelPtr->shrinkBBox(srcImage.getBBox(lsst::afw::image::LOCAL))),
+              _kernelFunction(_getKernelFunction(*_kernelPtr)),
+              _maskKernelFunction(_maskKernelPtr ? _getKernelFunction(*_maskKernelPtr) : GENERIC_FUNCTION),
+              _fixedWidth(0) {
+        if (std::is_floating_point<typename DestImageT::Image::Pixel>::value &&
+            std::is_floating_point<typename SrcImageT::Image::Pixel>::value && _isSpecialized(*_kernelPtr)) {
+            _fixedWidth = _kernelPtr->getWidth();
+        }
+    };
 
     /**
      * Compute one warped pixel, Image specialization
@@ -84,9 +112,7 @@ public:
             // Compute warped pixel
             double kSum = _setFracIndex(srcIndFracX.second, srcIndFracY.second);
 
-            typename SrcImageT::const_xy_locator srcLoc = _srcImage.xy_at(srcStartX, srcStartY);
-
-            *destXIter = lsst::afw::math::convolveAtAPoint<DestImageT, SrcImageT>(srcLoc, _xList, _yList);
+            *destXIter = _convolve(srcStartX, srcStartY, lsst::afw::image::detail::Image_tag());
             *destXIter *= relativeArea / kSum;
             return true;
         } else {
@@ -126,12 +152,10 @@ public:
             // Compute warped pixel
             double kSum = _setFracIndex(srcIndFracX.second, srcIndFracY.second);
 
-            typename SrcImageT::const_xy_locator srcLoc = _srcImage.xy_at(srcStartX, srcStartY);
-
-            *destXIter = lsst::afw::math::convolveAtAPoint<DestImageT, SrcImageT>(srcLoc, _xList, _yList);
+            *destXIter = _convolve(srcStartX, srcStartY, lsst::afw::image::detail::MaskedImage_tag());
             *destXIter *= relativeArea / kSum;
 
-            if (_hasMaskKernel) {
+            if (_hasMaskKernel && _fixedWidth == 0) {  // else _convolveFixed applied the mask kernel
                 // compute mask value based on the mask kernel (replacing the value computed above)
                 int maskStartX = srcIndFracX.first - _maskKernelCtr[0];
                 int maskStartY = srcIndFracY.first - _maskKernelCtr[1];
@@ -172,6 +196,13 @@ public:
     }
 
 private:
+    // How the warping kernel vectors are computed
+    enum KernelFunction {
+        GENERIC_FUNCTION,   // by the kernel
+        LANCZOS_FUNCTION,   // inline, as by LanczosWarpingKernel
+        BILINEAR_FUNCTION,  // inline, as by BilinearWarpingKernel
+    };
+
     /**
      * Set parameters of kernel (and mask kernel, if present) and update X and Y values
      *
@@ -179,15 +210,213 @@ private:
      */
     double _setFracIndex(double xFrac, double yFrac) {
         std::pair<double, double> srcFracInd(xFrac, yFrac);
-        _kernelPtr->setKernelParameters(srcFracInd);
-        double kSum = _kernelPtr->computeVectors(_xList, _yList, false);
+        double const kSum =
+                _computeVectors(*_kernelPtr, _kernelFunction, _kernelCtr, srcFracInd, _xList, _yList);
         if (_maskKernelPtr) {
-            _maskKernelPtr->setKernelParameters(srcFracInd);
-            _maskKernelPtr->computeVectors(_maskXList, _maskYList, false);
+            _computeVectors(*_maskKernelPtr, _maskKernelFunction, _maskKernelCtr, srcFracInd, _maskXList,
+                            _maskYList);
         }
         return kSum;
     }
 
+    /**
+     * Is the kernel a Lanczos warping kernel of order 1-5 or a bilinear warping kernel, with its default
+     * center?
+     */
+    static bool _isSpecialized(SeparableKernel const &kernel) {
+        int const width = kernel.getWidth();
+        int const defaultCtr = (width - 1) / 2;
+        if (width != kernel.getHeight() || kernel.getCtr() != lsst::geom::Point2I(defaultCtr, defaultCtr)) {
+            return false;
+        }
+        return (dynamic_cast<LanczosWarpingKernel const *>(&kernel) && width <= 10) ||
+               dynamic_cast<BilinearWarpingKernel const *>(&kernel);
+    }
+
+    /// Pick how to compute the vectors of a kernel
+    static KernelFunction _getKernelFunction(SeparableKernel const &kernel) {
+        if (!_isSpecialized(kernel) || kernel.getCacheSize() > 0) {
+            return GENERIC_FUNCTION;  // looking up the cache is already fast
+        }
+        return dynamic_cast<LanczosWarpingKernel const *>(&kernel) ? LANCZOS_FUNCTION : BILINEAR_FUNCTION;
+    }
+
+    /**
+     * Set the parameters of a kernel and compute its X and Y values
+     *
+     * @returns sum of kernel
+     */
+    static double _computeVectors(SeparableKernel &kernel, KernelFunction kernelFunction,
+                                  lsst::geom::Point2I const &ctr, std::pair<double, double> const &srcFracInd,
+                                  std::vector<double> &xList, std::vector<double> &yList) {
+        switch (kernelFunction) {
+            case LANCZOS_FUNCTION:
+                return _computeLanczosVector(srcFracInd.first, ctr.getX(), xList) *
+                       _computeLanczosVector(srcFracInd.second, ctr.getY(), yList);
+            case BILINEAR_FUNCTION:
+                return _computeBilinearVector(srcFracInd.first, ctr.getX(), xList) *
+                       _computeBilinearVector(srcFracInd.second, ctr.getY(), yList);
+            default:
+                kernel.setKernelParameters(srcFracInd);
+                return kernel.computeVectors(xList, yList, false);
+        }
+    }
+
+    /**
+     * Compute one axis of a Lanczos warping kernel, using the same arithmetic as LanczosFunction1
+     *
+     * @returns sum of the values
+     */
+    static double _computeLanczosVector(double frac, int ctr, std::vector<double> &values) {
+        double const invN = 1.0 / static_cast<double>(values.size() / 2);
+        double sum = 0.0;
+        for (int i = 0, size = values.size(); i < size; ++i) {
+            double const xArg1 = (static_cast<double>(i - ctr) - frac) * lsst::geom::PI;
+            double const xArg2 = xArg1 * invN;
+            double const value =
+                    std::fabs(xArg1) > 1.0e-5 ? std::sin(xArg1) * std::sin(xArg2) / (xArg1 * xArg2) : 1.0;
+            values[i] = value;
+            sum += value;
+        }
+        return sum;
+    }
+
+    /**
+     * Compute one axis of a bilinear warping kernel, using the same arithmetic as
+     * BilinearWarpingKernel::BilinearFunction1
+     *
+     * @returns sum of the values
+     */
+    static double _computeBilinearVector(double frac, int ctr, std::vector<double> &values) {
+        double sum = 0.0;
+        for (int i = 0, size = values.size(); i < size; ++i) {
+            double const value =
+                    0.5 + (1.0 - (2.0 * std::fabs(frac))) * (0.5 - std::fabs(static_cast<double>(i - ctr)));
+            values[i] = value;
+            sum += value;
+        }
+        return sum;
+    }
+
+    /**
+     * Apply the warping kernel to the source image, with its (0, 0) pixel at (srcStartX, srcStartY)
+     */
+    template <typename ImageTag>
+    typename DestImageT::SinglePixel _convolve(int srcStartX, int srcStartY, ImageTag imageTag) const {
+        switch (_fixedWidth) {
+            case 2:
+                return _convolveFixed<2>(srcStartX, srcStartY, imageTag);
+            case 4:
+                return _convolveFixed<4>(srcStartX, srcStartY, imageTag);
+            case 6:
+                return _convolveFixed<6>(srcStartX, srcStartY, imageTag);
+            case 8:
+                return _convolveFixed<8>(srcStartX, srcStartY, imageTag);
+            case 10:
+                return _convolveFixed<10>(srcStartX, srcStartY, imageTag);
+            default:
+                return lsst::afw::math::convolveAtAPoint<DestImageT, SrcImageT>(
+                        _srcImage.xy_at(srcStartX, srcStartY), _xList, _yList);
+        }
+    }
+
+    /**
+     * Apply a SIZE x SIZE warping kernel to an Image
+     *
+     * This matches convolveAtAPoint(locator, kernelXList, kernelYList), including skipping zero kernel
+     * values.
+     */
+    template <int SIZE>
+    typename DestImageT::SinglePixel _convolveFixed(int srcStartX, int srcStartY,
+                                                    lsst::afw::image::detail::Image_tag) const {
+        typedef typename DestImageT::SinglePixel OutT;
+        OutT outValue = 0;
+        for (int kRow = 0; kRow < SIZE; ++kRow) {
+            typename SrcImageT::x_iterator srcIter = _srcImage.x_at(srcStartX, srcStartY + kRow);
+            OutT outValueY = 0;
+            for (int kCol = 0; kCol < SIZE; ++kCol, ++srcIter) {
+                double const kValX = _xList[kCol];
+                if (kValX != 0) {
+                    outValueY += *srcIter * kValX;
+                }
+            }
+            double const kValY = _yList[kRow];
+            if (kValY != 0) {
+                outValue += outValueY * kValY;
+            }
+        }
+        return outValue;
+    }
+
+    /**
+     * Apply a SIZE x SIZE warping kernel to a MaskedImage
+     *
+     * This matches convolveAtAPoint(locator, kernelXList, kernelYList), including skipping zero kernel values
+     * and the precision of the pixel expression templates: products of a pixel and a kernel value are
+     * computed in the pixel's type.
+     *
+     * If there is a mask warping kernel its mask value is computed in the same pass (the mask kernel lies
+     * within the warping kernel; see WarpingControl), and the returned mask is the final one.
+     */
+    template <int SIZE>
+    typename DestImageT::SinglePixel _convolveFixed(int srcStartX, int srcStartY,
+                                                    lsst::afw::image::detail::MaskedImage_tag) const {
+        typedef typename SrcImageT::Image::Pixel SrcImagePixelT;
+        typedef typename SrcImageT::Variance::Pixel SrcVariancePixelT;
+        typedef typename DestImageT::Image::Pixel DestImagePixelT;
+        typedef typename DestImageT::Mask::Pixel DestMaskPixelT;
+        typedef typename DestImageT::Variance::Pixel DestVariancePixelT;
+
+        // position of the mask kernel's (0, 0) pixel within the warping kernel
+        int const maskOffsetX = _kernelCtr.getX() - _maskKernelCtr.getX();
+        int const maskOffsetY = _kernelCtr.getY() - _maskKernelCtr.getY();
+        int const maskWidth = _maskXList.size();
+        int const maskHeight = _maskYList.size();
+
+        DestImagePixelT outImage = 0;
+        DestMaskPixelT outMask = 0;
+        DestVariancePixelT outVariance = 0;
+        DestMaskPixelT outMaskKernelMask = 0;
+        for (int kRow = 0; kRow < SIZE; ++kRow) {
+            typename SrcImageT::x_iterator srcIter = _srcImage.x_at(srcStartX, srcStartY + kRow);
+            int const maskRow = kRow - maskOffsetY;
+            bool const useMaskRow = maskRow >= 0 && maskRow < maskHeight && _maskYList[maskRow] != 0;
+            DestImagePixelT rowImage = 0;
+            DestMaskPixelT rowMask = 0;
+            DestVariancePixelT rowVariance = 0;
+            DestMaskPixelT rowMaskKernelMask = 0;
+            for (int kCol = 0; kCol < SIZE; ++kCol, ++srcIter) {
+                double const kValX = _xList[kCol];
+                if (kValX != 0) {
+                    SrcImagePixelT const kImage = kValX;
+                    SrcVariancePixelT const kVariance = kValX;
+                    rowImage += static_cast<SrcImagePixelT>(srcIter.image() * kImage);
+                    rowMask |= srcIter.mask();
+                    rowVariance += static_cast<SrcVariancePixelT>(srcIter.variance() * kVariance * kVariance);
+                }
+                if (useMaskRow) {
+                    int const maskCol = kCol - maskOffsetX;
+                    if (maskCol >= 0 && maskCol < maskWidth && _maskXList[maskCol] != 0) {
+                        rowMaskKernelMask |= srcIter.mask();
+                    }
+                }
+            }
+            double const kValY = _yList[kRow];
+            if (kValY != 0) {
+                DestImagePixelT const kImage = kValY;
+                DestVariancePixelT const kVariance = kValY;
+                outImage += rowImage * kImage;
+                outMask |= rowMask;
+                outVariance += rowVariance * kVariance * kVariance;
+            }
+            outMaskKernelMask |= rowMaskKernelMask;
+        }
+        if (_hasMaskKernel) {
+            outMask = (outMask & _growFullMask) | outMaskKernelMask;
+        }
+        return typename DestImageT::SinglePixel(outImage, outMask, outVariance);
+    }
+
     SrcImageT _srcImage;
     std::shared_ptr<lsst::afw::math::SeparableKernel> _kernelPtr;
     std::shared_ptr<lsst::afw::math::SeparableKernel> _maskKernelPtr;
@@ -201,6 +430,9 @@ private:
     std::vector<double> _maskYList;
     typename DestImageT::SinglePixel _padValue;
     lsst::geom::Box2I const _srcGoodBBox;
+    KernelFunction _kernelFunction;
+    KernelFunction _maskKernelFunction;
+    int _fixedWidth;  // width and height of the kernel if _convolveFixed can be used, else 0
 };
 }  // namespace detail
 }  // namespace math
@@ -29,6 +29,7 @@
 #ifndef LSST_AFW_MATH_WARPEXPOSURE_H
 #define LSST_AFW_MATH_WARPEXPOSURE_H
 
+#include <cassert>
 #include <memory>
 #include <string>
 
@@ -273,7 +274,9 @@ public:
               _maskWarpingKernelPtr(),
               _cacheSize(cacheSize),
               _interpLength(interpLength),
-              _growFullMask(growFullMask) {
+              _growFullMask(growFullMask),
+              _numThreads(1),
+              _maxInterpError(0) {
         setMaskWarpingKernelName(maskWarpingKernelName);
     }
 
@@ -315,6 +318,26 @@ public:
         _interpLength = interpLength;
     };
 
+    /**
+     * get the maximum allowed error of interpolating the WCS (source pixels); 0 if not checked
+     */
+    double getMaxInterpError() const { return _maxInterpError; }
+
+    /**
+     * set the maximum allowed error of interpolating the WCS
+     *
+     * If positive (and the interpolation length is positive) the interpolation length is only an upper
+     * limit: the WCS is evaluated exactly on grids of decreasing spacing, starting at the interpolation
+     * length and halving it, until the error of interpolating over a grid cell, measured at the center
+     * of every cell, is no larger than maxInterpError. If no spacing of at least 4 pixels is good enough
+     * then the WCS is evaluated exactly at every pixel (as for an interpolation length of 0).
+     */
+    void setMaxInterpError(double maxInterpError  ///< maximum error (source pixels); 0 to not check
+    ) {
+        assert(maxInterpError >= 0);
+        _maxInterpError = maxInterpError;
+    }
+
     /**
      * get the warping kernel
      */
@@ -373,6 +396,24 @@ public:
         _growFullMask = growFullMask;
     }
 
+    /**
+     * get the number of threads used to warp bands of rows in parallel
+     */
+    int getNumThreads() const { return _numThreads; }
+
+    /**
+     * set the number of threads used to warp bands of rows in parallel
+     *
+     * 0 means one thread per hardware thread. The warped %image does not depend on the number of threads.
+     * The WCS is only evaluated on the calling thread, so warping with interpolation (see setInterpLength)
+     * scales much better than warping without it.
+     */
+    void setNumThreads(int numThreads  ///< number of threads
+    ) {
+        assert(numThreads >= 0);
+        _numThreads = numThreads;
+    }
+
 private:
     /**
      * Throw an exception if the two kernels are not compatible in shape
@@ -389,6 +430,8 @@ private:
     int _cacheSize;
     int _interpLength;
     lsst::afw::image::MaskPixel _growFullMask;
+    int _numThreads;
+    double _maxInterpError;
 };
 
 /**
@@ -344,6 +344,28 @@ public:
         return io::FitsReader::apply<CatalogT>(filename, hdu, flags);
     }
 
+    /**
+     *  Read a subset of the fields of a FITS binary table from a regular file.
+     *
+     *  Fields that are not selected are not read, which can be much faster for wide tables.
+     *
+     *  @param[in] filename    Name of the file to read.
+     *  @param[in] columns     Names (or aliases) of the fields to read.  Any fields required by the
+     *                         table class (i.e. its minimal schema) must be included.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *                         The default value of afw::fits::DEFAULT_HDU is interpreted as
+     *                         "the first HDU with NAXIS != 0".
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See e.g. SourceFitsFlags.
+     *
+     *  @throws pex::exceptions::NotFoundError if a column is not present in the file.
+     */
+    static CatalogT readFits(std::string const& filename, std::vector<std::string> const& columns,
+                             int hdu = fits::DEFAULT_HDU, int flags = 0) {
+        return io::FitsReader::apply<CatalogT>(filename, hdu, flags,
+                                               std::shared_ptr<io::InputArchive>(), columns);
+    }
+
     /**
      *  Read a FITS binary table from a RAM file.
      *
@@ -0,0 +1,85 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_DETAIL_BigEndian_h_INCLUDED
+#define AFW_TABLE_DETAIL_BigEndian_h_INCLUDED
+
+/*
+ * Byte-order conversions between record fields and the big-endian cells of FITS binary table rows, shared
+ * by FitsWriter (which packs rows) and FitsSchemaInputMapper (which unpacks them).
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace lsst {
+namespace afw {
+namespace table {
+namespace detail {
+
+/// @internal Return true if this machine stores integers with the least significant byte first.
+inline bool isLittleEndian() {
+    static bool const result = [] {
+        std::uint16_t const one = 1;
+        unsigned char first;
+        std::memcpy(&first, &one, 1);
+        return first == 1;
+    }();
+    return result;
+}
+
+/// @internal Copy n values to out in big-endian byte order, returning the end of the output.
+template <typename T>
+unsigned char *packBigEndian(T const *values, int n, unsigned char *out) {
+    bool const swap = isLittleEndian();
+    for (int i = 0; i < n; ++i, out += sizeof(T)) {
+        unsigned char const *bytes = reinterpret_cast<unsigned char const *>(values + i);
+        if (swap) {
+            std::reverse_copy(bytes, bytes + sizeof(T), out);
+        } else {
+            std::copy(bytes, bytes + sizeof(T), out);
+        }
+    }
+    return out;
+}
+
+/// @internal Copy n big-endian values from in.
+template <typename T>
+void unpackBigEndian(unsigned char const *in, int n, T *values) {
+    bool const swap = isLittleEndian();
+    for (int i = 0; i < n; ++i, in += sizeof(T)) {
+        unsigned char *bytes = reinterpret_cast<unsigned char *>(values + i);
+        if (swap) {
+            std::reverse_copy(in, in + sizeof(T), bytes);
+        } else {
+            std::copy(in, in + sizeof(T), bytes);
+        }
+    }
+}
+
+/*
+ * CFITSIO stores unsigned 16-bit columns ('U') as signed integers with TZERO=32768, so these overloads
+ * flip the sign bit.  FitsSchemaInputMapper only unpacks columns with that TZERO.
+ */
+
+/// @internal Copy n unsigned 16-bit values to out as TZERO=32768 signed integers.
+inline unsigned char *packBigEndian(std::uint16_t const *values, int n, unsigned char *out) {
+    for (int i = 0; i < n; ++i) {
+        std::uint16_t const value = values[i] ^ 0x8000;
+        out = packBigEndian<std::uint16_t>(&value, 1, out);
+    }
+    return out;
+}
+
+/// @internal Copy n TZERO=32768 signed 16-bit integers from in as unsigned values.
+inline void unpackBigEndian(unsigned char const *in, int n, std::uint16_t *values) {
+    unpackBigEndian<std::uint16_t>(in, n, values);
+    for (int i = 0; i < n; ++i) {
+        values[i] ^= 0x8000;
+    }
+}
+
+}  // namespace detail
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_DETAIL_BigEndian_h_INCLUDED
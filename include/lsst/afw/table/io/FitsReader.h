@@ -3,6 +3,7 @@
 #define AFW_TABLE_IO_FitsReader_h_INCLUDED
 
 #include <type_traits>
+#include <vector>
 
 #include "lsst/afw/fits.h"
 #include "lsst/afw/table/Schema.h"
@@ -66,14 +67,18 @@ public:
      *                       archive argument is provided only for cases in which the catalog itself is
      *                       part of a larger object, and does not "own" its own archive (e.g. CoaddPsf
      *                       persistence).
+     *  @param[in]  columns  Names of the fields to read (see FitsSchemaInputMapper::selectFields); if
+     *                       empty, all fields are read.
      */
     template <typename ContainerT>
     static ContainerT apply(afw::fits::Fits& fits, int ioFlags,
-                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>()) {
+                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>(),
+                            std::vector<std::string> const& columns = std::vector<std::string>()) {
         std::shared_ptr<daf::base::PropertyList> metadata = std::make_shared<daf::base::PropertyList>();
         fits.readMetadata(*metadata, true);
         FitsReader const* reader = _lookupFitsReader(*metadata);
         FitsSchemaInputMapper mapper(*metadata, true);
+        mapper.selectFields(columns);
         reader->_setupArchive(fits, mapper, archive, ioFlags);
         std::shared_ptr<BaseTable> table = reader->makeTable(mapper, metadata, ioFlags, true);
         ContainerT container(std::dynamic_pointer_cast<typename ContainerT::Table>(table));
@@ -82,15 +87,14 @@ public:
         }
         std::size_t nRows = fits.countRows();
         container.reserve(nRows);
+        std::vector<BaseRecord*> records(nRows);
         for (std::size_t row = 0; row < nRows; ++row) {
-            mapper.readRecord(
-                    // We need to be able to support reading Catalog<T const>, since it shares the same
-                    // template
-                    // as Catalog<T> (which invokes this method in readFits).
-                    const_cast<typename std::remove_const<typename ContainerT::Record>::type&>(
-                            *container.addNew()),
-                    fits, row);
+            // We need to be able to support reading Catalog<T const>, since it shares the same template
+            // as Catalog<T> (which invokes this method in readFits).
+            records[row] = const_cast<typename std::remove_const<typename ContainerT::Record>::type*>(
+                    container.addNew().get());
         }
+        mapper.readRecords(records, fits, 0);
         return container;
     }
 
@@ -102,10 +106,11 @@ public:
      */
     template <typename ContainerT, typename SourceT>
     static ContainerT apply(SourceT& source, int hdu, int ioFlags,
-                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>()) {
+                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>(),
+                            std::vector<std::string> const& columns = std::vector<std::string>()) {
         afw::fits::Fits fits(source, "r", afw::fits::Fits::AUTO_CLOSE | afw::fits::Fits::AUTO_CHECK);
         fits.setHdu(hdu);
-        return apply<ContainerT>(fits, ioFlags, archive);
+        return apply<ContainerT>(fits, ioFlags, archive, columns);
     }
 
     /**
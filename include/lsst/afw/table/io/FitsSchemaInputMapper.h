@@ -106,6 +106,12 @@ public:
      */
     static std::size_t PREPPED_ROWS_FACTOR;
 
+    /**
+     *  Number of threads readRecords() uses to unpack the columns of raw binary table rows
+     *  (0 to use all available cores).
+     */
+    static int NUM_READ_THREADS;
+
     /// Construct a mapper from a PropertyList of FITS header values, stripping recognized keys if desired.
     FitsSchemaInputMapper(daf::base::PropertyList &metadata, bool stripMetadata);
 
@@ -169,6 +175,18 @@ public:
      */
     void customize(std::unique_ptr<FitsColumnReader> reader);
 
+    /**
+     *  Restrict the regular fields added by finalize() to those with the given names.
+     *
+     *  Names may also be aliases in the schema's AliasMap.  Fields that are not selected are not read.
+     *  If the table will be used to construct a table subclass with a minimal schema, the fields of that
+     *  schema must be included.  An empty vector selects all fields.
+     *
+     *  @throws pex::exceptions::NotFoundError (from finalize()) if a name does not correspond to any
+     *          column in the table.
+     */
+    void selectFields(std::vector<std::string> const &names);
+
     /**
      *  Map any remaining items into regular Schema items, and return the final Schema.
      *
@@ -181,6 +199,15 @@ public:
      */
     void readRecord(BaseRecord &record, afw::fits::Fits &fits, std::size_t row);
 
+    /**
+     *  Fill records from consecutive FITS binary table rows, starting at firstRow.
+     *
+     *  This is equivalent to calling readRecord() for each record, but when the table layout permits it,
+     *  reads blocks of raw rows with a single CFITSIO call and unpacks the regular columns from them
+     *  directly (see NUM_READ_THREADS).
+     */
+    void readRecords(std::vector<BaseRecord *> const &records, afw::fits::Fits &fits, std::size_t firstRow);
+
 private:
     class Impl;
     std::shared_ptr<Impl> _impl;
@@ -72,6 +72,7 @@ public:
         for (typename ContainerT::const_iterator i = container.begin(); i != container.end(); ++i) {
             _writeRecord(*i);
         }
+        _flushRecords();
         _finish();
     }
 
@@ -100,8 +101,13 @@ protected:
 
 private:
     struct ProcessRecords;
+    struct PackRecords;
+
+    /// Write any records buffered by _writeRecord.
+    void _flushRecords();
 
     std::shared_ptr<ProcessRecords> _processor;  // a private Schema::forEach functor that write records
+    std::shared_ptr<PackRecords> _packer;        // a private Schema::forEach functor that buffers records
 };
 }  // namespace io
 }  // namespace table
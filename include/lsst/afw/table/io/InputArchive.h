@@ -70,8 +70,15 @@ public:
      *  Read an object from an already open FITS object.
      *
      *  @param[in]  fitsfile     FITS object to read from, already positioned at the desired HDU.
+     *  @param[in]  lazy         If true, read only the index HDU now, and read each data HDU the
+     *                           first time an object that uses it is loaded.  The HDU is left at the
+     *                           index, and is restored after each later read.  The caller must keep
+     *                           fitsfile open for as long as objects may be loaded from the archive.
+     *
+     *  If lazy is false (the default), all the data HDUs are read immediately and the FITS object is
+     *  left positioned at the last of them.
      */
-    static InputArchive readFits(fits::Fits& fitsfile);
+    static InputArchive readFits(fits::Fits& fitsfile, bool lazy = false);
 
 private:
     class Impl;
@@ -24,6 +24,7 @@
  */
 
 #include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
 
 #include "lsst/utils/python.h"
 
@@ -87,6 +88,10 @@ PySortedCatalog<Record> declareSortedCatalog(utils::python::WrapperCollection &w
                                "filename"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
                 cls.def_static("readFits", (Catalog(*)(fits::MemFileManager &, int, int)) & Catalog::readFits,
                                "manager"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
+                cls.def_static("readFits",
+                               (Catalog(*)(std::string const &, std::vector<std::string> const &, int, int)) &
+                                       Catalog::readFits,
+                               "filename"_a, "columns"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
                 // readFits taking Fits objects not wrapped, because Fits objects are not wrapped.
 
                 cls.def("subset",
@@ -126,6 +126,9 @@ PYBIND11_MODULE(polygon, mod) {
             "createImage",
             (std::shared_ptr<afw::image::Image<float>>(Polygon::*)(lsst::geom::Extent2I const &) const) &
                     Polygon::createImage);
+    clsPolygon.def_static("createCoverageImage", &Polygon::createCoverageImage, "polygons"_a, "bbox"_a);
+    clsPolygon.def_static("setCoverageMask", &Polygon::setCoverageMask, "polygons"_a, "mask"_a, "bitmask"_a,
+                          "minCoverage"_a = 0.0);
     // clsPolygon.def("isPersistable", &Polygon::isPersistable);
 }
 }  // namespace polygon
@@ -49,6 +49,8 @@ static void declareImagePca(py::module &mod, std::string const &suffix) {
     cls.def("updateBadPixels", &ImagePca<ImageT>::updateBadPixels);
     cls.def("getEigenValues", &ImagePca<ImageT>::getEigenValues);
     cls.def("getEigenImages", &ImagePca<ImageT>::getEigenImages);
+    cls.def("getNumThreads", &ImagePca<ImageT>::getNumThreads);
+    cls.def("setNumThreads", &ImagePca<ImageT>::setNumThreads, "numThreads"_a);
 }
 
 template <typename Image1T, typename Image2T>
@@ -132,6 +132,10 @@ PYBIND11_MODULE(background, mod) {
     clsBackgroundControl.def("getApproximateControl",
                              (std::shared_ptr<ApproximateControl> (BackgroundControl::*)()) &
                                      BackgroundControl::getApproximateControl);
+    clsBackgroundControl.def("getNumThreads", &BackgroundControl::getNumThreads);
+    clsBackgroundControl.def("setNumThreads", &BackgroundControl::setNumThreads);
+    clsBackgroundControl.def("getSharedHistogram", &BackgroundControl::getSharedHistogram);
+    clsBackgroundControl.def("setSharedHistogram", &BackgroundControl::setSharedHistogram);
 
     /* Note that, in this case, the holder type must be unique_ptr to enable usage
      * of py::nodelete, which in turn is needed because Background has a protected
@@ -86,6 +86,12 @@ PYBIND11_MODULE(convolveImage, mod) {
     clsConvolutionControl.def("setDoCopyEdge", &ConvolutionControl::setDoCopyEdge);
     clsConvolutionControl.def("setMaxInterpolationDistance",
                               &ConvolutionControl::setMaxInterpolationDistance);
+    clsConvolutionControl.def("getNumThreads", &ConvolutionControl::getNumThreads);
+    clsConvolutionControl.def("setNumThreads", &ConvolutionControl::setNumThreads);
+    clsConvolutionControl.def("getMinFftKernelArea", &ConvolutionControl::getMinFftKernelArea);
+    clsConvolutionControl.def("setMinFftKernelArea", &ConvolutionControl::setMinFftKernelArea);
+    clsConvolutionControl.def("getDoBasisConvolution", &ConvolutionControl::getDoBasisConvolution);
+    clsConvolutionControl.def("setDoBasisConvolution", &ConvolutionControl::setDoBasisConvolution);
 
     declareAll<double, double>(mod);
     declareAll<double, float>(mod);
@@ -21,6 +21,7 @@
  */
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <pybind11/pybind11.h>
@@ -39,6 +40,8 @@ namespace {
 
 template <typename PixelT>
 void declareStatisticsStack(py::module &mod) {
+    using MaskMap = std::vector<std::pair<lsst::afw::image::MaskPixel, lsst::afw::image::MaskPixel>>;
+
     mod.def("statisticsStack", (std::shared_ptr<lsst::afw::image::MaskedImage<PixelT>>(*)(
                                        lsst::afw::image::Image<PixelT> const &, Property, char,
                                        StatisticsControl const &))statisticsStack<PixelT>,
@@ -97,6 +100,51 @@ void declareStatisticsStack(py::module &mod) {
                     std::vector<std::pair<lsst::afw::image::MaskPixel, lsst::afw::image::MaskPixel>> const &
                 ))statisticsStack<PixelT>,
             "images"_a, "flags"_a, "sctrl"_a, "wvector"_a, "clipped"_a, "maskMap"_a);
+    // The versions taking a maskMap require it, so that calls without one use the same default mask map
+    // (from excuse) as the in-memory versions.
+    mod.def("statisticsStack",
+            (void (*)(lsst::afw::image::MaskedImage<PixelT> &,
+                      std::vector<std::shared_ptr<lsst::afw::image::MaskedImageFitsReader>> const &, Property,
+                      StatisticsControl const &, std::vector<lsst::afw::image::VariancePixel> const &,
+                      lsst::afw::image::MaskPixel, MaskMap const &, int))statisticsStack<PixelT>,
+            "out"_a, "readers"_a, "flags"_a, "sctrl"_a, "wvector"_a, "clipped"_a, "maskMap"_a,
+            "stripHeight"_a = 256);
+    mod.def("statisticsStack",
+            (void (*)(lsst::afw::image::MaskedImage<PixelT> &,
+                      std::vector<std::shared_ptr<lsst::afw::image::ExposureFitsReader>> const &, Property,
+                      StatisticsControl const &, std::vector<lsst::afw::image::VariancePixel> const &,
+                      lsst::afw::image::MaskPixel, MaskMap const &, int))statisticsStack<PixelT>,
+            "out"_a, "readers"_a, "flags"_a, "sctrl"_a, "wvector"_a, "clipped"_a, "maskMap"_a,
+            "stripHeight"_a = 256);
+    mod.def("statisticsStack",
+            (void (*)(lsst::afw::image::MaskedImage<PixelT> &, std::vector<std::string> const &, Property,
+                      StatisticsControl const &, std::vector<lsst::afw::image::VariancePixel> const &,
+                      lsst::afw::image::MaskPixel, MaskMap const &, int))statisticsStack<PixelT>,
+            "out"_a, "fileNames"_a, "flags"_a, "sctrl"_a, "wvector"_a, "clipped"_a, "maskMap"_a,
+            "stripHeight"_a = 256);
+    mod.def("statisticsStack",
+            (void (*)(lsst::afw::image::MaskedImage<PixelT> &,
+                      std::vector<std::shared_ptr<lsst::afw::image::MaskedImageFitsReader>> const &, Property,
+                      StatisticsControl const &, std::vector<lsst::afw::image::VariancePixel> const &,
+                      lsst::afw::image::MaskPixel, lsst::afw::image::MaskPixel, int))statisticsStack<PixelT>,
+            "out"_a, "readers"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
+            "wvector"_a = std::vector<lsst::afw::image::VariancePixel>(0), "clipped"_a = 0, "excuse"_a = 0,
+            "stripHeight"_a = 256);
+    mod.def("statisticsStack",
+            (void (*)(lsst::afw::image::MaskedImage<PixelT> &,
+                      std::vector<std::shared_ptr<lsst::afw::image::ExposureFitsReader>> const &, Property,
+                      StatisticsControl const &, std::vector<lsst::afw::image::VariancePixel> const &,
+                      lsst::afw::image::MaskPixel, lsst::afw::image::MaskPixel, int))statisticsStack<PixelT>,
+            "out"_a, "readers"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
+            "wvector"_a = std::vector<lsst::afw::image::VariancePixel>(0), "clipped"_a = 0, "excuse"_a = 0,
+            "stripHeight"_a = 256);
+    mod.def("statisticsStack",
+            (void (*)(lsst::afw::image::MaskedImage<PixelT> &, std::vector<std::string> const &, Property,
+                      StatisticsControl const &, std::vector<lsst::afw::image::VariancePixel> const &,
+                      lsst::afw::image::MaskPixel, lsst::afw::image::MaskPixel, int))statisticsStack<PixelT>,
+            "out"_a, "fileNames"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
+            "wvector"_a = std::vector<lsst::afw::image::VariancePixel>(0), "clipped"_a = 0, "excuse"_a = 0,
+            "stripHeight"_a = 256);
     mod.def("statisticsStack",
             (std::vector<PixelT>(*)(
                     std::vector<std::vector<PixelT>> &, Property, StatisticsControl const &,
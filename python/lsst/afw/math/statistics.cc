@@ -115,6 +115,9 @@ PYBIND11_MODULE(statistics, mod) {
     clsStatisticsControl.def("getWeightedIsSet", &StatisticsControl::getWeightedIsSet);
     clsStatisticsControl.def("getCalcErrorFromInputVariance",
                              &StatisticsControl::getCalcErrorFromInputVariance);
+    clsStatisticsControl.def("getBatchedStack", &StatisticsControl::getBatchedStack);
+    clsStatisticsControl.def("getNumThreads", &StatisticsControl::getNumThreads);
+    clsStatisticsControl.def("getQuantileTolerance", &StatisticsControl::getQuantileTolerance);
     clsStatisticsControl.def("setNumSigmaClip", &StatisticsControl::setNumSigmaClip);
     clsStatisticsControl.def("setNumIter", &StatisticsControl::setNumIter);
     clsStatisticsControl.def("setAndMask", &StatisticsControl::setAndMask);
@@ -123,6 +126,9 @@ PYBIND11_MODULE(statistics, mod) {
     clsStatisticsControl.def("setWeighted", &StatisticsControl::setWeighted);
     clsStatisticsControl.def("setCalcErrorFromInputVariance",
                              &StatisticsControl::setCalcErrorFromInputVariance);
+    clsStatisticsControl.def("setBatchedStack", &StatisticsControl::setBatchedStack);
+    clsStatisticsControl.def("setNumThreads", &StatisticsControl::setNumThreads);
+    clsStatisticsControl.def("setQuantileTolerance", &StatisticsControl::setQuantileTolerance);
 
     py::class_<Statistics> clsStatistics(mod, "Statistics");
 
@@ -130,6 +136,7 @@ PYBIND11_MODULE(statistics, mod) {
     clsStatistics.def("getError", &Statistics::getError, "prop"_a = Property::NOTHING);
     clsStatistics.def("getValue", &Statistics::getValue, "prop"_a = Property::NOTHING);
     clsStatistics.def("getOrMask", &Statistics::getOrMask);
+    clsStatistics.def("getQuantileErrorBound", &Statistics::getQuantileErrorBound);
 
     declareStatistics<unsigned short>(mod);
     declareStatistics<double>(mod);
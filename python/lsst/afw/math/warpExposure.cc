@@ -133,7 +133,8 @@ void declareWarpingFunctions(py::module &mod) {
 PYBIND11_MODULE(warpExposure, mod) {
     /* Module level */
     auto clsLanczosWarpingKernel = declareWarpingKernel<LanczosWarpingKernel>(mod, "LanczosWarpingKernel");
-    declareSimpleWarpingKernel<BilinearWarpingKernel>(mod, "BilinearWarpingKernel");
+    auto clsBilinearWarpingKernel =
+            declareSimpleWarpingKernel<BilinearWarpingKernel>(mod, "BilinearWarpingKernel");
     declareSimpleWarpingKernel<NearestWarpingKernel>(mod, "NearestWarpingKernel");
 
     py::class_<WarpingControl, std::shared_ptr<WarpingControl>> clsWarpingControl(mod, "WarpingControl");
@@ -149,6 +150,14 @@ PYBIND11_MODULE(warpExposure, mod) {
     declareWarpingFunctions<std::uint16_t, std::uint16_t>(mod);
 
     /* Member types and enums */
+    py::class_<BilinearWarpingKernel::BilinearFunction1,
+               std::shared_ptr<BilinearWarpingKernel::BilinearFunction1>, Function1<Kernel::Pixel>>
+            clsBilinearFunction1(clsBilinearWarpingKernel, "BilinearFunction1");
+    clsBilinearFunction1.def(py::init<double>(), "fracPos"_a);
+    clsBilinearFunction1.def("__call__", &BilinearWarpingKernel::BilinearFunction1::operator(), "x"_a);
+    clsBilinearFunction1.def("clone", &BilinearWarpingKernel::BilinearFunction1::clone);
+    clsBilinearFunction1.def("toString", &BilinearWarpingKernel::BilinearFunction1::toString,
+                             "prefix"_a = "");
 
     /* Constructors */
     clsLanczosWarpingKernel.def(py::init<int>(), "order"_a);
@@ -164,6 +173,8 @@ PYBIND11_MODULE(warpExposure, mod) {
     clsWarpingControl.def("setCacheSize", &WarpingControl::setCacheSize, "cacheSize"_a);
     clsWarpingControl.def("getInterpLength", &WarpingControl::getInterpLength);
     clsWarpingControl.def("setInterpLength", &WarpingControl::setInterpLength, "interpLength"_a);
+    clsWarpingControl.def("getMaxInterpError", &WarpingControl::getMaxInterpError);
+    clsWarpingControl.def("setMaxInterpError", &WarpingControl::setMaxInterpError, "maxInterpError"_a);
     clsWarpingControl.def("setWarpingKernelName", &WarpingControl::setWarpingKernelName,
                           "warpingKernelName"_a);
     clsWarpingControl.def("getWarpingKernel", &WarpingControl::getWarpingKernel);
@@ -178,6 +189,8 @@ PYBIND11_MODULE(warpExposure, mod) {
                           "maskWarpingKernel"_a);
     clsWarpingControl.def("getGrowFullMask", &WarpingControl::getGrowFullMask);
     clsWarpingControl.def("setGrowFullMask", &WarpingControl::setGrowFullMask, "growFullMask"_a);
+    clsWarpingControl.def("getNumThreads", &WarpingControl::getNumThreads);
+    clsWarpingControl.def("setNumThreads", &WarpingControl::setNumThreads, "numThreads"_a);
 
     /* Members */
 }
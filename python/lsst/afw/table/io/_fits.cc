@@ -38,6 +38,8 @@ void wrapFits(utils::python::WrapperCollection& wrappers) {
         mod.def("setPreppedRowsFactor",
                 [](std::size_t n) { FitsSchemaInputMapper::PREPPED_ROWS_FACTOR = n; });
         mod.def("getPreppedRowsFactor", []() { return FitsSchemaInputMapper::PREPPED_ROWS_FACTOR; });
+        mod.def("setNumReadThreads", [](int n) { FitsSchemaInputMapper::NUM_READ_THREADS = n; });
+        mod.def("getNumReadThreads", []() { return FitsSchemaInputMapper::NUM_READ_THREADS; });
     });
 }
 
@@ -19,6 +19,9 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include "lsst/afw/table/io/Persistable.cc"
 #include "lsst/afw/table/io/CatalogVector.h"
 #include "lsst/afw/table/io/InputArchive.h"
@@ -34,24 +37,161 @@ namespace {
 // Set this as a function to ensure FOCAL_PLANE is defined before use.
 CameraSys const getNativeCameraSys() { return FOCAL_PLANE; }
 
+// Number of points along each edge of a detector used to find its footprint on the focal plane
+int const NUM_EDGE_POINTS = 8;
+
+// Fraction of its size by which a detector's focal-plane footprint is grown, to allow for
+// curvature of FOCAL_PLANE <-> PIXELS transforms between the points on its edges
+double const FOOTPRINT_PADDING = 0.01;
+
+// Target number of index cells per detector
+int const CELLS_PER_DETECTOR = 4;
+
+// Maximum number of index cells along each axis
+int const MAX_CELLS_PER_AXIS = 1024;
+
 } // anonymoous
 
+/*
+ * A regular grid over the focal-plane region covered by the detectors, listing for each cell the
+ * detectors whose (bounding box of the) footprint overlaps it.
+ *
+ * A point can only be on the detectors listed for the cell it falls in; those whose footprint
+ * couldn't be computed (because their PIXELS -> FOCAL_PLANE transform isn't finite on their edges)
+ * are listed for every cell, and for points outside the grid.  Candidates are listed in the order
+ * of getIdMap(), so the index doesn't change the order of the results.
+ */
+class Camera::DetectorIndex {
+public:
+
+    explicit DetectorIndex(Camera const & camera) {
+        _detectors.reserve(camera.size());
+        for (auto const & item : camera.getIdMap()) {
+            _detectors.push_back(item.second);
+        }
+
+        std::vector<lsst::geom::Box2D> footprints;
+        footprints.reserve(_detectors.size());
+        for (std::size_t i = 0; i < _detectors.size(); ++i) {
+            auto const footprint = computeFootprint(*_detectors[i]);
+            if (footprint.isEmpty()) {
+                _unbounded.push_back(i);
+            } else {
+                _bbox.include(footprint);
+            }
+            footprints.push_back(footprint);
+        }
+
+        // Cells roughly square, with about CELLS_PER_DETECTOR of them per detector
+        std::size_t const nBounded = _detectors.size() - _unbounded.size();
+        if (nBounded > 0) {
+            double const cellSize = std::sqrt(_bbox.getArea() / (CELLS_PER_DETECTOR * nBounded));
+            auto numCells = [cellSize](double length) {
+                return (cellSize > 0) ? std::max(1, std::min(MAX_CELLS_PER_AXIS,
+                                                             static_cast<int>(std::ceil(length / cellSize))))
+                                      : 1;
+            };
+            _nx = numCells(_bbox.getWidth());
+            _ny = numCells(_bbox.getHeight());
+        }
+        _cells.resize(static_cast<std::size_t>(_nx) * _ny);
+
+        for (std::size_t i = 0; i < _detectors.size(); ++i) {
+            auto const & footprint = footprints[i];
+            if (footprint.isEmpty()) {
+                for (auto & cell : _cells) {
+                    cell.push_back(i);
+                }
+                continue;
+            }
+            int const ix0 = getCellX(footprint.getMinX()), ix1 = getCellX(footprint.getMaxX());
+            int const iy0 = getCellY(footprint.getMinY()), iy1 = getCellY(footprint.getMaxY());
+            for (int iy = iy0; iy <= iy1; ++iy) {
+                for (int ix = ix0; ix <= ix1; ++ix) {
+                    _cells[iy*_nx + ix].push_back(i);
+                }
+            }
+        }
+    }
+
+    // All the detectors, in the order of Camera::getIdMap()
+    DetectorList const & getDetectors() const { return _detectors; }
+
+    // Indices (into getDetectors()) of the detectors that might contain a FOCAL_PLANE point, in order
+    std::vector<std::size_t> const & getCandidates(lsst::geom::Point2D const & point) const {
+        if (!_bbox.contains(point)) {
+            return _unbounded;
+        }
+        return _cells[getCellY(point.getY())*_nx + getCellX(point.getX())];
+    }
+
+private:
+
+    // The FOCAL_PLANE bounding box of a detector, padded slightly; empty if it can't be computed
+    static lsst::geom::Box2D computeFootprint(Detector const & detector) {
+        lsst::geom::Box2D const bbox(detector.getBBox());
+        std::vector<lsst::geom::Point2D> edgePoints;
+        edgePoints.reserve(4*NUM_EDGE_POINTS);
+        for (int i = 0; i < NUM_EDGE_POINTS; ++i) {
+            double const x = bbox.getMinX() + bbox.getWidth()*i/NUM_EDGE_POINTS;
+            double const y = bbox.getMinY() + bbox.getHeight()*i/NUM_EDGE_POINTS;
+            double const xRev = bbox.getMaxX() - bbox.getWidth()*i/NUM_EDGE_POINTS;
+            double const yRev = bbox.getMaxY() - bbox.getHeight()*i/NUM_EDGE_POINTS;
+            edgePoints.emplace_back(x, bbox.getMinY());
+            edgePoints.emplace_back(bbox.getMaxX(), y);
+            edgePoints.emplace_back(xRev, bbox.getMaxY());
+            edgePoints.emplace_back(bbox.getMinX(), yRev);
+        }
+
+        lsst::geom::Box2D footprint;
+        for (auto const & point : detector.transform(edgePoints, PIXELS, getNativeCameraSys())) {
+            if (!std::isfinite(point.getX()) || !std::isfinite(point.getY())) {
+                return lsst::geom::Box2D();
+            }
+            footprint.include(point);
+        }
+        footprint.grow(FOOTPRINT_PADDING*std::max(footprint.getWidth(), footprint.getHeight()));
+        return footprint;
+    }
+
+    int getCellX(double x) const {
+        return std::max(0, std::min(_nx - 1, static_cast<int>((x - _bbox.getMinX())*_nx/_bbox.getWidth())));
+    }
+
+    int getCellY(double y) const {
+        return std::max(0, std::min(_ny - 1, static_cast<int>((y - _bbox.getMinY())*_ny/_bbox.getHeight())));
+    }
+
+    DetectorList _detectors;
+    lsst::geom::Box2D _bbox;                      // region covered by the grid
+    int _nx = 1;                                  // number of cells in x
+    int _ny = 1;                                  // number of cells in y
+    std::vector<std::vector<std::size_t>> _cells; // candidates for each cell; [iy*_nx + ix]
+    std::vector<std::size_t> _unbounded;          // candidates for points outside the grid
+};
+
 Camera::~Camera() noexcept = default;
 
 Camera::Builder Camera::rebuild() const {
     return Camera::Builder(*this);
 }
 
+Camera::DetectorIndex const & Camera::getDetectorIndex() const {
+    std::call_once(_detectorIndexFlag, [this]() { _detectorIndex.reset(new DetectorIndex(*this)); });
+    return *_detectorIndex;
+}
+
 Camera::DetectorList Camera::findDetectors(lsst::geom::Point2D const &point,
                                            CameraSys const &cameraSys) const {
     auto nativePoint = transform(point, cameraSys, getNativeCameraSys());
+    auto const & index = getDetectorIndex();
 
     DetectorList detectorList;
-    for (auto const &item : getIdMap()) {
-        auto detector = item.second;
+    for (auto const i : index.getCandidates(nativePoint)) {
+        auto const & detector = index.getDetectors()[i];
         auto pointPixels = detector->transform(nativePoint, getNativeCameraSys(), PIXELS);
         if (lsst::geom::Box2D(detector->getBBox()).contains(pointPixels)) {
-            detectorList.push_back(std::move(detector));
+            detectorList.push_back(detector);
         }
     }
     return detectorList;
@@ -61,14 +201,32 @@ std::vector<Camera::DetectorList> Camera::findDetectorsList(std::vector<lsst::ge
                                                             CameraSys const &cameraSys) const {
     std::vector<DetectorList> detectorListList(pointList.size());
     auto nativePointList = transform(pointList, cameraSys, getNativeCameraSys());
+    auto const & index = getDetectorIndex();
+    auto const & detectors = index.getDetectors();
+
+    // Sort the points by candidate detector, so each detector can transform its points in one call
+    std::vector<std::vector<std::size_t>> pointIndices(detectors.size());
+    for (std::size_t i = 0; i < nativePointList.size(); ++i) {
+        for (auto const j : index.getCandidates(nativePointList[i])) {
+            pointIndices[j].push_back(i);
+        }
+    }
 
-    for (auto const &item: getIdMap()) {
-        auto const &detector = item.second;
-        auto pointPixelsList = detector->transform(nativePointList, getNativeCameraSys(), PIXELS);
-        for (std::size_t i = 0; i < pointPixelsList.size(); ++i) {
-            auto const &pointPixels = pointPixelsList[i];
+    std::vector<lsst::geom::Point2D> candidatePointList;
+    for (std::size_t j = 0; j < detectors.size(); ++j) {
+        if (pointIndices[j].empty()) {
+            continue;
+        }
+        auto const &detector = detectors[j];
+        candidatePointList.clear();
+        for (auto const i : pointIndices[j]) {
+            candidatePointList.push_back(nativePointList[i]);
+        }
+        auto pointPixelsList = detector->transform(candidatePointList, getNativeCameraSys(), PIXELS);
+        for (std::size_t k = 0; k < pointPixelsList.size(); ++k) {
+            auto const &pointPixels = pointPixelsList[k];
             if (lsst::geom::Box2D(detector->getBBox()).contains(pointPixels)) {
-                detectorListList[i].push_back(detector);
+                detectorListList[pointIndices[j][k]].push_back(detector);
             }
         }
     }
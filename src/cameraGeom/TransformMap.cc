@@ -19,11 +19,14 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <unordered_set>
 
 #include "lsst/log/Log.h"
 #include "lsst/pex/exceptions.h"
+#include "lsst/geom/AffineTransform.h"
 #include "lsst/afw/table/io/InputArchive.h"
 #include "lsst/afw/table/io/OutputArchive.h"
 #include "lsst/afw/table/io/CatalogVector.h"
@@ -160,6 +163,58 @@ CameraSys getReferenceSys(std::vector<TransformMap::Connection> const & connecti
     return connections.front().fromSys;
 }
 
+// Scale of the points used to test whether a mapping is affine; comparable to the size of a detector
+// in pixels or of a focal plane in mm.
+double const AFFINE_TEST_SCALE = 1000.0;
+
+// Maximum difference between a mapping and its affine form at the test points, relative to the
+// largest transformed test point, for the mapping to be considered affine.
+double const AFFINE_TOLERANCE = 1e-12;
+
+/*
+ * Return the affine transform equivalent to a mapping, if there is one
+ *
+ * The affine transform is fit to the mapping at three points, and checked against it at several
+ * more points spread over a few times AFFINE_TEST_SCALE.
+ *
+ * @returns true, and set `affine`, if the mapping is affine to within AFFINE_TOLERANCE; false if
+ *          it isn't, or can't be evaluated at the test points
+ */
+bool findAffineForm(ast::Mapping const & mapping, lsst::geom::AffineTransform & affine) {
+    double const s = AFFINE_TEST_SCALE;
+    std::vector<lsst::geom::Point2D> const points = {
+        {0.0, 0.0}, {s, 0.0}, {0.0, s},  // used for the fit
+        {s, s}, {-s, 0.5*s}, {0.37*s, -0.81*s}, {2.3*s, 1.7*s}, {-1.9*s, -2.2*s}, {3.1*s, -2.9*s}
+    };
+    std::vector<lsst::geom::Point2D> results;
+    try {
+        results = POINT2_ENDPOINT.arrayFromData(mapping.applyForward(POINT2_ENDPOINT.dataFromArray(points)));
+    } catch (std::exception const &) {
+        // e.g. an AST error far outside the mapping's domain; just use AST
+        return false;
+    }
+
+    lsst::geom::LinearTransform::Matrix linear;
+    linear.col(0) = (results[1] - results[0]).asEigen() / s;
+    linear.col(1) = (results[2] - results[0]).asEigen() / s;
+    affine = lsst::geom::AffineTransform(lsst::geom::LinearTransform(linear),
+                                         lsst::geom::Extent2D(results[0]));
+
+    double scale = 0.0;
+    for (auto const & result : results) {
+        scale = std::max({scale, std::abs(result.getX()), std::abs(result.getY())});
+    }
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        auto const residual = affine(points[i]) - results[i];
+        // written so that NaNs fail the test
+        if (!(std::abs(residual.getX()) <= AFFINE_TOLERANCE*scale &&
+              std::abs(residual.getY()) <= AFFINE_TOLERANCE*scale)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 } // anonymous
 
 void TransformMap::Connection::reverse() {
@@ -200,24 +255,44 @@ std::shared_ptr<TransformMap const> TransformMap::make(
 // All resources owned by value or by smart pointer
 TransformMap::~TransformMap() noexcept = default;
 
+struct TransformMap::CachedMapping {
+    std::shared_ptr<ast::Mapping const> mapping;  // simplified mapping
+    bool isAffine;                                 // is `mapping` equivalent to `affine`?
+    lsst::geom::AffineTransform affine;
+};
+
 lsst::geom::Point2D TransformMap::transform(lsst::geom::Point2D const &point, CameraSys const &fromSys,
                                             CameraSys const &toSys) const {
-    auto mapping = _getMapping(fromSys, toSys);
-    return POINT2_ENDPOINT.pointFromData(mapping->applyForward(POINT2_ENDPOINT.dataFromPoint(point)));
+    auto cached = _getCachedMapping(fromSys, toSys);
+    if (cached->isAffine) {
+        return cached->affine(point);
+    }
+    return POINT2_ENDPOINT.pointFromData(
+            _copyMapping(*cached)->applyForward(POINT2_ENDPOINT.dataFromPoint(point)));
 }
 
 std::vector<lsst::geom::Point2D> TransformMap::transform(std::vector<lsst::geom::Point2D> const &pointList,
                                                          CameraSys const &fromSys,
                                                          CameraSys const &toSys) const {
-    auto mapping = _getMapping(fromSys, toSys);
-    return POINT2_ENDPOINT.arrayFromData(mapping->applyForward(POINT2_ENDPOINT.dataFromArray(pointList)));
+    auto cached = _getCachedMapping(fromSys, toSys);
+    if (cached->isAffine) {
+        std::vector<lsst::geom::Point2D> result;
+        result.reserve(pointList.size());
+        for (auto const &point : pointList) {
+            result.push_back(cached->affine(point));
+        }
+        return result;
+    }
+    return POINT2_ENDPOINT.arrayFromData(
+            _copyMapping(*cached)->applyForward(POINT2_ENDPOINT.dataFromArray(pointList)));
 }
 
 bool TransformMap::contains(CameraSys const &system) const noexcept { return _frameIds.count(system) > 0; }
 
 std::shared_ptr<geom::TransformPoint2ToPoint2> TransformMap::getTransform(CameraSys const &fromSys,
                                                                           CameraSys const &toSys) const {
-    return std::make_shared<geom::TransformPoint2ToPoint2>(*_getMapping(fromSys, toSys));
+    // The cached mapping is already simplified
+    return std::make_shared<geom::TransformPoint2ToPoint2>(*_getMapping(fromSys, toSys), false);
 }
 
 int TransformMap::_getFrame(CameraSys const &system) const {
@@ -232,7 +307,31 @@ int TransformMap::_getFrame(CameraSys const &system) const {
 
 std::shared_ptr<ast::Mapping const> TransformMap::_getMapping(CameraSys const &fromSys,
                                                               CameraSys const &toSys) const {
-    return _frameSet->getMapping(_getFrame(fromSys), _getFrame(toSys));
+    return _copyMapping(*_getCachedMapping(fromSys, toSys));
+}
+
+std::shared_ptr<TransformMap::CachedMapping const> TransformMap::_getCachedMapping(
+        CameraSys const &fromSys, CameraSys const &toSys) const {
+    auto const key = std::make_pair(_getFrame(fromSys), _getFrame(toSys));
+    // Holding the lock while we build the mapping also keeps other threads out of _frameSet
+    std::lock_guard<std::mutex> lock(_mappingCacheMutex);
+    auto iter = _mappingCache.find(key);
+    if (iter == _mappingCache.end()) {
+        auto cached = std::make_shared<CachedMapping>();
+        cached->mapping = _frameSet->getMapping(key.first, key.second)->simplified();
+        cached->isAffine = findAffineForm(*cached->mapping, cached->affine);
+        LOGLS_DEBUG(LOGGER, "Caching " << (cached->isAffine ? "affine" : "non-affine") << " mapping "
+                                       << fromSys << "->" << toSys);
+        iter = _mappingCache.emplace(key, std::move(cached)).first;
+    }
+    return iter->second;
+}
+
+std::shared_ptr<ast::Mapping const> TransformMap::_copyMapping(CachedMapping const &cached) const {
+    // The cached mapping is shared by all threads, but AST objects aren't safe to use concurrently, so
+    // callers apply their own copy.
+    std::lock_guard<std::mutex> lock(_mappingCacheMutex);
+    return cached.mapping->copy();
 }
 
 size_t TransformMap::size() const noexcept { return _frameIds.size(); }
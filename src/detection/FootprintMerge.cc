@@ -19,7 +19,12 @@
  * the GNU General Public License along with this program.  If not,
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
 
 #include "boost/bind.hpp"
 
@@ -31,6 +36,181 @@ namespace lsst {
 namespace afw {
 namespace detection {
 
+namespace {
+
+// Size (in pixels) of the cells of a MergeGrid.
+int const MERGE_GRID_CELL_SIZE = 64;
+
+// A uniform grid over the bounding boxes of the entries in a list of FootprintMerges, used to find the
+// merges a new Footprint might overlap without testing all of them.  Each cell lists the positions
+// (in the list) of the merges whose bounding boxes, grown by one pixel to allow for touching, overlap
+// the cell.
+class MergeGrid {
+public:
+    // Add the merge at the given position, with the given (ungrown) bounding box.
+    void insert(std::size_t position, lsst::geom::Box2I const &bbox) {
+        if (position >= _boxes.size()) {
+            _boxes.resize(position + 1);
+        }
+        _boxes[position] = bbox;
+        _boxes[position].grow(lsst::geom::Extent2I(1, 1));
+        _forEachCell(_boxes[position], [this, position](std::int64_t cell) {
+            _cells[cell].push_back(position);
+        });
+    }
+
+    // Remove the merge at the given position.
+    void erase(std::size_t position) {
+        _forEachCell(_boxes[position], [this, position](std::int64_t cell) {
+            std::vector<std::size_t> &positions = _cells[cell];
+            positions.erase(std::find(positions.begin(), positions.end(), position));
+        });
+        _boxes[position] = lsst::geom::Box2I();
+    }
+
+    // Update the bounding box of the merge at the given position.
+    void update(std::size_t position, lsst::geom::Box2I const &bbox) {
+        lsst::geom::Box2I grown(bbox);
+        grown.grow(lsst::geom::Extent2I(1, 1));
+        if (grown != _boxes[position]) {
+            erase(position);
+            insert(position, bbox);
+        }
+    }
+
+    // Return, in increasing order, the positions of all merges whose grown bounding boxes overlap the
+    // cells touched by the given box (a superset of those that overlap the box itself).
+    std::vector<std::size_t> query(lsst::geom::Box2I const &bbox) const {
+        std::vector<std::size_t> result;
+        _forEachCell(bbox, [this, &result](std::int64_t cell) {
+            auto iter = _cells.find(cell);
+            if (iter != _cells.end()) {
+                result.insert(result.end(), iter->second.begin(), iter->second.end());
+            }
+        });
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+private:
+    static int _getCell(int coordinate) {
+        // floor division, so negative coordinates get their own cells
+        return coordinate >= 0 ? coordinate / MERGE_GRID_CELL_SIZE
+                               : -((-coordinate - 1) / MERGE_GRID_CELL_SIZE) - 1;
+    }
+
+    template <typename Function>
+    static void _forEachCell(lsst::geom::Box2I const &bbox, Function function) {
+        if (bbox.isEmpty()) {
+            return;
+        }
+        for (int y = _getCell(bbox.getMinY()); y <= _getCell(bbox.getMaxY()); ++y) {
+            for (int x = _getCell(bbox.getMinX()); x <= _getCell(bbox.getMaxX()); ++x) {
+                function((static_cast<std::int64_t>(x) << 32) | static_cast<std::uint32_t>(y));
+            }
+        }
+    }
+
+    std::vector<lsst::geom::Box2I> _boxes;
+    std::unordered_map<std::int64_t, std::vector<std::size_t>> _cells;
+};
+
+// A grid of buckets over the (integer) positions of a catalog of peaks, used to find the nearest peak to
+// a point without testing all of them.  The cell size is chosen to put about one peak in each cell.
+class PeakGrid {
+public:
+    explicit PeakGrid(PeakCatalog const &peaks) : _cellSize(1), _nx(0), _ny(0) {
+        if (peaks.empty()) {
+            return;
+        }
+        lsst::geom::Box2I bbox;
+        _points.reserve(peaks.size());
+        for (auto const &peak : peaks) {
+            _points.push_back(peak.getI());
+            bbox.include(_points.back());
+        }
+        _min = bbox.getMin();
+        double const area = static_cast<double>(bbox.getWidth()) * bbox.getHeight();
+        _cellSize = std::max(1, static_cast<int>(std::ceil(std::sqrt(area / _points.size()))));
+        _nx = (bbox.getWidth() + _cellSize - 1) / _cellSize;
+        _ny = (bbox.getHeight() + _cellSize - 1) / _cellSize;
+        // Sort the peak positions into cells (counting sort, so each cell's peaks stay in catalog order)
+        _cellStarts.assign(_nx * _ny + 1, 0);
+        for (auto const &point : _points) {
+            ++_cellStarts[_getCell(point) + 1];
+        }
+        std::partial_sum(_cellStarts.begin(), _cellStarts.end(), _cellStarts.begin());
+        _cellPeaks.resize(_points.size());
+        std::vector<int> next(_cellStarts.begin(), _cellStarts.end() - 1);
+        for (std::size_t i = 0; i < _points.size(); ++i) {
+            _cellPeaks[next[_getCell(_points[i])]++] = i;
+        }
+    }
+
+    /*
+     *  Return the position in the catalog of the peak nearest to the given point, setting minDist2 to its
+     *  squared distance, or return -1 if there are no peaks.
+     *
+     *  Ties go to the peak that comes first in the catalog, as in a linear search.
+     */
+    int findNearest(lsst::geom::Point2I const &point, float &minDist2) const {
+        int nearest = -1;
+        if (_points.empty()) {
+            return nearest;
+        }
+        int const cx = _clamp((point.getX() - _min.getX()) / _cellSize, point.getX() < _min.getX(), _nx);
+        int const cy = _clamp((point.getY() - _min.getY()) / _cellSize, point.getY() < _min.getY(), _ny);
+        int const maxRing = std::max(std::max(cx, _nx - 1 - cx), std::max(cy, _ny - 1 - cy));
+        for (int ring = 0; ring <= maxRing; ++ring) {
+            if (nearest >= 0) {
+                // Peaks in this ring of cells and beyond are at least this far away in x or y.
+                float const bound = static_cast<float>(ring - 1) * _cellSize + 1;
+                if (bound * bound > minDist2) {
+                    break;
+                }
+            }
+            for (int iy = std::max(cy - ring, 0); iy <= std::min(cy + ring, _ny - 1); ++iy) {
+                bool const isEdgeRow = (iy == cy - ring || iy == cy + ring);
+                int const step = isEdgeRow ? 1 : 2 * ring;
+                for (int ix = cx - ring; ix <= cx + ring; ix += step) {
+                    if (ix < 0 || ix >= _nx) {
+                        continue;
+                    }
+                    int const cell = iy * _nx + ix;
+                    for (int k = _cellStarts[cell]; k < _cellStarts[cell + 1]; ++k) {
+                        int const i = _cellPeaks[k];
+                        float const dist2 = point.distanceSquared(_points[i]);
+                        if (dist2 < minDist2 || (dist2 == minDist2 && i < nearest)) {
+                            minDist2 = dist2;
+                            nearest = i;
+                        }
+                    }
+                }
+            }
+        }
+        return nearest;
+    }
+
+private:
+    // Clamp a cell index computed by truncating division to [0, n).
+    static int _clamp(int index, bool isBelow, int n) { return isBelow ? 0 : std::min(index, n - 1); }
+
+    int _getCell(lsst::geom::Point2I const &point) const {
+        return ((point.getY() - _min.getY()) / _cellSize) * _nx + (point.getX() - _min.getX()) / _cellSize;
+    }
+
+    std::vector<lsst::geom::Point2I> _points;
+    lsst::geom::Point2I _min;
+    int _cellSize;
+    int _nx;
+    int _ny;
+    std::vector<int> _cellStarts;  // index into _cellPeaks of the first peak in each cell
+    std::vector<int> _cellPeaks;   // catalog positions of the peaks, sorted by cell
+};
+
+}  // namespace
+
 class FootprintMerge {
 public:
     typedef FootprintMergeList::KeyTuple KeyTuple;
@@ -154,6 +334,7 @@ private:
         assert(peakSchemaMapper || filterMap);
 
         PeakCatalog &currentPeaks = getMergedFootprint()->getPeaks();
+        PeakGrid const currentGrid(currentPeaks);
         std::shared_ptr<PeakRecord> nearestPeak;
         // Create new list of peaks
         PeakCatalog newPeaks(currentPeaks.getTable());
@@ -162,15 +343,9 @@ private:
         for (PeakCatalog::const_iterator otherIter = otherPeaks.begin(); otherIter != otherPeaks.end();
              ++otherIter) {
             float minDist2 = std::numeric_limits<float>::infinity();
-
-            for (PeakCatalog::const_iterator currentIter = currentPeaks.begin();
-                 currentIter != currentPeaks.end(); ++currentIter) {
-                float dist2 = otherIter->getI().distanceSquared(currentIter->getI());
-
-                if (dist2 < minDist2) {
-                    minDist2 = dist2;
-                    nearestPeak = currentIter;
-                }
+            int const nearest = currentGrid.findNearest(otherIter->getI(), minDist2);
+            if (nearest >= 0) {
+                nearestPeak = currentPeaks.get(nearest);
             }
 
             if (minDist2 < maxSamePeakDist2 && nearestPeak && maxSamePeakDist > 0) {
@@ -250,6 +425,15 @@ void FootprintMergeList::addCatalog(std::shared_ptr<afw::table::SourceTable> sou
     // If list is empty or merging not requested, don't check for any matches, just add all the objects
     bool checkForMatches = !_mergeList.empty() && doMerge;
 
+    // Index the merges, so we only test each Footprint against those near it.  Merges that are absorbed
+    // into others are reset to null and removed at the end, so positions in the list don't change.
+    MergeGrid grid;
+    if (checkForMatches) {
+        for (std::size_t position = 0; position < _mergeList.size(); ++position) {
+            grid.insert(position, _mergeList[position]->getBBox());
+        }
+    }
+
     for (afw::table::SourceCatalog::const_iterator srcIter = inputCat.begin(); srcIter != inputCat.end();
          ++srcIter) {
         // Only consider unblended objects
@@ -260,16 +444,19 @@ void FootprintMergeList::addCatalog(std::shared_ptr<afw::table::SourceTable> sou
         // Empty pointer to account for the first match in the catalog.  If there is more than one
         // match, subsequent matches will be merged with this one
         std::shared_ptr<FootprintMerge> first = std::shared_ptr<FootprintMerge>();
+        std::size_t firstPosition = 0;
 
         if (checkForMatches) {
-            FootprintMergeVec::iterator iter = _mergeList.begin();
-            while (iter != _mergeList.end()) {
+            // Candidates are visited in list order, so the merge is the same as testing every entry.
+            for (std::size_t position : grid.query(foot->getBBox())) {
+                std::shared_ptr<FootprintMerge> &merge = _mergeList[position];
                 // Grow by one pixel to allow for touching
-                lsst::geom::Box2I box((**iter).getBBox());
+                lsst::geom::Box2I box(merge->getBBox());
                 box.grow(lsst::geom::Extent2I(1, 1));
-                if (box.overlaps(foot->getBBox()) && (**iter).overlaps(*foot)) {
+                if (box.overlaps(foot->getBBox()) && merge->overlaps(*foot)) {
                     if (!first) {
-                        first = *iter;
+                        first = merge;
+                        firstPosition = position;
                         // Spatially extend existing FootprintMerge in order to connect subsequent,
                         // now-overlapping FootprintMerges. If a subsequent FootprintMerge overlaps with
                         // the new footprint, it's now guaranteed to overlap with this first FootprintMerge.
@@ -278,24 +465,28 @@ void FootprintMergeList::addCatalog(std::shared_ptr<afw::table::SourceTable> sou
                         first->addSpans(foot);
                     } else {
                         // Add existing merged Footprint to first
-                        first->add(**iter, _filterMap, minNewPeakDist, maxSamePeakDist);
-                        iter = _mergeList.erase(iter);
-                        continue;
+                        first->add(*merge, _filterMap, minNewPeakDist, maxSamePeakDist);
+                        grid.erase(position);
+                        merge.reset();
                     }
                 }
-                ++iter;
-            } // while mergeList
+            } // for candidates
         } //     if checkForMatches
 
         if (first) {
             // Now merge footprint including peaks into the newly-connected, higher-priority FootprintMerge
             first->add(foot, _peakSchemaMapper, keyIter->second, minNewPeakDist, maxSamePeakDist);
+            grid.update(firstPosition, first->getBBox());
         } else {
            // Footprint did not overlap with any existing FootprintMerges. Add to MergeList
             _mergeList.push_back(std::make_shared<FootprintMerge>(foot, sourceTable, _peakTable,
                                                                   _peakSchemaMapper, keyIter->second));
+            if (checkForMatches) {
+                grid.insert(_mergeList.size() - 1, _mergeList.back()->getBBox());
+            }
         }
     }
+    _mergeList.erase(std::remove(_mergeList.begin(), _mergeList.end(), nullptr), _mergeList.end());
 }
 
 void FootprintMergeList::getFinalSources(afw::table::SourceCatalog &outputCat) {
@@ -1165,6 +1165,32 @@ std::size_t Fits::countRows() {
     return r;
 }
 
+std::size_t Fits::getTableRowBytes() {
+    long naxis1 = 0;
+    fits_read_key_lng(reinterpret_cast<fitsfile *>(fptr), "NAXIS1", &naxis1, nullptr, &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, "Reading the width of table rows");
+    }
+    return naxis1;
+}
+
+void Fits::writeTableBytes(std::size_t firstRow, std::size_t nBytes, unsigned char const *data) {
+    fits_write_tblbytes(reinterpret_cast<fitsfile *>(fptr), firstRow + 1, 1, nBytes,
+                        const_cast<unsigned char *>(data), &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, boost::format("Writing %d bytes of table rows starting at row %d") %
+                                              nBytes % firstRow);
+    }
+}
+
+void Fits::readTableBytes(std::size_t firstRow, std::size_t nBytes, unsigned char *data) {
+    fits_read_tblbytes(reinterpret_cast<fitsfile *>(fptr), firstRow + 1, 1, nBytes, data, &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, boost::format("Reading %d bytes of table rows starting at row %d") %
+                                              nBytes % firstRow);
+    }
+}
+
 template <typename T>
 void Fits::writeTableArray(std::size_t row, int col, int nElements, T const *value) {
     fits_write_col(reinterpret_cast<fitsfile *>(fptr), FitsTableType<T>::CONSTANT, col + 1, row + 1, 1,
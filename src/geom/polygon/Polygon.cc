@@ -119,26 +119,168 @@ void addSubSampledEdge(std::vector<LsstPoint>& vertices,  // Vector of points to
     }
 }
 
-/// @internal Calculate area of overlap between polygon and pixel
-double pixelOverlap(BoostPolygon const& poly, int const x, int const y) {
-    std::vector<BoostPolygon> overlap;  // Overlap between pixel and polygon
-    LsstBox const pixel(lsst::geom::Point2D(x - 0.5, y - 0.5), lsst::geom::Point2D(x + 0.5, y + 0.5));
-    boost::geometry::intersection(poly, pixel, overlap);
-    double area = 0.0;
-    for (std::vector<BoostPolygon>::const_iterator i = overlap.begin(); i != overlap.end(); ++i) {
-        double const polyArea = boost::geometry::area(*i);
-        area += std::min(polyArea, 1.0);  // remove any rounding error
+/// @internal Coverage below which a pixel is considered to be outside a polygon (i.e., rounding error)
+double const COVERAGE_TOLERANCE = 1.0e-10;
+
+/**
+ * @internal Add the part of a polygon edge lying within a single row of pixels to the row's accumulator
+ *
+ * The edge runs from (x0, y0) to (x1, y1) and has already been clipped to the row.  It is split at the
+ * pixel boundaries; each piece adds to acc[c - xLo] the (trapezoidal) area between it and the right-hand
+ * side of its pixel c, and the rest of its height to acc[c - xLo + 1], so that the prefix sums of acc are
+ * the (signed) areas of the pixels to the right of the edge.  Pieces to the left of column xLo cover all
+ * the pixels, and pieces to the right of column xHi none of them.
+ */
+void addEdgeToRow(double x0, double y0, double x1, double y1, int const xLo, int const xHi,
+                  std::vector<double>& acc) {
+    if (y0 == y1) {
+        return;
+    }
+    double sign = 1.0;  // walk from left to right, remembering the direction of the edge
+    if (x0 > x1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+        sign = -1.0;
+    }
+    double const slope = (x1 > x0) ? (y1 - y0) / (x1 - x0) : 0.0;
+    double const left = xLo - 0.5, right = xHi + 0.5;
+    double xl = x0, yl = y0;
+    if (xl < left) {
+        double const xr = std::min(x1, left);
+        double const yr = (xr == x1) ? y1 : y0 + (xr - x0) * slope;
+        acc[0] += sign * (yr - yl);
+        if (xr == x1) {
+            return;
+        }
+        xl = xr;
+        yl = yr;
+    }
+    while (xl < right) {
+        int const c = std::floor(xl + 0.5);  // the pixel containing xl
+        double const xr = std::min(x1, c + 0.5);
+        double const yr = (xr == x1) ? y1 : y0 + (xr - x0) * slope;
+        double const dy = sign * (yr - yl);
+        double const area = dy * (c + 0.5 - 0.5 * (xl + xr));
+        acc[c - xLo] += area;
+        acc[c - xLo + 1] += dy - area;
+        if (xr == x1) {
+            break;
+        }
+        xl = xr;
+        yl = yr;
     }
-    return area;
 }
 
-/// @internal Set each pixel in a row to the amount of overlap with polygon
-void pixelRowOverlap(std::shared_ptr<lsst::afw::image::Image<float>> const image, BoostPolygon const& poly,
-                     int const xStart, int const xStop, int const y) {
-    int x = xStart;
-    for (lsst::afw::image::Image<float>::x_iterator i = image->x_at(x - image->getX0(), y - image->getY0());
-         x <= xStop; ++i, ++x) {
-        *i = pixelOverlap(poly, x, y);
+/**
+ * @internal Call function(x, y, coverage) for each pixel in bbox that overlaps a polygon
+ *
+ * The coverage is the exact fraction of the pixel lying within the polygon, excluding any holes (inner
+ * rings).  It is integrated analytically a row at a time: an edge table gives the edges of all the rings
+ * crossing each row, which are clipped to the row and passed to addEdgeToRow, and the prefix sums of
+ * the row's accumulator are the coverages of its pixels.  The inner rings wind the opposite way to the
+ * outer ring, so their edges subtract the holes' areas.  The cost is thus proportional to the
+ * perimeter plus the area of the polygon.
+ */
+template <typename Function>
+void rasterizePolygon(BoostPolygon const& poly, lsst::geom::Box2I const& bbox, Function const& function) {
+    LsstRing const& outer = poly.outer();
+    if (outer.size() < 4) {
+        return;  // a closed ring with fewer than three vertices has no area
+    }
+
+    // The edges of all the rings, as pointers to their (first) vertices
+    std::vector<LsstPoint const*> edges;
+    auto addRing = [&edges](LsstRing const& ring) {
+        for (std::size_t i = 0; i + 1 < ring.size(); ++i) {
+            edges.push_back(&ring[i]);
+        }
+    };
+    addRing(outer);
+    for (LsstRing const& inner : poly.inners()) {
+        addRing(inner);
+    }
+    std::size_t const nEdges = edges.size();
+
+    // The holes lie within the outer ring, so it gives the extent and the orientation
+    double xMin = outer[0].getX(), xMax = xMin, yMin = outer[0].getY(), yMax = yMin;
+    double area2 = 0.0;  // twice the signed area of the outer ring
+    for (std::size_t i = 0; i + 1 < outer.size(); ++i) {
+        LsstPoint const& p0 = outer[i];
+        LsstPoint const& p1 = outer[i + 1];
+        xMin = std::min(xMin, p1.getX());
+        xMax = std::max(xMax, p1.getX());
+        yMin = std::min(yMin, p1.getY());
+        yMax = std::max(yMax, p1.getY());
+        area2 += p0.getX() * p1.getY() - p1.getX() * p0.getY();
+    }
+    // Counter-clockwise rings have positive area, but their edges' areas accumulate negative coverage
+    double const orientation = (area2 > 0) ? -1.0 : 1.0;
+
+    int const xLo = std::max(static_cast<int>(std::floor(xMin + 0.5)), bbox.getMinX());
+    int const xHi = std::min(static_cast<int>(std::floor(xMax + 0.5)), bbox.getMaxX());
+    int const yLo = std::max(static_cast<int>(std::floor(yMin + 0.5)), bbox.getMinY());
+    int const yHi = std::min(static_cast<int>(std::floor(yMax + 0.5)), bbox.getMaxY());
+    if (area2 == 0.0 || xLo > xHi || yLo > yHi) {
+        return;
+    }
+
+    // Edge table: the edges that start crossing each row, and the last row each edge crosses
+    std::vector<std::vector<std::size_t>> startingEdges(yHi - yLo + 1);
+    std::vector<int> lastRow(nEdges);
+    for (std::size_t i = 0; i < nEdges; ++i) {
+        double const y0 = edges[i][0].getY(), y1 = edges[i][1].getY();
+        if (y0 == y1) {
+            continue;  // horizontal edges don't contribute
+        }
+        int const first = std::max(static_cast<int>(std::floor(std::min(y0, y1) + 0.5)), yLo);
+        lastRow[i] = std::min(static_cast<int>(std::floor(std::max(y0, y1) + 0.5)), yHi);
+        if (first <= lastRow[i]) {
+            startingEdges[first - yLo].push_back(i);
+        }
+    }
+
+    std::vector<std::size_t> active;  // edges crossing the current row
+    std::vector<double> acc(xHi - xLo + 2);
+    for (int y = yLo; y <= yHi; ++y) {
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [&lastRow, y](std::size_t i) { return lastRow[i] < y; }),
+                     active.end());
+        active.insert(active.end(), startingEdges[y - yLo].begin(), startingEdges[y - yLo].end());
+        if (active.empty()) {
+            continue;
+        }
+
+        std::fill(acc.begin(), acc.end(), 0.0);
+        double const rowMin = y - 0.5, rowMax = y + 0.5;
+        for (std::size_t i : active) {
+            LsstPoint const& p0 = edges[i][0];
+            LsstPoint const& p1 = edges[i][1];
+            double const yBottom = std::max(std::min(p0.getY(), p1.getY()), rowMin);
+            double const yTop = std::min(std::max(p0.getY(), p1.getY()), rowMax);
+            if (yBottom >= yTop) {
+                continue;
+            }
+            double const dxdy = (p1.getX() - p0.getX()) / (p1.getY() - p0.getY());
+            auto xAt = [&p0, &p1, dxdy](double yy) {  // use the vertices themselves where we can
+                if (yy == p0.getY()) return p0.getX();
+                if (yy == p1.getY()) return p1.getX();
+                return p0.getX() + (yy - p0.getY()) * dxdy;
+            };
+            if (p1.getY() > p0.getY()) {
+                addEdgeToRow(xAt(yBottom), yBottom, xAt(yTop), yTop, xLo, xHi, acc);
+            } else {
+                addEdgeToRow(xAt(yTop), yTop, xAt(yBottom), yBottom, xLo, xHi, acc);
+            }
+        }
+
+        double coverage = 0.0;
+        for (int x = xLo; x <= xHi; ++x) {
+            coverage += acc[x - xLo];
+            double const value = orientation * coverage;
+            if (value > COVERAGE_TOLERANCE) {
+                function(x, y, std::min(value, 1.0));  // remove any rounding error
+            }
+        }
     }
 }
 
@@ -445,77 +587,40 @@ std::shared_ptr<afw::image::Image<float>> Polygon::createImage(lsst::geom::Box2I
     std::shared_ptr<Image> image = std::make_shared<Image>(bbox);
     image->setXY0(bbox.getMin());
     *image = 0.0;
-    lsst::geom::Box2D bounds = getBBox();  // Polygon bounds
-    int xMin = std::max(static_cast<int>(bounds.getMinX()), bbox.getMinX());
-    int xMax = std::min(static_cast<int>(::ceil(bounds.getMaxX())), bbox.getMaxX());
-    int yMin = std::max(static_cast<int>(bounds.getMinY()), bbox.getMinY());
-    int yMax = std::min(static_cast<int>(::ceil(bounds.getMaxY())), bbox.getMaxY());
-    for (int y = yMin; y <= yMax; ++y) {
-        double const yPixelMin = (double)y - 0.5, yPixelMax = (double)y + 0.5;
-        BoostPolygon row;  // A polygon of row y
-        boost::geometry::assign(
-                row, LsstBox(lsst::geom::Point2D(xMin, yPixelMin), lsst::geom::Point2D(xMax, yPixelMax)));
-        std::vector<BoostPolygon> intersections;
-        boost::geometry::intersection(_impl->poly, row, intersections);
-
-        if (intersections.size() == 1 && boost::geometry::num_points(intersections[0]) == 5) {
-            // This row is fairly tame, and should have a long run of pixels within the polygon
-            BoostPolygon const& row = intersections[0];
-            std::vector<double> top, bottom;
-            top.reserve(2);
-            bottom.reserve(2);
-            bool failed = false;
-            for (std::vector<Point>::const_iterator i = row.outer().begin(); i != row.outer().end() - 1;
-                 ++i) {
-                double const xCoord = i->getX(), yCoord = i->getY();
-                if (yCoord == yPixelMin) {
-                    bottom.push_back(xCoord);
-                } else if (yCoord == yPixelMax) {
-                    top.push_back(xCoord);
-                } else {
-                    failed = true;
-                    break;
-                }
-            }
-            if (!failed && top.size() == 2 && bottom.size() == 2) {
-                std::sort(top.begin(), top.end());
-                std::sort(bottom.begin(), bottom.end());
-                int const xMin = std::min(top[0], bottom[0]);
-                int const xStart = ::ceil(std::max(top[0], bottom[0])) + 1;
-                int const xStop = std::min(top[1], bottom[1]) - 1;
-                int const xMax = ::ceil(std::max(top[1], bottom[1]));
-                pixelRowOverlap(image, _impl->poly, std::max(xMin, bbox.getMinX()),
-                                std::min(xStart, bbox.getMaxX()), y);
-                int x = xStart;
-                for (Image::x_iterator i = image->x_at(std::max(xStart, bbox.getMinX()) - image->getX0(),
-                                                       y - image->getY0());
-                     x <= std::min(xStop, bbox.getMaxX()); ++i, ++x) {
-                    *i = 1.0;
-                }
-                pixelRowOverlap(image, _impl->poly, std::max(xStop, bbox.getMinX()),
-                                std::min(xMax, bbox.getMaxX()), y);
-                continue;
-            }
-        }
-
-        // Last resort: do each pixel independently...
-        for (std::vector<BoostPolygon>::const_iterator p = intersections.begin(); p != intersections.end();
-             ++p) {
-            double xMinRow = xMax, xMaxRow = xMin;
-            std::vector<LsstPoint> const vertices = p->outer();
-            for (std::vector<LsstPoint>::const_iterator q = vertices.begin(); q != vertices.end(); ++q) {
-                double const x = q->getX();
-                if (x < xMinRow) xMinRow = x;
-                if (x > xMaxRow) xMaxRow = x;
-            }
+    rasterizePolygon(_impl->poly, bbox, [&image, &bbox](int x, int y, double coverage) {
+        *image->x_at(x - bbox.getMinX(), y - bbox.getMinY()) = coverage;
+    });
+    return image;
+}
 
-            pixelRowOverlap(image, _impl->poly, std::max(static_cast<int>(xMinRow), bbox.getMinX()),
-                            std::min(static_cast<int>(::ceil(xMaxRow)), bbox.getMaxX()), y);
-        }
+std::shared_ptr<afw::image::Image<float>> Polygon::createCoverageImage(
+        std::vector<std::shared_ptr<Polygon>> const& polygons, lsst::geom::Box2I const& bbox) {
+    typedef afw::image::Image<float> Image;
+    std::shared_ptr<Image> image = std::make_shared<Image>(bbox);
+    image->setXY0(bbox.getMin());
+    *image = 0.0;
+    for (auto const& polygon : polygons) {
+        rasterizePolygon(polygon->_impl->poly, bbox, [&image, &bbox](int x, int y, double coverage) {
+            *image->x_at(x - bbox.getMinX(), y - bbox.getMinY()) += coverage;
+        });
     }
     return image;
 }
 
+void Polygon::setCoverageMask(std::vector<std::shared_ptr<Polygon>> const& polygons,
+                              afw::image::Mask<afw::image::MaskPixel>& mask, afw::image::MaskPixel bitmask,
+                              double minCoverage) {
+    lsst::geom::Box2I const bbox = mask.getBBox(afw::image::PARENT);
+    for (auto const& polygon : polygons) {
+        rasterizePolygon(polygon->_impl->poly, bbox,
+                         [&mask, &bbox, bitmask, minCoverage](int x, int y, double coverage) {
+                             if (coverage >= minCoverage) {
+                                 *mask.x_at(x - bbox.getMinX(), y - bbox.getMinY()) |= bitmask;
+                             }
+                         });
+    }
+}
+
 // -------------- Table-based Persistence -------------------------------------------------------------------
 
 /*
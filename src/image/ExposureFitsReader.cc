@@ -243,8 +243,10 @@ private:
             return false;
         }
         if (_state == ArchiveState::PRESENT) {
+            // Read just the index now, and only the data HDUs needed by the components we're asked
+            // for later; fitsFile belongs to the ExposureFitsReader that owns us, so it outlives _archive.
             afw::fits::HduMoveGuard guard(*fitsFile, _hdu);
-            _archive = table::io::InputArchive::readFits(*fitsFile);
+            _archive = table::io::InputArchive::readFits(*fitsFile, /* lazy= */ true);
             _state = ArchiveState::LOADED;
         }
         assert(_state == ArchiveState::LOADED);  // constructor body should guarantee it's not UNKNOWN
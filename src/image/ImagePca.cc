@@ -29,6 +29,7 @@
 #include <cmath>
 #include <cstdint>
 #include <memory>
+#include <type_traits>
 
 #include "Eigen/Core"
 #include "Eigen/SVD"
@@ -36,6 +37,7 @@
 
 #include "lsst/afw/image/ImagePca.h"
 #include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace afwMath = lsst::afw::math;
 
@@ -50,7 +52,8 @@ ImagePca<ImageT>::ImagePca(bool constantWeight)
           _dimensions(0, 0),
           _constantWeight(constantWeight),
           _eigenValues(std::vector<double>()),
-          _eigenImages(ImageList()) {}
+          _eigenImages(ImageList()),
+          _numThreads(1) {}
 
 template <typename ImageT>
 ImagePca<ImageT>::ImagePca(ImagePca const&) = default;
@@ -118,6 +121,203 @@ struct SortEvalueDecreasing
         return a.first > b.first;  // N.b. sort on greater
     }
 };
+
+// Number of pixels in each block of the matrices of packed pixels used by ImagePca::analyze
+int const PCA_BLOCK_PIXELS = 4096;
+
+/*
+ * Copy pixels [begin, end) (counting along the rows) of each image into a column of packed,
+ * replacing non-finite values by zero if zeroNonFinite (which is how innerProduct ignores them)
+ */
+template <typename ImageT>
+void packPixels(std::vector<ImageT const*> const& images, int begin, int end, bool zeroNonFinite,
+                Eigen::MatrixXd& packed) {
+    packed.resize(end - begin, images.size());
+    for (std::size_t j = 0; j != images.size(); ++j) {
+        int const width = images[j]->getWidth();
+        double* out = packed.col(j).data();
+        for (int p = begin; p < end;) {
+            int const y = p / width;
+            int const x = p - y * width;
+            int const n = std::min(width - x, end - p);
+            typename ImageT::const_x_iterator ptr = images[j]->row_begin(y) + x;
+            for (int k = 0; k != n; ++k, ++ptr, ++out) {
+                double const value = *ptr;
+                *out = (zeroNonFinite && !std::isfinite(value)) ? 0.0 : value;
+            }
+            p += n;
+        }
+    }
+}
+
+/*
+ * Return the matrix of inner products of the images (as given by innerProduct).
+ *
+ * The pixels are split into as many bands as threads; each thread accumulates the inner products of
+ * its band with rank updates from blocks of packed pixels, and the bands' sums are added in order.
+ * If there are fewer blocks than threads (e.g. for small stamps) the blocks are processed in turn
+ * instead, with the threads sharing out tiles of the lower triangle of the matrix.
+ */
+template <typename ImageT>
+Eigen::MatrixXd computeInnerProducts(std::vector<ImageT const*> const& images, int nThreads) {
+    int const nImage = images.size();
+    int const nPixel = images[0]->getWidth() * images[0]->getHeight();
+    int const nBlock = (nPixel + PCA_BLOCK_PIXELS - 1) / PCA_BLOCK_PIXELS;
+    nThreads = afwMath::detail::getNumThreads(nThreads);
+
+    if (nBlock < nThreads && nImage > 1) {
+        // Tile t holds images [tileStart[t], tileStart[t + 1]); each pair of tiles (i, j <= i) fills a
+        // different part of the lower triangle, so the pairs can be computed in parallel.
+        int const nTile = std::min(nImage, nThreads);
+        std::vector<int> tileStart(nTile + 1);
+        for (int t = 0; t <= nTile; ++t) {
+            tileStart[t] = static_cast<long>(nImage) * t / nTile;
+        }
+        std::vector<std::pair<int, int>> tilePairs;
+        for (int i = 0; i != nTile; ++i) {
+            for (int j = 0; j <= i; ++j) {
+                tilePairs.emplace_back(i, j);
+            }
+        }
+        int const nPair = tilePairs.size();
+
+        Eigen::MatrixXd sums = Eigen::MatrixXd::Zero(nImage, nImage);
+        Eigen::MatrixXd packed;
+        for (int block = 0; block != nBlock; ++block) {
+            int const begin = block * PCA_BLOCK_PIXELS;
+            packPixels(images, begin, std::min(begin + PCA_BLOCK_PIXELS, nPixel), true, packed);
+            afwMath::detail::parallelFor(0, nPair, nThreads, [&](int pairBegin, int pairEnd) {
+                for (int p = pairBegin; p != pairEnd; ++p) {
+                    int const i = tilePairs[p].first;
+                    int const j = tilePairs[p].second;
+                    int const iStart = tileStart[i], iSize = tileStart[i + 1] - iStart;
+                    int const jStart = tileStart[j], jSize = tileStart[j + 1] - jStart;
+                    if (i == j) {
+                        sums.block(iStart, iStart, iSize, iSize)
+                                .selfadjointView<Eigen::Lower>()
+                                .rankUpdate(packed.middleCols(iStart, iSize).transpose());
+                    } else {
+                        sums.block(iStart, jStart, iSize, jSize).noalias() +=
+                                packed.middleCols(iStart, iSize).transpose() *
+                                packed.middleCols(jStart, jSize);
+                    }
+                }
+            });
+        }
+
+        Eigen::MatrixXd R = sums.selfadjointView<Eigen::Lower>();
+        return R;
+    }
+
+    int const nBand = std::min(nThreads, std::max(1, nBlock));
+    std::vector<Eigen::MatrixXd> bandSums(nBand, Eigen::MatrixXd::Zero(nImage, nImage));
+    afwMath::detail::parallelFor(0, nBand, nBand, [&](int bandBegin, int bandEnd) {
+        Eigen::MatrixXd packed;
+        for (int band = bandBegin; band != bandEnd; ++band) {
+            int const blockBegin = static_cast<long>(nBlock) * band / nBand;
+            int const blockEnd = static_cast<long>(nBlock) * (band + 1) / nBand;
+            for (int block = blockBegin; block != blockEnd; ++block) {
+                int const begin = block * PCA_BLOCK_PIXELS;
+                packPixels(images, begin, std::min(begin + PCA_BLOCK_PIXELS, nPixel), true, packed);
+                bandSums[band].selfadjointView<Eigen::Lower>().rankUpdate(packed.transpose());
+            }
+        }
+    });
+    for (int band = 1; band < nBand; ++band) {
+        bandSums[0] += bandSums[band];
+    }
+
+    Eigen::MatrixXd R = bandSums[0].selfadjointView<Eigen::Lower>();
+    return R;
+}
+
+/*
+ * Set each output image to a linear combination of the input images, out[i] = sum_j weights(j, i) in[j],
+ * computing blocks of pixels as matrix products.  As with scaledPlus, a non-finite input pixel makes
+ * the output pixel non-finite.  If there are fewer blocks than threads, the output images of each block
+ * are also split into tiles so that all the threads have work.
+ */
+template <typename ImageT>
+void combineImages(std::vector<ImageT const*> const& in, Eigen::MatrixXd const& weights,
+                   std::vector<ImageT*> const& out, int nThreads) {
+    int const nOut = out.size();
+    int const width = out[0]->getWidth();
+    int const nPixel = width * out[0]->getHeight();
+    int const nBlock = (nPixel + PCA_BLOCK_PIXELS - 1) / PCA_BLOCK_PIXELS;
+    nThreads = afwMath::detail::getNumThreads(nThreads);
+    int const nTile = nBlock < nThreads ? std::min(nOut, (nThreads + nBlock - 1) / nBlock) : 1;
+
+    afwMath::detail::parallelFor(0, nBlock * nTile, nThreads, [&](int taskBegin, int taskEnd) {
+        Eigen::MatrixXd packed;
+        Eigen::MatrixXd combined;
+        int packedBlock = -1;
+        for (int task = taskBegin; task != taskEnd; ++task) {
+            int const block = task / nTile;
+            int const tile = task % nTile;
+            int const begin = block * PCA_BLOCK_PIXELS;
+            int const end = std::min(begin + PCA_BLOCK_PIXELS, nPixel);
+            if (block != packedBlock) {
+                packPixels(in, begin, end, false, packed);
+                packedBlock = block;
+            }
+            int const outBegin = static_cast<long>(nOut) * tile / nTile;
+            int const outEnd = static_cast<long>(nOut) * (tile + 1) / nTile;
+            combined.noalias() = packed * weights.middleCols(outBegin, outEnd - outBegin);
+
+            for (int i = outBegin; i != outEnd; ++i) {
+                double const* value = combined.col(i - outBegin).data();
+                for (int p = begin; p < end;) {
+                    int const y = p / width;
+                    int const x = p - y * width;
+                    int const n = std::min(width - x, end - p);
+                    typename ImageT::x_iterator ptr = out[i]->row_begin(y) + x;
+                    for (int k = 0; k != n; ++k, ++ptr, ++value) {
+                        *ptr = static_cast<typename ImageT::Pixel>(*value);
+                    }
+                    p += n;
+                }
+            }
+        }
+    });
+}
+
+template <typename ImageT>
+void makeEigenImages(detail::basic_tag const&, typename ImagePca<ImageT>::ImageList const& imageList,
+                     Eigen::MatrixXd const& weights, typename ImagePca<ImageT>::ImageList const& eigenImages,
+                     int nThreads) {
+    std::vector<ImageT const*> in;
+    for (auto const& image : imageList) {
+        in.push_back(image.get());
+    }
+    std::vector<ImageT*> out;
+    for (auto const& eImage : eigenImages) {
+        out.push_back(eImage.get());
+    }
+    combineImages(in, weights, out, nThreads);
+}
+
+template <typename ImageT>
+void makeEigenImages(detail::MaskedImage_tag const&, typename ImagePca<ImageT>::ImageList const& imageList,
+                     Eigen::MatrixXd const& weights, typename ImagePca<ImageT>::ImageList const& eigenImages,
+                     int nThreads) {
+    std::vector<typename ImageT::Image const*> in;
+    std::vector<typename ImageT::Variance const*> inVariance;
+    typename ImageT::Mask maskUnion(imageList[0]->getDimensions());
+    for (auto const& image : imageList) {
+        in.push_back(image->getImage().get());
+        inVariance.push_back(image->getVariance().get());
+        maskUnion |= *image->getMask();
+    }
+    std::vector<typename ImageT::Image*> out;
+    std::vector<typename ImageT::Variance*> outVariance;
+    for (auto const& eImage : eigenImages) {
+        out.push_back(eImage->getImage().get());
+        outVariance.push_back(eImage->getVariance().get());
+        *eImage->getMask() |= maskUnion;
+    }
+    combineImages(in, weights, out, nThreads);
+    combineImages(inVariance, Eigen::MatrixXd(weights.cwiseAbs2()), outVariance, nThreads);
+}
 }  // namespace
 
 template <typename ImageT>
@@ -142,23 +342,23 @@ void ImagePca<ImageT>::analyze() {
     /*
      * Find the eigenvectors/values of the scalar product matrix, R' (Eq. 7.4)
      */
-    Eigen::MatrixXd R(nImage, nImage);  // residuals' inner products
+    std::vector<typename GetImage<ImageT>::type const*> images;
+    images.reserve(nImage);
+    for (int i = 0; i != nImage; ++i) {
+        images.push_back(GetImage<ImageT>::getImage(_imageList[i]).get());
+    }
+    Eigen::MatrixXd R = computeInnerProducts(images, _numThreads);  // residuals' inner products
 
     double flux_bar = 0;  // mean of flux for all regions
     for (int i = 0; i != nImage; ++i) {
-        typename GetImage<ImageT>::type const& im_i = *GetImage<ImageT>::getImage(_imageList[i]);
         double const flux_i = getFlux(i);
         flux_bar += flux_i;
 
-        for (int j = i; j != nImage; ++j) {
-            typename GetImage<ImageT>::type const& im_j = *GetImage<ImageT>::getImage(_imageList[j]);
-            double const flux_j = getFlux(j);
-
-            double dot = innerProduct(im_i, im_j);
+        for (int j = 0; j != nImage; ++j) {
             if (_constantWeight) {
-                dot /= flux_i * flux_j;
+                R(i, j) /= flux_i * getFlux(j);
             }
-            R(i, j) = R(j, i) = dot / nImage;
+            R(i, j) /= nImage;
         }
     }
     flux_bar /= nImage;
@@ -197,17 +397,35 @@ void ImagePca<ImageT>::analyze() {
             continue;
         }
 
-        int const ii = lambdaAndIndex[i].second;  // the index after sorting (backwards) by eigenvalue
-
         std::shared_ptr<ImageT> eImage(new ImageT(_dimensions));
         *eImage = static_cast<typename ImageT::Pixel>(0);
+        _eigenImages.push_back(eImage);
+    }
+    int const nEigen = _eigenImages.size();
+    //
+    // Images with floating-point pixels are combined all at once as a matrix product; integer pixels
+    // are rounded as each image is added, so we do just that
+    //
+    if (std::is_floating_point<typename GetImage<ImageT>::type::Pixel>::value) {
+        Eigen::MatrixXd weights(nImage, nEigen);  // weight of each input image in each eigen image
+        for (int i = 0; i != nEigen; ++i) {
+            int const ii = lambdaAndIndex[i].second;  // the index after sorting (backwards) by eigenvalue
+            for (int jj = 0; jj != nImage; ++jj) {
+                weights(jj, i) = Q(jj, ii) * (_constantWeight ? flux_bar / getFlux(jj) : 1);
+            }
+        }
+        makeEigenImages<ImageT>(typename ImageT::image_category(), _imageList, weights, _eigenImages,
+                                _numThreads);
+    } else {
+        for (int i = 0; i != nEigen; ++i) {
+            int const ii = lambdaAndIndex[i].second;  // the index after sorting (backwards) by eigenvalue
 
-        for (int j = 0; j != nImage; ++j) {
-            int const jj = lambdaAndIndex[j].second;  // the index after sorting (backwards) by eigenvalue
-            double const weight = Q(jj, ii) * (_constantWeight ? flux_bar / getFlux(jj) : 1);
-            eImage->scaledPlus(weight, *_imageList[jj]);
+            for (int j = 0; j != nImage; ++j) {
+                int const jj = lambdaAndIndex[j].second;  // the index after sorting (backwards) by eigenvalue
+                double const weight = Q(jj, ii) * (_constantWeight ? flux_bar / getFlux(jj) : 1);
+                _eigenImages[i]->scaledPlus(weight, *_imageList[jj]);
+            }
         }
-        _eigenImages.push_back(eImage);
     }
 }
 
@@ -25,6 +25,8 @@
 /*
  * Background estimation class code
  */
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <limits>
 #include <vector>
@@ -34,6 +36,9 @@
 #include "lsst/afw/math/Approximate.h"
 #include "lsst/afw/math/Background.h"
 #include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/math/detail/Parallel.h"
+#include "lsst/afw/math/detail/Quantiles.h"
+#include "lsst/geom/Angle.h"
 
 namespace lsst {
 namespace ex = pex::exceptions;
@@ -75,8 +80,288 @@ void cullNan(std::vector<double> const& values, std::vector<double> const& refs,
         }
     }
 }
+
+// A piecewise-polynomial copy of an Interpolate object, for interpolating at many consecutive integer
+// positions without a virtual call (and a GSL evaluation) per position.
+//
+// The linear, spline and Akima interpolants are polynomials of degree at most three between the knots
+// x (as is the quadratic extrapolation InterpolateGsl uses beyond the ends), and a CONSTANT interpolant
+// is constant between its recentered knots; so each piece is recovered, to rounding error, from four
+// samples of the interpolant within it.
+class PiecewiseCubic {
+public:
+    PiecewiseCubic(Interpolate const& interp, Interpolate::Style const style, std::vector<double> const& x,
+                   int const size) {
+        // The positions at which the polynomial changes
+        if (style != Interpolate::CONSTANT) {
+            _breaks = x;
+        } else if (x.size() > 1) {  // as in Interpolate.cc's recenter()
+            std::size_t const len = x.size();
+            _breaks.reserve(len + 1);
+            _breaks.push_back(0.5 * (3 * x[0] - x[1]));
+            for (std::size_t i = 0; i < len - 1; ++i) {
+                _breaks.push_back(0.5 * (x[i] + x[i + 1]));
+            }
+            _breaks.push_back(0.5 * (3 * x[len - 1] - x[len - 2]));
+        }
+
+        std::size_t const nPieces = _breaks.size() + 1;
+        _pieces.reserve(nPieces);
+        for (std::size_t k = 0; k < nPieces; ++k) {
+            // The first and last pieces extend to the ends of [0, size)
+            double const lo = (k > 0) ? _breaks[k - 1]
+                                      : (_breaks.empty() ? 0.0 : std::min(0.0, _breaks.front() - 1.0));
+            double const hi =
+                    (k < nPieces - 1)
+                            ? _breaks[k]
+                            : (_breaks.empty() ? size : std::max<double>(size, _breaks.back() + 1.0));
+            _pieces.push_back(fitPiece(interp, lo, hi));
+        }
+    }
+
+    // Set out[i] to the interpolated value at position begin + i, for i in [0, n)
+    template <typename OutIterT>
+    void evaluate(int const begin, int const n, OutIterT out) const {
+        int x = begin;
+        int const end = begin + n;
+        for (std::size_t k = 0; k < _pieces.size() && x < end; ++k) {
+            // piece k covers the positions [_breaks[k - 1], _breaks[k])
+            int const pieceEnd =
+                    (k < _breaks.size()) ? std::min(end, static_cast<int>(std::ceil(_breaks[k]))) : end;
+            Piece const& piece = _pieces[k];
+            for (; x < pieceEnd; ++x, ++out) {
+                double const t = x - piece.origin;
+                *out = piece.c0 + t * (piece.c1 + t * (piece.c2 + t * piece.c3));
+            }
+        }
+    }
+
+private:
+    // c0 + t*(c1 + t*(c2 + t*c3)), where t = x - origin
+    struct Piece {
+        double origin, c0, c1, c2, c3;
+    };
+
+    // Fit a cubic to the interpolant at four points within [lo, hi)
+    static Piece fitPiece(Interpolate const& interp, double const lo, double const hi) {
+        if (!(hi > lo)) {  // a zero-length piece, which no position falls in
+            return Piece{lo, interp.interpolate(lo), 0.0, 0.0, 0.0};
+        }
+        double t[4], f[4];
+        for (int i = 0; i < 4; ++i) {
+            t[i] = (2 * i + 1) * (hi - lo) / 8;
+            f[i] = interp.interpolate(lo + t[i]);
+        }
+        // Newton's divided differences, converted to the power basis
+        double const d01 = (f[1] - f[0]) / (t[1] - t[0]);
+        double const d12 = (f[2] - f[1]) / (t[2] - t[1]);
+        double const d23 = (f[3] - f[2]) / (t[3] - t[2]);
+        double const d012 = (d12 - d01) / (t[2] - t[0]);
+        double const d123 = (d23 - d12) / (t[3] - t[1]);
+        double const d0123 = (d123 - d012) / (t[3] - t[0]);
+        return Piece{lo, f[0] - d01 * t[0] + d012 * t[0] * t[1] - d0123 * t[0] * t[1] * t[2],
+                     d01 - d012 * (t[0] + t[1]) + d0123 * (t[0] * t[1] + t[0] * t[2] + t[1] * t[2]),
+                     d012 - d0123 * (t[0] + t[1] + t[2]), d0123};
+    }
+
+    std::vector<double> _breaks;  // piece k covers [_breaks[k - 1], _breaks[k])
+    std::vector<Piece> _pieces;
+};
+
+// Are two statistics images' values the same (treating all NaNs as equal)?
+bool haveSameValues(std::vector<Background::InternalPixelT> const& values,
+                    image::Image<Background::InternalPixelT> const& img) {
+    return values.size() == static_cast<std::size_t>(img.getWidth()) * img.getHeight() &&
+           std::equal(values.begin(), values.end(), img.begin(),
+                      [](Background::InternalPixelT a, Background::InternalPixelT b) {
+                          return a == b || (std::isnan(a) && std::isnan(b));
+                      });
+}
+
+// Number of bins in each cell's histogram when BackgroundControl::getSharedHistogram() is set
+int const NUM_SHARED_HISTOGRAM_BINS = 4096;
+// Maximum number of pixels sampled to choose the range of the histograms
+double const MAX_RANGE_SAMPLE = 1 << 16;
+
+// The pixels and mask (if any) of Images and MaskedImages
+template <typename PixelT>
+image::Image<PixelT> const& getImagePlane(image::Image<PixelT> const& img) {
+    return img;
+}
+template <typename PixelT>
+image::Image<PixelT> const& getImagePlane(image::MaskedImage<PixelT> const& mimg) {
+    return *mimg.getImage();
+}
+template <typename PixelT>
+image::Mask<image::MaskPixel> const* getMaskPlane(image::Image<PixelT> const&) {
+    return nullptr;
+}
+template <typename PixelT>
+image::Mask<image::MaskPixel> const* getMaskPlane(image::MaskedImage<PixelT> const& mimg) {
+    return mimg.getMask().get();
+}
+
+// Histograms of the good (finite and unmasked) pixels of each cell in a row of cells, used to estimate
+// all the cells' medians in a single pass over the image.
+//
+// All the histograms have the same NUM_SHARED_HISTOGRAM_BINS bins, chosen by the constructor from
+// the spread of a sparse sample of the good pixels over the whole image, plus an underflow and an
+// overflow bin.  A median is estimated by assuming that the values are spread uniformly within
+// each bin, and is not available if it falls in the underflow or overflow bin.
+template <typename PixelT>
+class CellHistograms {
+public:
+    CellHistograms(image::Image<PixelT> const& img, image::Mask<image::MaskPixel> const* mask,
+                   image::MaskPixel const andMask, std::vector<int> const& xorig,
+                   std::vector<int> const& xsize)
+            : _img(img), _mask(mask), _andMask(andMask), _xorig(xorig), _xsize(xsize) {
+        int const width = img.getWidth();
+        int const height = img.getHeight();
+        int const step = std::max(
+                1, static_cast<int>(std::ceil(std::sqrt(width * static_cast<double>(height) /
+                                                        MAX_RANGE_SAMPLE))));
+        std::vector<PixelT> sample;
+        for (int y = 0; y < height; y += step) {
+            for (int x = 0; x < width; x += step) {
+                PixelT const value = img(x, y);
+                if (isGood(value, x, y)) {
+                    sample.push_back(value);
+                }
+            }
+        }
+
+        // Cover five times the interquartile range of the sample, so that the bins are narrow compared
+        // to the noise (and unaffected by bright objects) but still include the medians of cells on
+        // a background gradient
+        double const q1 = sample.empty() ? 0.0 : detail::percentile(sample, 0.25);
+        double const q3 = sample.empty() ? 0.0 : detail::percentile(sample, 0.75);
+        double const iqrange = (q3 > q1) ? q3 - q1 : 1.0;
+        _low = q1 - 2 * iqrange;
+        _binWidth = 5 * iqrange / NUM_SHARED_HISTOGRAM_BINS;
+        _center = 0.5 * (q1 + q3);
+    }
+
+    // Histogram the cells in rows [yBegin, yEnd) of the image, discarding any previous histograms
+    void accumulate(int const yBegin, int const yEnd) {
+        std::size_t const nCells = _xorig.size();
+        _counts.assign(nCells * (NUM_SHARED_HISTOGRAM_BINS + 2), 0);
+        _cells.assign(nCells, Cell{0, 0.0, 0.0, std::numeric_limits<double>::infinity(),
+                                   -std::numeric_limits<double>::infinity()});
+
+        double const invBinWidth = 1.0 / _binWidth;
+        for (int y = yBegin; y < yEnd; ++y) {
+            auto const row = _img.row_begin(y);
+            for (std::size_t iX = 0; iX < nCells; ++iX) {
+                std::uint32_t* counts = &_counts[iX * (NUM_SHARED_HISTOGRAM_BINS + 2)];
+                Cell& cell = _cells[iX];
+                for (int x = _xorig[iX], end = _xorig[iX] + _xsize[iX]; x < end; ++x) {
+                    PixelT const value = row[x];
+                    if (!isGood(value, x, y)) {
+                        continue;
+                    }
+                    double const t = (value - _low) * invBinWidth;
+                    std::size_t const bin = (t < 0) ? 0
+                                                    : (t < NUM_SHARED_HISTOGRAM_BINS)
+                                                              ? static_cast<std::size_t>(t) + 1
+                                                              : NUM_SHARED_HISTOGRAM_BINS + 1;
+                    ++counts[bin];
+
+                    double const dx = value - _center;
+                    ++cell.n;
+                    cell.sumx += dx;
+                    cell.sumx2 += dx * dx;
+                    cell.min = std::min<double>(cell.min, value);
+                    cell.max = std::max<double>(cell.max, value);
+                }
+            }
+        }
+    }
+
+    /*
+     * Estimate the median of cell iX and its error, as makeStatistics(MEDIAN | ERRORS) would compute them
+     *
+     * Return false if the median falls outside the histogram's bins
+     */
+    bool getMedian(int const iX, std::pair<double, double>& result) const {
+        double const NaN = std::numeric_limits<double>::quiet_NaN();
+        Cell const& cell = _cells[iX];
+        if (cell.n == 0) {
+            result = std::make_pair(NaN, NaN);
+            return true;
+        }
+        std::uint32_t const* counts = &_counts[iX * (NUM_SHARED_HISTOGRAM_BINS + 2)];
+
+        // interpolate linearly between the adjacent order statistics, as in detail::percentile()
+        double const idx = 0.5 * (cell.n - 1);
+        std::size_t const q1 = static_cast<std::size_t>(idx);
+        std::size_t const q2 = std::min(q1 + 1, cell.n - 1);
+        double const median = (q1 + 1 - idx) * getOrderStatistic(counts, q1) +
+                              (idx - q1) * getOrderStatistic(counts, q2);
+        if (std::isnan(median)) {
+            return false;
+        }
+
+        // N.b. as in Statistics, we'll get a NaN variance if n == 1
+        double const n = cell.n;
+        double const mean = cell.sumx / n;
+        double const variance = (cell.sumx2 / n - mean * mean) * n / (n - 1);
+        result = std::make_pair(std::max(cell.min, std::min(cell.max, median)),
+                                std::sqrt(geom::HALFPI * variance / n));
+        return true;
+    }
+
+private:
+    // The sums needed for a cell's median error, and the range of its values
+    struct Cell {
+        std::size_t n;
+        double sumx;   // sum(value - _center)
+        double sumx2;  // sum((value - _center)^2)
+        double min;
+        double max;
+    };
+
+    bool isGood(PixelT const value, int const x, int const y) const {
+        return std::isfinite(value) && !(_mask && ((*_mask)(x, y) & _andMask));
+    }
+
+    // Estimate the value of the order statistic of (0-based) rank from a histogram; NaN if it
+    // falls in the underflow or overflow bin
+    double getOrderStatistic(std::uint32_t const* counts, std::size_t const rank) const {
+        std::size_t nBelow = 0;
+        std::size_t bin = 0;
+        while (nBelow + counts[bin] <= rank) {
+            nBelow += counts[bin++];
+        }
+        if (bin == 0 || bin == NUM_SHARED_HISTOGRAM_BINS + 1) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return _low + (bin - 1 + (rank - nBelow + 0.5) / counts[bin]) * _binWidth;
+    }
+
+    image::Image<PixelT> const& _img;
+    image::Mask<image::MaskPixel> const* _mask;
+    image::MaskPixel const _andMask;
+    std::vector<int> const& _xorig;
+    std::vector<int> const& _xsize;
+    double _low;       // lower edge of the first bin (after the underflow bin)
+    double _binWidth;  // width of each bin
+    double _center;    // value subtracted from the pixels before accumulating their moments
+    std::vector<std::uint32_t> _counts;  // the histograms, one after the other
+    std::vector<Cell> _cells;
+};
 }  // namespace
 
+/*
+ * The interpolants for the rows of the background image, which doGetImage computes from the statistics
+ * image and reuses as long as neither the interpolation styles nor the statistics change.
+ */
+struct BackgroundMI::RowInterpolants {
+    Interpolate::Style interpStyle;           // the interpolation style used
+    UndersampleStyle undersampleStyle;        // the undersample style used
+    std::vector<InternalPixelT> statsValues;  // the statistics image values used
+    std::vector<PiecewiseCubic> rows;         // interpolant for each row of the image
+};
+
 template <typename ImageT>
 BackgroundMI::BackgroundMI(ImageT const& img, BackgroundControl const& bgCtrl)
         : Background(img, bgCtrl), _statsImage(image::MaskedImage<InternalPixelT>()) {
@@ -90,19 +375,48 @@ BackgroundMI::BackgroundMI(ImageT const& img, BackgroundControl const& bgCtrl)
     image::MaskedImage<InternalPixelT>::Image& im = *_statsImage.getImage();
     image::MaskedImage<InternalPixelT>::Variance& var = *_statsImage.getVariance();
 
-    for (int iX = 0; iX < nxSample; ++iX) {
-        for (int iY = 0; iY < nySample; ++iY) {
-            ImageT subimg = ImageT(img,
-                                   lsst::geom::Box2I(lsst::geom::Point2I(_xorig[iX], _yorig[iY]),
-                                                     lsst::geom::Extent2I(_xsize[iX], _ysize[iY])),
-                                   image::LOCAL);
-
-            std::pair<double, double> res = makeStatistics(subimg, bgCtrl.getStatisticsProperty() | ERRORS,
-                                                           *bgCtrl.getStatisticsControl())
-                                                    .getResult();
-            im(iX, iY) = res.first;
-            var(iX, iY) = res.second;
-        }
+    Property const prop = bgCtrl.getStatisticsProperty();
+    StatisticsControl const& sctrl = *bgCtrl.getStatisticsControl();
+    // The cells are independent, and each sets only its own pixel of _statsImage,
+    // so they may be measured in parallel
+    auto measureCell = [&](int const iX, int const iY) {
+        ImageT subimg = ImageT(img,
+                               lsst::geom::Box2I(lsst::geom::Point2I(_xorig[iX], _yorig[iY]),
+                                                 lsst::geom::Extent2I(_xsize[iX], _ysize[iY])),
+                               image::LOCAL);
+
+        std::pair<double, double> res = makeStatistics(subimg, prop | ERRORS, sctrl).getResult();
+        im(iX, iY) = res.first;
+        var(iX, iY) = res.second;
+    };
+
+    if (bgCtrl.getSharedHistogram() && prop == MEDIAN && sctrl.getNanSafe() && !sctrl.getWeighted()) {
+        // Histogram each row of cells in one pass over its pixels, falling back to makeStatistics
+        // for any cell whose median is outside the histograms' range
+        CellHistograms<typename ImageT::Pixel> const bins(getImagePlane(img), getMaskPlane(img),
+                                                          sctrl.getAndMask(), _xorig, _xsize);
+        detail::parallelFor(0, nySample, bgCtrl.getNumThreads(), [&](int const begin, int const end) {
+            CellHistograms<typename ImageT::Pixel> hist(bins);
+            for (int iY = begin; iY < end; ++iY) {
+                hist.accumulate(_yorig[iY], _yorig[iY] + _ysize[iY]);
+                for (int iX = 0; iX < nxSample; ++iX) {
+                    std::pair<double, double> res;
+                    if (hist.getMedian(iX, res)) {
+                        im(iX, iY) = res.first;
+                        var(iX, iY) = res.second;
+                    } else {
+                        measureCell(iX, iY);
+                    }
+                }
+            }
+        });
+    } else {
+        detail::parallelFor(0, nxSample * nySample, bgCtrl.getNumThreads(),
+                            [&](int const begin, int const end) {
+                                for (int i = begin; i < end; ++i) {
+                                    measureCell(i % nxSample, i / nxSample);
+                                }
+                            });
     }
 }
 BackgroundMI::BackgroundMI(lsst::geom::Box2I const imageBBox,
@@ -110,8 +424,7 @@ BackgroundMI::BackgroundMI(lsst::geom::Box2I const imageBBox,
         : Background(imageBBox, statsImage.getWidth(), statsImage.getHeight()), _statsImage(statsImage) {}
 
 void BackgroundMI::_setGridColumns(Interpolate::Style const interpStyle,
-                                   UndersampleStyle const undersampleStyle, int const iX,
-                                   std::vector<int> const& ypix) const {
+                                   UndersampleStyle const undersampleStyle, int const iX) const {
     image::MaskedImage<InternalPixelT>::Image& im = *_statsImage.getImage();
 
     int const height = _imgBBox.getHeight();
@@ -128,6 +441,7 @@ void BackgroundMI::_setGridColumns(Interpolate::Style const interpStyle,
     cullNan(_ycen, _grid, ycenTmp, gridTmp);
 
     std::shared_ptr<Interpolate> intobj;
+    Interpolate::Style usedStyle = interpStyle;
     try {
         intobj = makeInterpolate(ycenTmp, gridTmp, interpStyle);
     } catch (pex::exceptions::OutOfRangeError& e) {
@@ -141,10 +455,11 @@ void BackgroundMI::_setGridColumns(Interpolate::Style const interpStyle,
                     ycenTmp.push_back(0);
                     gridTmp.push_back(std::numeric_limits<double>::quiet_NaN());
 
-                    intobj = makeInterpolate(ycenTmp, gridTmp, Interpolate::CONSTANT);
+                    usedStyle = Interpolate::CONSTANT;
+                    intobj = makeInterpolate(ycenTmp, gridTmp, usedStyle);
                     break;
                 } else {
-                    return _setGridColumns(lookupMaxInterpStyle(gridTmp.size()), undersampleStyle, iX, ypix);
+                    return _setGridColumns(lookupMaxInterpStyle(gridTmp.size()), undersampleStyle, iX);
                 }
             }
             case INCREASE_NXNYSAMPLE:
@@ -162,9 +477,7 @@ void BackgroundMI::_setGridColumns(Interpolate::Style const interpStyle,
         throw;
     }
 
-    for (int iY = 0; iY < height; ++iY) {
-        _gridColumns[iX][iY] = intobj->interpolate(ypix[iY]);
-    }
+    PiecewiseCubic(*intobj, usedStyle, ycenTmp, height).evaluate(0, height, _gridColumns[iX].begin());
 }
 
 BackgroundMI& BackgroundMI::operator+=(float const delta) {
@@ -197,6 +510,87 @@ double BackgroundMI::getPixel(Interpolate::Style const interpStyle, int const x,
         throw;
     }
 }
+std::shared_ptr<BackgroundMI::RowInterpolants const> BackgroundMI::_makeRowInterpolants(
+        Interpolate::Style const interpStyle, UndersampleStyle const undersampleStyle) const {
+    image::Image<InternalPixelT> const& statsImage = *_statsImage.getImage();
+    auto result = std::make_shared<RowInterpolants>();
+    result->interpStyle = interpStyle;
+    result->undersampleStyle = undersampleStyle;
+    result->statsValues.assign(statsImage.begin(), statsImage.end());
+
+    // =============================================================
+    // --> We'll store nxSample fully-interpolated columns to interpolate the rows over
+    int const nxSample = _statsImage.getWidth();
+    int const width = _imgBBox.getWidth();
+    int const height = _imgBBox.getHeight();
+
+    _gridColumns.resize(width);
+    for (int iX = 0; iX < nxSample; ++iX) {
+        _setGridColumns(interpStyle, undersampleStyle, iX);
+    }
+
+    // go through row by row
+    // - interpolate on the gridcolumns that were pre-computed above
+    std::vector<double> xcenTmp, bgTmp;
+
+    // N.b. There's no API to set defaultValue to other than NaN (due to issues with persistence
+    // that I don't feel like fixing;  #2825).  If we want to address this, this is the place
+    // to start, but note that NaN is treated specially -- it means, "Interpolate" so to allow
+    // us to put a NaN into the outputs some changes will be needed
+    double defaultValue = std::numeric_limits<double>::quiet_NaN();
+
+    result->rows.reserve(height);
+    for (int iY = 0; iY < height; ++iY) {
+        // build an interp object for this row
+        std::vector<double> bg_x(nxSample);
+        for (int iX = 0; iX < nxSample; iX++) {
+            bg_x[iX] = static_cast<double>(_gridColumns[iX][iY]);
+        }
+        cullNan(_xcen, bg_x, xcenTmp, bgTmp, defaultValue);
+
+        std::shared_ptr<Interpolate> intobj;
+        Interpolate::Style rowStyle = interpStyle;
+        try {
+            intobj = makeInterpolate(xcenTmp, bgTmp, interpStyle);
+        } catch (pex::exceptions::OutOfRangeError& e) {
+            switch (undersampleStyle) {
+                case THROW_EXCEPTION:
+                    LSST_EXCEPT_ADD(e, str(boost::format("Interpolating in y (iY = %d)") % iY));
+                    throw;
+                case REDUCE_INTERP_ORDER: {
+                    if (bgTmp.empty()) {
+                        xcenTmp.push_back(0);
+                        bgTmp.push_back(defaultValue);
+
+                        rowStyle = Interpolate::CONSTANT;
+                        intobj = makeInterpolate(xcenTmp, bgTmp, rowStyle);
+                        break;
+                    } else {
+                        rowStyle = lookupMaxInterpStyle(bgTmp.size());
+                        intobj = makeInterpolate(xcenTmp, bgTmp, rowStyle);
+                    }
+                } break;
+                case INCREASE_NXNYSAMPLE:
+                    LSST_EXCEPT_ADD(
+                            e,
+                            "The BackgroundControl UndersampleStyle INCREASE_NXNYSAMPLE is not supported.");
+                    throw;
+                default:
+                    LSST_EXCEPT_ADD(e, str(boost::format("The selected BackgroundControl "
+                                                         "UndersampleStyle %d is not defined.") %
+                                           undersampleStyle));
+                    throw;
+            }
+        } catch (ex::Exception& e) {
+            LSST_EXCEPT_ADD(e, str(boost::format("Interpolating in y (iY = %d)") % iY));
+            throw;
+        }
+
+        result->rows.emplace_back(*intobj, rowStyle, xcenTmp, width);
+    }
+    return result;
+}
+
 template <typename PixelT>
 std::shared_ptr<image::Image<PixelT>> BackgroundMI::doGetImage(
         lsst::geom::Box2I const& bbox,
@@ -272,21 +666,14 @@ std::shared_ptr<image::Image<PixelT>> BackgroundMI::doGetImage(
                 ->getImage();
     }
 
-    // =============================================================
-    // --> We'll store nxSample fully-interpolated columns to interpolate the rows over
-    // make a vector containing the y pixel coords for the column
-    int const width = _imgBBox.getWidth();
-    int const height = _imgBBox.getHeight();
-    auto const bboxOff = bbox.getMin() - _imgBBox.getMin();
-
-    std::vector<int> ypix(height);
-    for (int iY = 0; iY < height; ++iY) {
-        ypix[iY] = iY;
-    }
-
-    _gridColumns.resize(width);
-    for (int iX = 0; iX < nxSample; ++iX) {
-        _setGridColumns(interpStyle, undersampleStyle, iX, ypix);
+    // The row interpolants only depend on the styles and the statistics image, so we can reuse them
+    // if a previous call computed them from the same inputs (e.g. for another bbox)
+    image::Image<InternalPixelT> const& statsImage = *_statsImage.getImage();
+    if (!_rowInterpolants || _rowInterpolants->interpStyle != interpStyle ||
+        _rowInterpolants->undersampleStyle != undersampleStyle ||
+        !haveSameValues(_rowInterpolants->statsValues, statsImage)) {
+        _rowInterpolants.reset();  // in case we throw
+        _rowInterpolants = _makeRowInterpolants(interpStyle, undersampleStyle);
     }
 
     // create a shared_ptr to put the background image in and return to caller
@@ -294,64 +681,10 @@ std::shared_ptr<image::Image<PixelT>> BackgroundMI::doGetImage(
     std::shared_ptr<image::Image<PixelT>> bg =
             std::shared_ptr<image::Image<PixelT>>(new image::Image<PixelT>(bbox.getDimensions()));
 
-    // go through row by row
-    // - interpolate on the gridcolumns that were pre-computed by the constructor
-    // - copy the values to an ImageT to return to the caller.
-    std::vector<double> xcenTmp, bgTmp;
-
-    // N.b. There's no API to set defaultValue to other than NaN (due to issues with persistence
-    // that I don't feel like fixing;  #2825).  If we want to address this, this is the place
-    // to start, but note that NaN is treated specially -- it means, "Interpolate" so to allow
-    // us to put a NaN into the outputs some changes will be needed
-    double defaultValue = std::numeric_limits<double>::quiet_NaN();
-
+    // fill the image row by row with the interpolated values
+    auto const bboxOff = bbox.getMin() - _imgBBox.getMin();
     for (int y = 0, iY = bboxOff.getY(); y < bbox.getHeight(); ++y, ++iY) {
-        // build an interp object for this row
-        std::vector<double> bg_x(nxSample);
-        for (int iX = 0; iX < nxSample; iX++) {
-            bg_x[iX] = static_cast<double>(_gridColumns[iX][iY]);
-        }
-        cullNan(_xcen, bg_x, xcenTmp, bgTmp, defaultValue);
-
-        std::shared_ptr<Interpolate> intobj;
-        try {
-            intobj = makeInterpolate(xcenTmp, bgTmp, interpStyle);
-        } catch (pex::exceptions::OutOfRangeError& e) {
-            switch (undersampleStyle) {
-                case THROW_EXCEPTION:
-                    LSST_EXCEPT_ADD(e, str(boost::format("Interpolating in y (iY = %d)") % iY));
-                    throw;
-                case REDUCE_INTERP_ORDER: {
-                    if (bgTmp.empty()) {
-                        xcenTmp.push_back(0);
-                        bgTmp.push_back(defaultValue);
-
-                        intobj = makeInterpolate(xcenTmp, bgTmp, Interpolate::CONSTANT);
-                        break;
-                    } else {
-                        intobj = makeInterpolate(xcenTmp, bgTmp, lookupMaxInterpStyle(bgTmp.size()));
-                    }
-                } break;
-                case INCREASE_NXNYSAMPLE:
-                    LSST_EXCEPT_ADD(
-                            e,
-                            "The BackgroundControl UndersampleStyle INCREASE_NXNYSAMPLE is not supported.");
-                    throw;
-                default:
-                    LSST_EXCEPT_ADD(e, str(boost::format("The selected BackgroundControl "
-                                                         "UndersampleStyle %d is not defined.") %
-                                           undersampleStyle));
-                    throw;
-            }
-        } catch (ex::Exception& e) {
-            LSST_EXCEPT_ADD(e, str(boost::format("Interpolating in y (iY = %d)") % iY));
-            throw;
-        }
-
-        // fill the image with interpolated values
-        for (int iX = bboxOff.getX(), x = 0; x < bbox.getWidth(); ++iX, ++x) {
-            (*bg)(x, y) = static_cast<PixelT>(intobj->interpolate(iX));
-        }
+        _rowInterpolants->rows[iY].evaluate(bboxOff.getX(), bbox.getWidth(), bg->row_begin(y));
     }
     bg->setXY0(bbox.getMin());
 
@@ -22,6 +22,7 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <algorithm>
 #include <numeric>
 
 #include "lsst/pex/exceptions.h"
@@ -46,12 +47,30 @@ ndarray::Array<double, 1, 1> BoundedField::evaluate(ndarray::Array<double const,
     return out;
 }
 
+ndarray::Array<double, 2, 2> BoundedField::evaluateGrid(ndarray::Array<double const, 1> const &x,
+                                                        ndarray::Array<double const, 1> const &y) const {
+    int const nx = x.getSize<0>();
+    int const ny = y.getSize<0>();
+    ndarray::Array<double, 1, 1> xx = ndarray::allocate(nx * ny);
+    ndarray::Array<double, 1, 1> yy = ndarray::allocate(nx * ny);
+    for (int i = 0; i < ny; ++i) {
+        std::copy(x.begin(), x.end(), xx.begin() + i * nx);
+        std::fill(yy.begin() + i * nx, yy.begin() + (i + 1) * nx, y[i]);
+    }
+    ndarray::Array<double, 2, 2> out = ndarray::allocate(ny, nx);
+    ndarray::flatten<1>(out).deep() = evaluate(xx, yy);
+    return out;
+}
+
 double BoundedField::integrate() const { throw LSST_EXCEPT(pex::exceptions::LogicError, "Not Implemented"); }
 
 double BoundedField::mean() const { throw LSST_EXCEPT(pex::exceptions::LogicError, "Not Implemented"); }
 
 namespace {
 
+// Maximum number of pixels evaluated in a single call to BoundedField::evaluateGrid by applyToImage
+int const GRID_BLOCK_AREA = 1 << 16;
+
 // We use these operator-based functors to implement the various image-modifying routines
 // in BoundedField.  I don't think this is necessarily the best way to add interoperability
 // with images, but it seems like a reasonable point on the simplicity vs. featurefulness
@@ -90,11 +109,8 @@ struct Divide {
     }
 };
 
-// Helper class to do bilinear interpolation with no dynamic memory
-// allocation. This means we evaluate the function multiple times at some
-// points (when we move to a new interval in y, to be specific). Could
-// probably be optimized for the cases where either step is 1, but that seems
-// premature.
+// Helper class to do bilinear interpolation.  The BoundedField is evaluated once on the grid of cell
+// corners, using BoundedField::evaluateGrid, before any cells are filled in.
 class Interpolator {
 public:
     // Description of a cell to interpolate in one dimension.
@@ -103,17 +119,31 @@ public:
         int min;  // lower-bound of cell (coordinate of known value and one before first point to fill in)
         int max;  // upper-bound of cell (coordinate of known value)
         int end;  // upper-bound of cell (one after last point to fill in)
+        int index;  // index of min in the grid of cell corners
 
         // Construct from step only.
         //
         // Other variables are initialized (and re-initialized) by calls to reset().
-        explicit Bounds(int step_) : step(step_), min(0), max(0), end(0) {}
+        explicit Bounds(int step_) : step(step_), min(0), max(0), end(0), index(0) {}
 
         // Reset all points (aside from the step) to the first cell in this dimension.
         void reset(int min_) {
             min = min_;
             max = min_ + step;
             end = min_ + step;
+            index = 0;
+        }
+
+        // Return the coordinates of the cell corners in this dimension, in the order they are visited.
+        ndarray::Array<double, 1, 1> makeCorners(int begin, int endValue) const {
+            std::vector<double> corners(1, begin);
+            for (int value = begin + step; value < endValue; value += step) {
+                corners.push_back(value);
+            }
+            corners.push_back(endValue - 1);  // special last row/column
+            ndarray::Array<double, 1, 1> out = ndarray::allocate(corners.size());
+            std::copy(corners.begin(), corners.end(), out.begin());
+            return out;
         }
     };
 
@@ -134,12 +164,15 @@ public:
     // to iterate over cells in x.
     template <typename T, typename F>
     void run(image::Image<T> &img, F functor) {
+        _corners = _field->evaluateGrid(_x.makeCorners(_region->getBeginX(), _region->getEndX()),
+                                        _y.makeCorners(_region->getBeginY(), _region->getEndY()));
         _y.reset(_region->getBeginY());
         while (_y.end < _region->getEndY()) {
             _runRow(img, functor);
             _y.min = _y.max;
             _y.max += _y.step;
             _y.end = _y.max;
+            ++_y.index;
         }
         {  // special-case last iteration in y
             _y.max = _region->getMaxY();
@@ -153,27 +186,27 @@ private:
     template <typename T, typename F>
     void _runRow(image::Image<T> &img, F functor) {
         _x.reset(_region->getBeginX());
-        _z00 = _field->evaluate(_x.min, _y.min);
-        _z01 = _field->evaluate(_x.min, _y.max);
+        _z00 = _corners[_y.index][_x.index];
+        _z01 = _corners[_y.index + 1][_x.index];
         while (_x.max < _region->getEndX()) {
-            _z10 = _field->evaluate(_x.max, _y.min);
-            _z11 = _field->evaluate(_x.max, _y.max);
+            _z10 = _corners[_y.index][_x.index + 1];
+            _z11 = _corners[_y.index + 1][_x.index + 1];
             _runCell(img, functor);
             _x.min = _x.max;
             _x.max += _x.step;
             _x.end = _x.max;
+            ++_x.index;
             _z00 = _z10;
             _z01 = _z11;
         }
         {  // special-case last iteration in x
             _x.max = _region->getMaxX();
             _x.end = _region->getEndX();
-            _z10 = _field->evaluate(_x.max, _y.min);
-            _z11 = _field->evaluate(_x.max, _y.max);
+            _z10 = _corners[_y.index][_x.index + 1];
+            _z11 = _corners[_y.index + 1][_x.index + 1];
             _runCell(img, functor);
         }
     }
-
     // Interpolate all points in a cell, which is defined as a rectangle for which
     // the BoundedField has been evaluated at all four corners.  The main complication
     // comes from the need to special-case the unusually-sized final cells and final
@@ -215,6 +248,7 @@ private:
     lsst::geom::Box2I const *_region;
     Bounds _x;
     Bounds _y;
+    ndarray::Array<double, 2, 2> _corners;  // field evaluated at the cell corners, indexed by [y][x]
     double _z00, _z01, _z10, _z11;
 };
 
@@ -233,18 +267,25 @@ void applyToImage(BoundedField const &field, image::Image<T> &img, F functor, bo
         Interpolator interpolator(&field, &region, xStep, yStep);
         interpolator.run(img, functor);
     } else {
-        // We iterate over rows as a significant optimization for AST-backed bounded fields
-        // (it's also slightly faster for other bounded fields, too).
+        // We evaluate blocks of rows with evaluateGrid as a significant optimization for AST-backed
+        // bounded fields (and fields with separable structure), while bounding the memory used.
         auto subImage = img.subset(region);
         auto size = region.getWidth();
+        int const blockHeight = std::max(1, GRID_BLOCK_AREA / std::max(size, 1));
         ndarray::Array<double, 1> xx = ndarray::allocate(ndarray::makeVector(size));
-        ndarray::Array<double, 1> yy = ndarray::allocate(ndarray::makeVector(size));
-        // y gets incremented each outer loop, x is always xMin->xMax
+        // x is always xMin->xMax
         std::iota(xx.begin(), xx.end(), region.getBeginX());
         auto outRowIter = subImage.getArray().begin();
-        for (int y = region.getBeginY(); y < region.getEndY(); ++y, ++outRowIter) {
-            yy.deep() = y;  // don't need indexToPosition, as we're already working in the right box (region).
-            functor(*outRowIter, field.evaluate(xx, yy));
+        for (int yBegin = region.getBeginY(); yBegin < region.getEndY(); yBegin += blockHeight) {
+            int const yEnd = std::min(yBegin + blockHeight, region.getEndY());
+            ndarray::Array<double, 1> yy = ndarray::allocate(ndarray::makeVector(yEnd - yBegin));
+            // don't need indexToPosition, as we're already working in the right box (region).
+            std::iota(yy.begin(), yy.end(), yBegin);
+            ndarray::Array<double, 2, 2> values = field.evaluateGrid(xx, yy);
+            for (auto valueRowIter = values.begin(); valueRowIter != values.end();
+                 ++valueRowIter, ++outRowIter) {
+                functor(*outRowIter, *valueRowIter);
+            }
         }
     }
 }
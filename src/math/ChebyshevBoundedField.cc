@@ -285,6 +285,28 @@ double ChebyshevBoundedField::evaluate(lsst::geom::Point2D const& position) cons
                               _coefficients.getSize<0>());
 }
 
+ndarray::Array<double, 2, 2> ChebyshevBoundedField::evaluateGrid(
+        ndarray::Array<double const, 1> const& x, ndarray::Array<double const, 1> const& y) const {
+    int const nx = x.getSize<0>();
+    int const ny = y.getSize<0>();
+    // T_j(x) for each grid column, with x values in rows and j in columns, and likewise for y
+    ndarray::Array<double, 2, 2> tx = ndarray::allocate(nx, _coefficients.getSize<1>());
+    for (int p = 0; p < nx; ++p) {
+        evaluateBasis1d(tx[p], _toChebyshevRange[lsst::geom::AffineTransform::XX] * x[p] +
+                                       _toChebyshevRange[lsst::geom::AffineTransform::X]);
+    }
+    ndarray::Array<double, 2, 2> ty = ndarray::allocate(ny, _coefficients.getSize<0>());
+    for (int p = 0; p < ny; ++p) {
+        evaluateBasis1d(ty[p], _toChebyshevRange[lsst::geom::AffineTransform::YY] * y[p] +
+                                       _toChebyshevRange[lsst::geom::AffineTransform::Y]);
+    }
+    // out[i][j] = sum_{m,n} T_m(y_i) c_{m,n} T_n(x_j)
+    ndarray::Array<double, 2, 2> out = ndarray::allocate(ny, nx);
+    ndarray::asEigenMatrix(out) = (ndarray::asEigenMatrix(ty) * ndarray::asEigenMatrix(_coefficients)) *
+                                  ndarray::asEigenMatrix(tx).transpose();
+    return out;
+}
+
 // The integral of T_n(x) over [-1,1]:
 // https://en.wikipedia.org/wiki/Chebyshev_polynomials#Differentiation_and_integration
 double integrateTn(int n) {
@@ -101,6 +101,51 @@ ndarray::Array<double, 1, 1> PixelAreaBoundedField::evaluate(
     return z;
 }
 
+ndarray::Array<double, 2, 2> PixelAreaBoundedField::evaluateGrid(
+    ndarray::Array<double const, 1> const & x,
+    ndarray::Array<double const, 1> const & y
+) const {
+    double constexpr side = 1.0;
+    auto isSpacedBySide = [](ndarray::Array<double const, 1> const & values) {
+        for (std::size_t i = 1; i < values.size(); ++i) {
+            if (values[i] != values[i - 1] + side) {
+                return false;
+            }
+        }
+        return true;
+    };
+    std::size_t const nx = x.size();
+    std::size_t const ny = y.size();
+    if (nx == 0 || ny == 0 || !isSpacedBySide(x) || !isSpacedBySide(y)) {
+        return BoundedField::evaluateGrid(x, y);
+    }
+    // Compute _skyWcs->pixelToSky in a single vectorized call on a grid with one extra column and row;
+    // the points one pixel away in x and y are then the neighboring grid points.
+    std::vector<lsst::geom::Point2D> pixPoints;
+    pixPoints.reserve((nx + 1)*(ny + 1));
+    for (std::size_t i = 0; i <= ny; ++i) {
+        double const yi = (i < ny) ? y[i] : y[ny - 1] + side;
+        for (std::size_t j = 0; j < nx; ++j) {
+            pixPoints.emplace_back(x[j], yi);
+        }
+        pixPoints.emplace_back(x[nx - 1] + side, yi);
+    }
+    auto skyPoints = _skyWcs->pixelToSky(pixPoints);
+    // Work in 3-space to avoid RA wrapping and pole issues.
+    ndarray::Array<double, 2, 2> z = ndarray::allocate(ny, nx);
+    for (std::size_t i = 0; i < ny; ++i) {
+        for (std::size_t j = 0; j < nx; ++j) {
+            std::size_t k = i*(nx + 1) + j;
+            auto skyLL = skyPoints[k].getVector();
+            auto skyDx = skyPoints[k + 1].getVector() - skyLL;
+            auto skyDy = skyPoints[k + nx + 1].getVector() - skyLL;
+            double skyAreaSq = skyDx.cross(skyDy).getSquaredNorm();
+            z[i][j] = _scaling * std::sqrt(skyAreaSq) / (side*side);
+        }
+    }
+    return z;
+}
+
 bool PixelAreaBoundedField::isPersistable() const noexcept {
     return _skyWcs->isPersistable();
 }
@@ -101,6 +101,18 @@ ndarray::Array<double, 1, 1> ProductBoundedField::evaluate(
     return z;
 }
 
+ndarray::Array<double, 2, 2> ProductBoundedField::evaluateGrid(
+    ndarray::Array<double const, 1> const& x,
+    ndarray::Array<double const, 1> const& y
+) const {
+    auto iter = _factors.begin();
+    ndarray::Array<double, 2, 2> z = (**iter).evaluateGrid(x, y);
+    for (++iter; iter != _factors.end(); ++iter) {
+        ndarray::asEigenArray(z) *= ndarray::asEigenArray((**iter).evaluateGrid(x, y));
+    }
+    return z;
+}
+
 // ------------------ persistence ---------------------------------------------------------------------------
 
 namespace {
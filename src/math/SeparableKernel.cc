@@ -48,8 +48,8 @@ SeparableKernel::SeparableKernel()
           _localRowList(0),
           _kernelX(0),
           _kernelY(0),
-          _kernelRowCache(0),
-          _kernelColCache(0) {
+          _kernelRowCache(),
+          _kernelColCache() {
     _setKernelXY();
 }
 
@@ -64,8 +64,8 @@ SeparableKernel::SeparableKernel(int width, int height, KernelFunction const& ke
           _localRowList(height),
           _kernelX(width),
           _kernelY(height),
-          _kernelRowCache(0),
-          _kernelColCache(0) {
+          _kernelRowCache(),
+          _kernelColCache() {
     _setKernelXY();
 }
 
@@ -79,8 +79,8 @@ SeparableKernel::SeparableKernel(int width, int height, KernelFunction const& ke
           _localRowList(height),
           _kernelX(width),
           _kernelY(height),
-          _kernelRowCache(0),
-          _kernelColCache(0) {
+          _kernelRowCache(),
+          _kernelColCache() {
     if (kernelColFunction.getNParameters() + kernelRowFunction.getNParameters() !=
         spatialFunctionList.size()) {
         std::ostringstream os;
@@ -95,7 +95,7 @@ SeparableKernel::SeparableKernel(int width, int height, KernelFunction const& ke
 }
 
 std::shared_ptr<Kernel> SeparableKernel::clone() const {
-    std::shared_ptr<Kernel> retPtr;
+    std::shared_ptr<SeparableKernel> retPtr;
     if (this->isSpatiallyVarying()) {
         retPtr.reset(new SeparableKernel(this->getWidth(), this->getHeight(), *(this->_kernelColFunctionPtr),
                                          *(this->_kernelRowFunctionPtr), this->_spatialFunctionList));
@@ -103,8 +103,7 @@ std::shared_ptr<Kernel> SeparableKernel::clone() const {
         retPtr.reset(new SeparableKernel(this->getWidth(), this->getHeight(), *(this->_kernelColFunctionPtr),
                                          *(this->_kernelRowFunctionPtr)));
     }
-    retPtr->setCtr(this->getCtr());
-    retPtr->computeCache(this->getCacheSize());
+    retPtr->copyCtrAndCache(*this);
     return retPtr;
 }
 
@@ -199,18 +198,18 @@ void SeparableKernel::setKernelParameter(unsigned int ind, double value) const {
 double SeparableKernel::basicComputeVectors(std::vector<Pixel>& colList, std::vector<Pixel>& rowList,
                                             bool doNormalize) const {
     double colSum = 0.0;
-    if (_kernelColCache.empty()) {
+    if (!_kernelColCache) {
         for (unsigned int i = 0; i != colList.size(); ++i) {
             double colFuncValue = (*_kernelColFunctionPtr)(_kernelX[i]);
             colList[i] = colFuncValue;
             colSum += colFuncValue;
         }
     } else {
-        int const cacheSize = _kernelColCache.size();
+        int const cacheSize = _kernelColCache->size();
 
         int const indx = this->getKernelParameter(0) * cacheSize;
 
-        std::vector<double>& cachedValues = _kernelColCache.at(indx);
+        std::vector<double> const& cachedValues = _kernelColCache->at(indx);
         for (unsigned int i = 0; i != colList.size(); ++i) {
             double colFuncValue = cachedValues[i];
             colList[i] = colFuncValue;
@@ -219,18 +218,18 @@ double SeparableKernel::basicComputeVectors(std::vector<Pixel>& colList, std::ve
     }
 
     double rowSum = 0.0;
-    if (_kernelRowCache.empty()) {
+    if (!_kernelRowCache) {
         for (unsigned int i = 0; i != rowList.size(); ++i) {
             double rowFuncValue = (*_kernelRowFunctionPtr)(_kernelY[i]);
             rowList[i] = rowFuncValue;
             rowSum += rowFuncValue;
         }
     } else {
-        int const cacheSize = _kernelRowCache.size();
+        int const cacheSize = _kernelRowCache->size();
 
         int const indx = this->getKernelParameter(1) * cacheSize;
 
-        std::vector<double>& cachedValues = _kernelRowCache.at(indx);
+        std::vector<double> const& cachedValues = _kernelRowCache->at(indx);
         for (unsigned int i = 0; i != rowList.size(); ++i) {
             double rowFuncValue = cachedValues[i];
             rowList[i] = rowFuncValue;
@@ -269,55 +268,39 @@ double SeparableKernel::basicComputeVectors(std::vector<Pixel>& colList, std::ve
 namespace {
 /**
  * @internal Compute a cache of pre-computed Kernels
+ *
+ * @returns the cache, or null if cacheSize <= 0
  */
-void _computeCache(int const cacheSize, std::vector<double> const& x,
-                   SeparableKernel::KernelFunctionPtr& func, std::vector<std::vector<double> >* kernelCache) {
+std::shared_ptr<std::vector<std::vector<double>> const> _computeCache(
+        int const cacheSize, std::vector<double> const& x, SeparableKernel::KernelFunctionPtr const& func) {
     if (cacheSize <= 0) {
-        kernelCache->erase(kernelCache->begin(), kernelCache->end());
-        return;
-    }
-
-    if (kernelCache[0].size() != x.size()) {  // invalid
-        kernelCache->erase(kernelCache->begin(), kernelCache->end());
-    }
-
-    int const old_cacheSize = kernelCache->size();
-
-    if (cacheSize == old_cacheSize) {
-        return;  // nothing to do
+        return nullptr;
     }
 
-    if (cacheSize < old_cacheSize) {
-        kernelCache->erase(kernelCache->begin() + cacheSize, kernelCache->end());
-    } else {
-        kernelCache->resize(cacheSize);
-        for (int i = old_cacheSize; i != cacheSize; ++i) {
-            (*kernelCache)[i].resize(x.size());
-        }
-    }
-    //
-    // Actually fill the cache
-    //
+    auto kernelCache = std::make_shared<std::vector<std::vector<double>>>(cacheSize,
+                                                                          std::vector<double>(x.size()));
     for (int i = 0; i != cacheSize; ++i) {
         func->setParameter(0, (i + 0.5) / static_cast<double>(cacheSize));
         for (unsigned int j = 0; j != x.size(); ++j) {
             (*kernelCache)[i][j] = (*func)(x[j]);
         }
     }
+    return kernelCache;
 }
 }  // namespace
 
 void SeparableKernel::computeCache(int const cacheSize) {
-    SeparableKernel::KernelFunctionPtr func;
+    _kernelColCache = _computeCache(cacheSize, _kernelY, getKernelColFunction());
+    _kernelRowCache = _computeCache(cacheSize, _kernelX, getKernelRowFunction());
+}
 
-    func = getKernelColFunction();
-    _computeCache(cacheSize, _kernelY, func, &_kernelColCache);
+int SeparableKernel::getCacheSize() const { return _kernelColCache ? _kernelColCache->size() : 0; };
 
-    func = getKernelRowFunction();
-    _computeCache(cacheSize, _kernelX, func, &_kernelRowCache);
+void SeparableKernel::copyCtrAndCache(SeparableKernel const& kernel) {
+    setCtr(kernel.getCtr());
+    _kernelColCache = kernel._kernelColCache;
+    _kernelRowCache = kernel._kernelRowCache;
 }
-
-int SeparableKernel::getCacheSize() const { return _kernelColCache.size(); };
 }  // namespace math
 }  // namespace afw
 }  // namespace lsst
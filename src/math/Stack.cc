@@ -26,14 +26,23 @@
  * Provide functions to stack images
  *
  */
-#include <vector>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <future>
+#include <limits>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "lsst/base.h"
 #include "lsst/pex/exceptions.h"
+#include "lsst/geom/Angle.h"
 #include "lsst/afw/math/Stack.h"
 #include "lsst/afw/math/MaskedVector.h"
+#include "lsst/afw/math/detail/Parallel.h"
+#include "lsst/afw/math/detail/PixelMoments.h"
+#include "lsst/afw/math/detail/Quantiles.h"
 
 namespace pexExcept = lsst::pex::exceptions;
 
@@ -103,51 +112,478 @@ void checkImageSizes(ImageT const &out, std::vector<std::shared_ptr<ImageT>> con
  *
  * ************************************************************************** */
 
-//@{
+/* ************************************************************************** *
+ *
+ * stack MaskedImages, a tile of columns at a time
+ *
+ * ************************************************************************** */
+
+double const NaN = std::numeric_limits<double>::quiet_NaN();
+double const MAX_DOUBLE = std::numeric_limits<double>::max();
+double const IQ_TO_STDEV = 0.741301109252802;  // 1 sigma in units of iqrange (assume Gaussian)
+
+int const STACK_TILE_WIDTH = 256;  // number of columns gathered from each input at a time
+
+/// @internal Return the variance of a variance, assuming a Gaussian; cf. Statistics.cc
+inline double varianceError(double const variance, int const n) {
+    return 2 * (n - 1) * variance * variance / static_cast<double>(n * n);
+}
+
+/// @internal The moments of one stack of pixels, as returned by processPixels() in Statistics.cc
+struct StackMoments {
+    int n;                    // number of pixels used
+    double sum;               // (weighted) sum
+    double mean;              // (weighted) mean
+    double meanVar;           // variance of the mean
+    double variance;          // debiased variance
+    double varVar;            // variance of the variance
+    double min;               // minimum value used
+    double max;               // maximum value used
+    image::MaskPixel orMask;  // OR of the masks of the pixels used, plus any propagated bits
+};
+
 /**
- * @internal A function to handle MaskedImage stacking
+ * @internal Stack MaskedImages without constructing a Statistics object for each output pixel
  *
- * A boolean template variable has been used to allow the compiler to generate the different instantiations
- *   to handle cases when we are, or are not, weighting
+ * A tile of each input row is gathered into structure-of-arrays scratch buffers laid out so that the
+ * inputs for each output pixel are contiguous; the statistic is then computed in place.  The arithmetic
+ * (including the crude-mean pass, the order in which values are summed, and the sequence of nth_element
+ * calls used for quantiles) is exactly that of Statistics, so the results are identical to those of
+ * the per-pixel code in computeMaskedImageStack.
  *
- * Additionally, we may or may not want to weight based on the variance -- another template boolean
+ * The scratch buffers are reused for every tile, so an instance must not be shared between threads.
  */
 template <typename PixelT, bool isWeighted, bool useVariance>
-void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
-                             std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> const &images,
-                             Property flags, StatisticsControl const &sctrl, image::MaskPixel const clipped,
-                             std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
-                             WeightVector const &wvector = WeightVector()) {
-    // get a list of row_begin iterators
-    typedef typename image::MaskedImage<PixelT>::x_iterator x_iterator;
-    std::vector<x_iterator> rows;
-    rows.reserve(images.size());
+class BatchedStacker {
+public:
+    typedef image::MaskedImage<PixelT> MaskedImageT;
 
-    MaskedVector<PixelT> pixelSet(images.size());  // a pixel from x,y for each image
-    WeightVector weights;                          // weights; non-const version
-    //
-    StatisticsControl sctrlTmp(sctrl);
+    BatchedStacker(std::vector<std::shared_ptr<MaskedImageT>> const &images, Property flags,
+                   StatisticsControl const &sctrl, image::MaskPixel const clipped,
+                   std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
+                   WeightVector const &wvector)
+            : _images(images),
+              _nInput(images.size()),
+              _prop(static_cast<Property>(flags & ~ERRORS)),
+              _flags(flags | NPOINT | ERRORS | NCLIPPED | NMASKED),
+              _sctrl(sctrl),
+              _clipped(clipped),
+              _maskMap(maskMap),
+              _wvector(wvector),
+              _needVariance(useVariance || sctrl.getCalcErrorFromInputVariance()),
+              _values(STACK_TILE_WIDTH * _nInput),
+              _masks(STACK_TILE_WIDTH * _nInput),
+              _variances(_needVariance ? STACK_TILE_WIDTH * _nInput : 0),
+              _weights(useVariance ? STACK_TILE_WIDTH * _nInput : 0),
+              _rejectedWeightsByBit(sctrl.getMaskPropagationThresholds().size()) {
+        _sorted.reserve(_nInput);
+    }
 
-    if (useVariance) {  // weight using the variance image
-        assert(isWeighted);
-        assert(wvector.empty());
+    /// Can we handle this request?  (Anything else is left to the per-pixel code)
+    static bool isSupported(Property flags) {
+        // ORMASK isn't retrievable from a Statistics, so let the per-pixel code raise the error
+        return (flags & ~ERRORS) != ORMASK;
+    }
 
-        weights.resize(images.size());
+    /// Stack rows [yBegin, yEnd) of the inputs into out
+    void stackRows(MaskedImageT &out, int const yBegin, int const yEnd) {
+        int const width = out.getWidth();
+        for (int y = yBegin; y < yEnd; ++y) {
+            for (int x0 = 0; x0 < width; x0 += STACK_TILE_WIDTH) {
+                int const nx = std::min(STACK_TILE_WIDTH, width - x0);
+                gather(y, x0, nx);
 
-        sctrlTmp.setWeighted(true);
-    } else if (isWeighted) {
-        weights.assign(wvector.begin(), wvector.end());
+                typename MaskedImageT::x_iterator ptr = out.row_begin(y) + x0;
+                for (int x = 0; x < nx; ++x, ++ptr) {
+                    evaluate(x * _nInput, ptr);
+                }
+            }
+        }
+    }
 
-        sctrlTmp.setWeighted(true);
+private:
+    /// Transpose columns [x0, x0 + nx) of row y of all the inputs into the scratch buffers
+    void gather(int const y, int const x0, int const nx) {
+        for (int i = 0; i < _nInput; ++i) {
+            typename MaskedImageT::x_iterator ptr = _images[i]->row_begin(y) + x0;
+            for (int x = 0, j = i; x < nx; ++x, ++ptr, j += _nInput) {
+                _values[j] = ptr.image();
+                _masks[j] = ptr.mask();
+                if (_needVariance) {
+                    _variances[j] = ptr.variance();
+                }
+                if (useVariance) {  // we're weighting using the variance
+                    _weights[j] = 1.0 / ptr.variance();
+                }
+            }
+        }
     }
-    assert(weights.empty() || weights.size() == images.size());
+
+    /**
+     * Accumulate the moments of the stack starting at offset; cf. processPixels() in Statistics.cc
+     *
+     * @param offset        index of the stack's first input in the scratch buffers
+     * @param checkFinite   reject NaNs and Infs?
+     * @param nCrude        number of points used to estimate meanCrude (0 if meanCrude is a clip center)
+     * @param meanCrude     crude estimate of the mean, or the center of the clip
+     * @param cliplimit     maximum distance from meanCrude (if doClip)
+     * @param propagate     propagate mask bits from rejected pixels?
+     */
+    template <bool doMinMax, bool doClip>
+    StackMoments accumulate(int const offset, bool const checkFinite, int const nCrude,
+                            double const meanCrude, double const cliplimit, bool const propagate) {
+        PixelT const *values = _values.data() + offset;
+        image::MaskPixel const *masks = _masks.data() + offset;
+        image::VariancePixel const *variances = _needVariance ? _variances.data() + offset : nullptr;
+        WeightPixel const *weights = useVariance ? _weights.data() + offset : _wvector.data();
+        int const andMask = _sctrl.getAndMask();
+        bool const calcErrorFromInputVariance = _sctrl.getCalcErrorFromInputVariance();
+        std::vector<double> const &maskPropagationThresholds = _sctrl.getMaskPropagationThresholds();
+        int const nBits = propagate ? maskPropagationThresholds.size() : 0;
+
+        if (!isWeighted && !calcErrorFromInputVariance) {  // Statistics uses a MomentAccumulator
+            if (checkFinite) {
+                return accumulateUnweighted<true, doMinMax, doClip>(values, masks, nCrude, meanCrude,
+                                                                    cliplimit, nBits);
+            } else {
+                return accumulateUnweighted<false, doMinMax, doClip>(values, masks, nCrude, meanCrude,
+                                                                     cliplimit, nBits);
+            }
+        }
+
+        int n = 0;
+        double sumw = 0.0;   // sum(weight)  (N.b. weight will be 1.0 if !isWeighted)
+        double sumw2 = 0.0;  // sum(weight^2)
+        double sumx = 0;     // sum(data*weight)
+        double sumx2 = 0;    // sum(data*weight^2)
+        double sumvw2 = 0.0;  // sum(variance*weight^2)
+        double min = (nCrude) ? meanCrude : MAX_DOUBLE;
+        double max = (nCrude) ? meanCrude : -MAX_DOUBLE;
+        image::MaskPixel orMask = 0x0;
+
+        std::fill(_rejectedWeightsByBit.begin(), _rejectedWeightsByBit.end(), 0.0);
+
+        for (int i = 0; i < _nInput; ++i) {
+            PixelT const value = values[i];
+            image::MaskPixel const mask = masks[i];
+            if ((!checkFinite || std::isfinite(static_cast<float>(value))) && !(mask & andMask) &&
+                (!doClip || std::fabs(value - meanCrude) <= cliplimit)) {
+                double const delta = (value - meanCrude);
+
+                if (isWeighted) {
+                    double const weight = weights[i];
+
+                    sumw += weight;
+                    sumw2 += weight * weight;
+                    sumx += weight * delta;
+                    sumx2 += weight * delta * delta;
+
+                    if (calcErrorFromInputVariance) {
+                        double const var = variances[i];
+                        sumvw2 += var * weight * weight;
+                    }
+                } else {
+                    sumx += delta;
+                    sumx2 += delta * delta;
+
+                    if (calcErrorFromInputVariance) {
+                        double const var = variances[i];
+                        sumvw2 += var;
+                    }
+                }
+
+                orMask |= mask;
+
+                if (doMinMax) {
+                    if (static_cast<double>(value) < min) {
+                        min = value;
+                    }
+                    if (static_cast<double>(value) > max) {
+                        max = value;
+                    }
+                }
+                n++;
+            } else {  // pixel has been clipped, rejected, etc.
+                for (int bit = 0; bit < nBits; ++bit) {
+                    if (mask & (1 << bit)) {
+                        _rejectedWeightsByBit[bit] += isWeighted ? static_cast<double>(weights[i]) : 1.0;
+                    }
+                }
+            }
+        }
+        if (n == 0) {
+            min = NaN;
+            max = NaN;
+        }
+
+        if (!isWeighted) {
+            sumw = sumw2 = n;
+        }
+
+        return makeMoments(n, sumw, sumw2, sumx, sumx2, sumvw2, min, max, orMask, meanCrude, nBits);
+    }
+
+    /// The unweighted version of accumulate, using the same MomentAccumulator as Statistics
+    template <bool checkFinite, bool doMinMax, bool doClip>
+    StackMoments accumulateUnweighted(PixelT const *values, image::MaskPixel const *masks, int const nCrude,
+                                      double const meanCrude, double const cliplimit, int const nBits) {
+        detail::MomentAccumulator accumulator(meanCrude, cliplimit, _sctrl.getAndMask(),
+                                              (nCrude) ? meanCrude : MAX_DOUBLE,
+                                              (nCrude) ? meanCrude : -MAX_DOUBLE);
+        accumulator.accumulate<checkFinite, doClip, doMinMax>(values, masks, _nInput);
+
+        if (nBits > 0) {  // nBits is either 0 or _rejectedWeightsByBit.size()
+            std::fill(_rejectedWeightsByBit.begin(), _rejectedWeightsByBit.end(), 0.0);
+            accumulator.countRejected<checkFinite, doClip>(values, masks, _nInput, _rejectedWeightsByBit);
+        }
+
+        int const n = accumulator.getN();
+        double min = accumulator.getMin();
+        double max = accumulator.getMax();
+        if (n == 0) {
+            min = NaN;
+            max = NaN;
+        }
+        return makeMoments(n, n, n, accumulator.getSum(), accumulator.getSumSq(), 0.0, min, max,
+                           accumulator.getOrMask(), meanCrude, nBits);
+    }
+
+    /// Convert the sums accumulated by accumulate into moments; cf. makeStandardReturn() in Statistics.cc
+    StackMoments makeMoments(int const n, double const sumw, double const sumw2, double const sumx,
+                             double const sumx2, double const sumvw2, double const min, double const max,
+                             image::MaskPixel orMask, double const meanCrude, int const nBits) {
+        std::vector<double> const &maskPropagationThresholds = _sctrl.getMaskPropagationThresholds();
+        for (int bit = 0; bit < nBits; ++bit) {
+            double hypotheticalTotalWeight = sumw + _rejectedWeightsByBit[bit];
+            _rejectedWeightsByBit[bit] /= hypotheticalTotalWeight;
+            if (_rejectedWeightsByBit[bit] > maskPropagationThresholds[bit]) {
+                orMask |= (1 << bit);
+            }
+        }
+
+        StackMoments moments;
+        moments.n = n;
+        moments.mean = sumx / sumw;
+        moments.variance = sumx2 / sumw - ::pow(moments.mean, 2);         // biased estimator
+        moments.variance *= sumw * sumw / (sumw * sumw - sumw2);          // debias
+        moments.meanVar = _sctrl.getCalcErrorFromInputVariance() ? sumvw2 / (sumw * sumw)
+                                                                 : moments.variance * sumw2 / (sumw * sumw);
+        moments.varVar = varianceError(moments.variance, n);
+        moments.sum = sumx + sumw * meanCrude;
+        moments.mean += meanCrude;
+        moments.min = min;
+        moments.max = max;
+        moments.orMask = orMask;
+        return moments;
+    }
+
+    /// Compute the statistic for the stack starting at offset, and write it to *ptr
+    void evaluate(int const offset, typename MaskedImageT::x_iterator ptr) {
+        bool const nanSafe = _sctrl.getNanSafe();
+        bool const doMinMax = _flags & (MIN | MAX);
+
+        // a crude estimate of the mean, used for numerical stability of variance
+        StackMoments const crude = accumulate<false, false>(offset, nanSafe, 0, 0.0, -1, false);
+        double meanCrude = 0.0;
+        if (crude.n > 0) {
+            meanCrude = crude.sum / crude.n;
+        }
+        // the full precision moments using that crude mean
+        StackMoments const standard =
+                doMinMax ? accumulate<true, false>(offset, true, crude.n, meanCrude, -1, true)
+                         : accumulate<false, false>(offset, nanSafe, crude.n, meanCrude, -1, true);
+        int const n = standard.n;
+
+        double median = NaN;
+        double iqrange = NaN;
+        Statistics::Value meanclip(NaN, NaN);
+        Statistics::Value varianceclip(NaN, NaN);
+        int nClipped = 0;
+        if (_flags & (MEDIAN | IQRANGE | MEANCLIP | STDEVCLIP | VARIANCECLIP)) {
+            int const andMask = _sctrl.getAndMask();
+            _sorted.clear();
+            for (int i = offset, end = offset + _nInput; i < end; ++i) {
+                if ((!nanSafe || std::isfinite(static_cast<float>(_values[i]))) && !(_masks[i] & andMask)) {
+                    _sorted.push_back(_values[i]);
+                }
+            }
+
+            if (_prop == MEDIAN) {
+                median = detail::percentile(_sorted, 0.5);
+            } else {
+                detail::MedianQuartileReturn mq = detail::medianAndQuartiles(_sorted);
+                median = std::get<0>(mq);
+                iqrange = std::get<2>(mq) - std::get<1>(mq);
+            }
+
+            if (_flags & (MEANCLIP | STDEVCLIP | VARIANCECLIP)) {
+                for (int i_i = 0; i_i < _sctrl.getNumIter(); ++i_i) {
+                    double const center = (i_i > 0) ? meanclip.first : median;
+                    double const hwidth = (i_i > 0 && n > 1)
+                                                  ? _sctrl.getNumSigmaClip() * std::sqrt(varianceclip.first)
+                                                  : _sctrl.getNumSigmaClip() * IQ_TO_STDEV * iqrange;
+                    int nClip = 0;
+                    double varClip = NaN;
+                    if (std::isnan(center) || std::isnan(hwidth)) {
+                        meanclip = Statistics::Value(NaN, NaN);
+                    } else {
+                        StackMoments const clip = accumulate<false, true>(offset, doMinMax || nanSafe, 0,
+                                                                          center, hwidth, false);
+                        nClip = clip.n;
+                        meanclip = Statistics::Value(clip.mean, clip.meanVar);
+                        varClip = clip.variance;
+                    }
+                    nClipped = n - nClip;
+                    varianceclip = Statistics::Value(varClip, varianceError(varClip, nClip));
+                }
+            }
+        }
+
+        // extract the requested value and its error; cf. Statistics::getResult
+        double value = NaN;
+        double error = NaN;
+        switch (_prop) {
+            case NPOINT:
+                value = n;
+                error = 0;
+                break;
+            case NCLIPPED:
+                value = nClipped;
+                error = 0;
+                break;
+            case NMASKED:
+                value = _nInput - n;
+                error = 0;
+                break;
+            case SUM:
+                value = standard.sum;
+                error = 0;
+                break;
+            case MEAN:
+                value = standard.mean;
+                error = ::sqrt(standard.meanVar);
+                break;
+            case MEANCLIP:
+                value = meanclip.first;
+                error = ::sqrt(meanclip.second);
+                break;
+            case VARIANCE:
+                value = standard.variance;
+                error = ::sqrt(standard.varVar);
+                break;
+            case STDEV:
+                value = std::sqrt(standard.variance);
+                error = 0.5 * ::sqrt(standard.varVar) / value;
+                break;
+            case VARIANCECLIP:
+                value = varianceclip.first;
+                break;
+            case STDEVCLIP:
+                value = std::sqrt(varianceclip.first);
+                error = 0.5 * ::sqrt(varianceclip.second) / value;
+                break;
+            case MEANSQUARE:
+                value = (n - 1) / static_cast<double>(n) * standard.variance + ::pow(standard.mean, 2);
+                error = ::sqrt(2 * ::pow(value / n, 2));  // assumes Gaussian
+                break;
+            case MIN:
+                value = standard.min;
+                error = 0;
+                break;
+            case MAX:
+                value = standard.max;
+                error = 0;
+                break;
+            case MEDIAN:
+                value = median;
+                error = std::sqrt(lsst::geom::HALFPI * standard.variance / n);  // assumes Gaussian
+                break;
+            case IQRANGE:
+                value = iqrange;
+                break;
+            default:  // excluded by isSupported()
+                assert(false);
+        }
+
+        PixelT variance = ::pow(error, 2);
+        image::MaskPixel msk(standard.orMask);
+        if (n == 0) {
+            msk = _sctrl.getNoGoodPixelsMask();
+        }
+        // Check to see if any pixels were rejected due to clipping
+        if (nClipped > 0) {
+            msk |= _clipped;
+        }
+        // Check to see if any pixels were rejected by masking, and apply
+        // any associated masks to the result.
+        if (_nInput - n > 0) {
+            image::MaskPixel anyMask = 0x0;
+            for (int i = offset, end = offset + _nInput; i < end; ++i) {
+                anyMask |= _masks[i];
+            }
+            for (auto const &pair : _maskMap) {
+                if (anyMask & pair.first) {
+                    msk |= pair.second;
+                }
+            }
+        }
+
+        *ptr = typename MaskedImageT::Pixel(value, msk, variance);
+    }
+
+    std::vector<std::shared_ptr<MaskedImageT>> const &_images;
+    int const _nInput;
+    Property const _prop;  // the requested statistic
+    int const _flags;      // everything that we need to calculate
+    StatisticsControl const &_sctrl;
+    image::MaskPixel const _clipped;
+    std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &_maskMap;
+    WeightVector const &_wvector;
+    bool const _needVariance;
+
+    // scratch space, indexed by [x*_nInput + input]
+    std::vector<PixelT> _values;
+    std::vector<image::MaskPixel> _masks;
+    std::vector<image::VariancePixel> _variances;
+    std::vector<WeightPixel> _weights;
+    // scratch space for a single stack
+    std::vector<PixelT> _sorted;
+    std::vector<double> _rejectedWeightsByBit;
+};
+
+/**
+ * @internal Stack rows [yBegin, yEnd) of some MaskedImages, one output pixel at a time
+ *
+ * @param[out] imgStack  output MaskedImage
+ * @param[in] images     MaskedImages to process
+ * @param[in] flags      statistic requested
+ * @param[in] sctrl      control structure, with the weighting already set
+ * @param[in] clipped    bitmask to set if any input was clipped
+ * @param[in] maskMap    mask bits to set if any input was masked
+ * @param[in] wvector    weights (if isWeighted but not useVariance)
+ * @param[in] yBegin     first row to process
+ * @param[in] yEnd       one past the last row to process
+ */
+template <typename PixelT, bool isWeighted, bool useVariance>
+void stackMaskedImageRows(image::MaskedImage<PixelT> &imgStack,
+                          std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> const &images,
+                          Property flags, StatisticsControl const &sctrl, image::MaskPixel const clipped,
+                          std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
+                          WeightVector const &wvector, int const yBegin, int const yEnd) {
+    // get a list of row_begin iterators
+    typedef typename image::MaskedImage<PixelT>::x_iterator x_iterator;
+    std::vector<x_iterator> rows;
+    rows.reserve(images.size());
+
+    MaskedVector<PixelT> pixelSet(images.size());  // a pixel from x,y for each image
+    WeightVector weights(wvector);                 // weights; non-const version
 
     // loop over x,y ... the loop over the stack to fill pixelSet
     // - get the stats on pixelSet and put the value in the output image at x,y
-    for (int y = 0; y != imgStack.getHeight(); ++y) {
+    for (int y = yBegin; y != yEnd; ++y) {
         for (unsigned int i = 0; i < images.size(); ++i) {
             x_iterator ptr = images[i]->row_begin(y);
-            if (y == 0) {
+            if (y == yBegin) {
                 rows.push_back(ptr);
             } else {
                 rows[i] = ptr;
@@ -165,14 +601,14 @@ void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
             }
 
             Property const eflags = static_cast<Property>(flags | NPOINT | ERRORS | NCLIPPED | NMASKED);
-            Statistics stat = isWeighted ? makeStatistics(pixelSet, weights, eflags, sctrlTmp)
-                                         : makeStatistics(pixelSet, eflags, sctrlTmp);
+            Statistics stat = isWeighted ? makeStatistics(pixelSet, weights, eflags, sctrl)
+                                         : makeStatistics(pixelSet, eflags, sctrl);
 
             PixelT variance = ::pow(stat.getError(flags), 2);
             image::MaskPixel msk(stat.getOrMask());
             int const npoint = stat.getValue(NPOINT);
             if (npoint == 0) {
-                msk = sctrlTmp.getNoGoodPixelsMask();
+                msk = sctrl.getNoGoodPixelsMask();
             } else if (npoint == 1) {
                 /*
                  * you should be using sctrl.setCalcErrorFromInputVariance(true) if you want to avoid
@@ -200,6 +636,58 @@ void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
         }
     }
 }
+
+//@{
+/**
+ * @internal A function to handle MaskedImage stacking
+ *
+ * A boolean template variable has been used to allow the compiler to generate the different instantiations
+ *   to handle cases when we are, or are not, weighting
+ *
+ * Additionally, we may or may not want to weight based on the variance -- another template boolean
+ *
+ * The rows are split into bands which are processed in parallel (see StatisticsControl::getNumThreads);
+ * each band has its own scratch space, and each output pixel depends only on the corresponding input
+ * pixels, so the result doesn't depend on the number of threads.
+ */
+template <typename PixelT, bool isWeighted, bool useVariance>
+void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
+                             std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> const &images,
+                             Property flags, StatisticsControl const &sctrl, image::MaskPixel const clipped,
+                             std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
+                             WeightVector const &wvector = WeightVector()) {
+    WeightVector weights;  // weights for each image; filled per pixel if useVariance
+    //
+    StatisticsControl sctrlTmp(sctrl);
+
+    if (useVariance) {  // weight using the variance image
+        assert(isWeighted);
+        assert(wvector.empty());
+
+        weights.resize(images.size());
+
+        sctrlTmp.setWeighted(true);
+    } else if (isWeighted) {
+        weights.assign(wvector.begin(), wvector.end());
+
+        sctrlTmp.setWeighted(true);
+    }
+    assert(weights.empty() || weights.size() == images.size());
+
+    bool const batched =
+            sctrlTmp.getBatchedStack() && BatchedStacker<PixelT, isWeighted, useVariance>::isSupported(flags);
+
+    detail::parallelFor(0, imgStack.getHeight(), sctrlTmp.getNumThreads(), [&](int yBegin, int yEnd) {
+        if (batched) {
+            BatchedStacker<PixelT, isWeighted, useVariance> stacker(images, flags, sctrlTmp, clipped, maskMap,
+                                                                    weights);
+            stacker.stackRows(imgStack, yBegin, yEnd);
+        } else {
+            stackMaskedImageRows<PixelT, isWeighted, useVariance>(imgStack, images, flags, sctrlTmp, clipped,
+                                                                  maskMap, weights, yBegin, yEnd);
+        }
+    });
+}
 template <typename PixelT, bool isWeighted, bool useVariance>
 void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
                              std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> const &images,
@@ -286,6 +774,157 @@ void statisticsStack(image::MaskedImage<PixelT> &out,
     }
 }
 
+namespace {
+/* ************************************************************************** *
+ *
+ * stack MaskedImages read from FITS files, a strip of rows at a time
+ *
+ * ************************************************************************** */
+
+/// @internal Read a subimage of the MaskedImage from a reader
+template <typename PixelT>
+image::MaskedImage<PixelT> readMaskedImage(image::MaskedImageFitsReader &reader,
+                                           lsst::geom::Box2I const &bbox) {
+    return reader.read<PixelT>(bbox, image::LOCAL);
+}
+
+template <typename PixelT>
+image::MaskedImage<PixelT> readMaskedImage(image::ExposureFitsReader &reader, lsst::geom::Box2I const &bbox) {
+    return reader.readMaskedImage<PixelT>(bbox, image::LOCAL);
+}
+
+/**
+ * @internal Stack the MaskedImages returned by a set of readers, stripHeight rows at a time
+ *
+ * While one strip is being stacked the next is read on another thread; the readers are only ever used
+ * by one thread at a time.  Each strip is stacked by the in-memory statisticsStack.
+ */
+template <typename PixelT, typename ReaderT>
+void computeStreamedMaskedImageStack(image::MaskedImage<PixelT> &out,
+                                     std::vector<std::shared_ptr<ReaderT>> const &readers, Property flags,
+                                     StatisticsControl const &sctrl, WeightVector const &wvector,
+                                     image::MaskPixel clipped,
+                                     std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const
+                                             &maskMap,
+                                     int stripHeight) {
+    checkObjectsAndWeights(readers, wvector);
+    checkOnlyOneFlag(flags);
+    if (stripHeight <= 0) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                          str(boost::format("stripHeight must be positive: %d") % stripHeight));
+    }
+
+    lsst::geom::Extent2I const dim = out.getDimensions();
+    for (unsigned int i = 0; i < readers.size(); ++i) {
+        lsst::geom::Extent2I const inputDim = readers[i]->readBBox(image::LOCAL).getDimensions();
+        if (inputDim != dim) {
+            throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                              (boost::format("Bad dimensions for image %d (%s): %dx%d vs %dx%d") % i %
+                               readers[i]->getFileName() % inputDim.getX() % inputDim.getY() % dim.getX() %
+                               dim.getY())
+                                      .str());
+        }
+    }
+    if (dim.getX() == 0 || dim.getY() == 0) {
+        return;  // an empty bbox would mean "read the whole image"
+    }
+
+    typedef std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> StripList;
+    auto getStripBBox = [&dim, stripHeight](int y0) {
+        return lsst::geom::Box2I(lsst::geom::Point2I(0, y0),
+                                 lsst::geom::Extent2I(dim.getX(), std::min(stripHeight, dim.getY() - y0)));
+    };
+    auto readStrip = [&readers, &getStripBBox](int y0) {
+        lsst::geom::Box2I const bbox = getStripBBox(y0);
+        StripList strips;
+        strips.reserve(readers.size());
+        for (auto const &reader : readers) {
+            strips.push_back(
+                    std::make_shared<image::MaskedImage<PixelT>>(readMaskedImage<PixelT>(*reader, bbox)));
+        }
+        return strips;
+    };
+
+    std::future<StripList> nextStrip = std::async(std::launch::async, readStrip, 0);
+    for (int y0 = 0; y0 < dim.getY(); y0 += stripHeight) {
+        StripList strips = nextStrip.get();
+        if (y0 + stripHeight < dim.getY()) {
+            nextStrip = std::async(std::launch::async, readStrip, y0 + stripHeight);
+        }
+
+        image::MaskedImage<PixelT> outStrip(out, getStripBBox(y0), image::LOCAL);
+        statisticsStack(outStrip, strips, flags, sctrl, wvector, clipped, maskMap);
+    }
+}
+
+// The mask map used by the versions of statisticsStack taking an excuse mask
+std::vector<std::pair<image::MaskPixel, image::MaskPixel>> makeExcuseMaskMap(StatisticsControl const &sctrl,
+                                                                              image::MaskPixel clipped,
+                                                                              image::MaskPixel excuse) {
+    return {std::make_pair(sctrl.getAndMask() & ~excuse, clipped)};
+}
+
+}  // end anonymous namespace
+
+template <typename PixelT>
+void statisticsStack(image::MaskedImage<PixelT> &out,
+                     std::vector<std::shared_ptr<image::MaskedImageFitsReader>> const &readers,
+                     Property flags, StatisticsControl const &sctrl, WeightVector const &wvector,
+                     image::MaskPixel clipped,
+                     std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
+                     int stripHeight) {
+    computeStreamedMaskedImageStack(out, readers, flags, sctrl, wvector, clipped, maskMap, stripHeight);
+}
+
+template <typename PixelT>
+void statisticsStack(image::MaskedImage<PixelT> &out,
+                     std::vector<std::shared_ptr<image::ExposureFitsReader>> const &readers, Property flags,
+                     StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel clipped,
+                     std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
+                     int stripHeight) {
+    computeStreamedMaskedImageStack(out, readers, flags, sctrl, wvector, clipped, maskMap, stripHeight);
+}
+
+template <typename PixelT>
+void statisticsStack(image::MaskedImage<PixelT> &out, std::vector<std::string> const &fileNames,
+                     Property flags, StatisticsControl const &sctrl, WeightVector const &wvector,
+                     image::MaskPixel clipped,
+                     std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
+                     int stripHeight) {
+    std::vector<std::shared_ptr<image::MaskedImageFitsReader>> readers;
+    readers.reserve(fileNames.size());
+    for (auto const &fileName : fileNames) {
+        readers.push_back(std::make_shared<image::MaskedImageFitsReader>(fileName));
+    }
+    computeStreamedMaskedImageStack(out, readers, flags, sctrl, wvector, clipped, maskMap, stripHeight);
+}
+
+template <typename PixelT>
+void statisticsStack(image::MaskedImage<PixelT> &out,
+                     std::vector<std::shared_ptr<image::MaskedImageFitsReader>> const &readers,
+                     Property flags, StatisticsControl const &sctrl, WeightVector const &wvector,
+                     image::MaskPixel clipped, image::MaskPixel excuse, int stripHeight) {
+    statisticsStack(out, readers, flags, sctrl, wvector, clipped, makeExcuseMaskMap(sctrl, clipped, excuse),
+                    stripHeight);
+}
+
+template <typename PixelT>
+void statisticsStack(image::MaskedImage<PixelT> &out,
+                     std::vector<std::shared_ptr<image::ExposureFitsReader>> const &readers, Property flags,
+                     StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel clipped,
+                     image::MaskPixel excuse, int stripHeight) {
+    statisticsStack(out, readers, flags, sctrl, wvector, clipped, makeExcuseMaskMap(sctrl, clipped, excuse),
+                    stripHeight);
+}
+
+template <typename PixelT>
+void statisticsStack(image::MaskedImage<PixelT> &out, std::vector<std::string> const &fileNames,
+                     Property flags, StatisticsControl const &sctrl, WeightVector const &wvector,
+                     image::MaskPixel clipped, image::MaskPixel excuse, int stripHeight) {
+    statisticsStack(out, fileNames, flags, sctrl, wvector, clipped, makeExcuseMaskMap(sctrl, clipped, excuse),
+                    stripHeight);
+}
+
 namespace {
 /* ************************************************************************** *
  *
@@ -306,30 +945,30 @@ template <typename PixelT, bool isWeighted>
 void computeImageStack(image::Image<PixelT> &imgStack,
                        std::vector<std::shared_ptr<image::Image<PixelT>>> &images, Property flags,
                        StatisticsControl const &sctrl, WeightVector const &weights = WeightVector()) {
-    MaskedVector<PixelT> pixelSet(images.size());  // a pixel from x,y for each image
     StatisticsControl sctrlTmp(sctrl);
 
-    // set the mask to be an infinite iterator
-    MaskImposter<image::MaskPixel> msk;
-
     if (!weights.empty()) {
         sctrlTmp.setWeighted(true);
     }
 
-    // get the desired statistic
-    for (int y = 0; y != imgStack.getHeight(); ++y) {
-        for (int x = 0; x != imgStack.getWidth(); ++x) {
-            for (unsigned int i = 0; i != images.size(); ++i) {
-                (*pixelSet.getImage())(i, 0) = (*images[i])(x, y);
-            }
+    // get the desired statistic, processing bands of rows in parallel
+    detail::parallelFor(0, imgStack.getHeight(), sctrlTmp.getNumThreads(), [&](int yBegin, int yEnd) {
+        MaskedVector<PixelT> pixelSet(images.size());  // a pixel from x,y for each image
 
-            if (isWeighted) {
-                imgStack(x, y) = makeStatistics(pixelSet, weights, flags, sctrlTmp).getValue();
-            } else {
-                imgStack(x, y) = makeStatistics(pixelSet, weights, flags, sctrlTmp).getValue();
+        for (int y = yBegin; y != yEnd; ++y) {
+            for (int x = 0; x != imgStack.getWidth(); ++x) {
+                for (unsigned int i = 0; i != images.size(); ++i) {
+                    (*pixelSet.getImage())(i, 0) = (*images[i])(x, y);
+                }
+
+                if (isWeighted) {
+                    imgStack(x, y) = makeStatistics(pixelSet, weights, flags, sctrlTmp).getValue();
+                } else {
+                    imgStack(x, y) = makeStatistics(pixelSet, weights, flags, sctrlTmp).getValue();
+                }
             }
         }
-    }
+    });
 }
 
 }  // end anonymous namespace
@@ -546,6 +1185,34 @@ std::shared_ptr<image::MaskedImage<PixelT>> statisticsStack(image::MaskedImage<P
             image::MaskedImage<TYPE> & out, std::vector<std::shared_ptr<image::MaskedImage<TYPE>>> & images, \
             Property flags, StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel,   \
             std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &);                             \
+    template void statisticsStack<TYPE>(                                                                     \
+            image::MaskedImage<TYPE> & out,                                                                  \
+            std::vector<std::shared_ptr<image::MaskedImageFitsReader>> const &readers, Property flags,       \
+            StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel,                   \
+            std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &, int);                        \
+    template void statisticsStack<TYPE>(                                                                     \
+            image::MaskedImage<TYPE> & out,                                                                  \
+            std::vector<std::shared_ptr<image::ExposureFitsReader>> const &readers, Property flags,          \
+            StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel,                   \
+            std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &, int);                        \
+    template void statisticsStack<TYPE>(                                                                     \
+            image::MaskedImage<TYPE> & out, std::vector<std::string> const &fileNames, Property flags,       \
+            StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel,                   \
+            std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &, int);                        \
+    template void statisticsStack<TYPE>(                                                                     \
+            image::MaskedImage<TYPE> & out,                                                                  \
+            std::vector<std::shared_ptr<image::MaskedImageFitsReader>> const &readers, Property flags,       \
+            StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel, image::MaskPixel, \
+            int);                                                                                            \
+    template void statisticsStack<TYPE>(                                                                     \
+            image::MaskedImage<TYPE> & out,                                                                  \
+            std::vector<std::shared_ptr<image::ExposureFitsReader>> const &readers, Property flags,          \
+            StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel, image::MaskPixel, \
+            int);                                                                                            \
+    template void statisticsStack<TYPE>(                                                                     \
+            image::MaskedImage<TYPE> & out, std::vector<std::string> const &fileNames, Property flags,       \
+            StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel, image::MaskPixel, \
+            int);                                                                                            \
     template std::vector<TYPE> statisticsStack<TYPE>(                                       \
             std::vector<std::vector<TYPE>> & vectors, Property flags,                       \
             StatisticsControl const &sctrl, WeightVector const &wvector);                                    \
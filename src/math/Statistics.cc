@@ -25,6 +25,7 @@
 /*
  * Support statistical operations on images
  */
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
@@ -33,10 +34,13 @@
 #include <memory>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/math/detail/PixelMoments.h"
+#include "lsst/afw/math/detail/Quantiles.h"
 #include "lsst/geom/Angle.h"
 
 using namespace std;
@@ -148,6 +152,71 @@ typedef std::tuple<int,                // n
                    >
         StandardReturn;
 
+/**
+ * @internal Convert the sums accumulated by processPixels into the standard statistics
+ *
+ * @param useWeights  were the pixels weighted?  If not, sumw and sumw2 are ignored
+ * @param n           number of pixels used
+ * @param sumw        sum(weight)
+ * @param sumw2       sum(weight^2)
+ * @param sumx        sum((data - meanCrude)*weight)
+ * @param sumx2       sum((data - meanCrude)^2*weight)
+ * @param sumvw2      sum(variance*weight^2)
+ * @param min         minimum value used
+ * @param max         maximum value used
+ * @param allPixelOrMask  OR of the masks of the pixels used
+ * @param rejectedWeightsByBit  sum of the weights of rejected pixels with each mask bit set; modified
+ * @param meanCrude   the value subtracted from the data before summing
+ * @param calcErrorFromInputVariance estimate errors from variance
+ * @param maskPropagationThresholds
+ */
+StandardReturn makeStandardReturn(bool const useWeights, int const n, double sumw, double sumw2, double sumx,
+                                  double const sumx2, double const sumvw2, double min, double max,
+                                  image::MaskPixel allPixelOrMask, std::vector<double> &rejectedWeightsByBit,
+                                  double const meanCrude, bool const calcErrorFromInputVariance,
+                                  std::vector<double> const &maskPropagationThresholds) {
+    if (n == 0) {
+        min = NaN;
+        max = NaN;
+    }
+
+    // estimate of population mean and variance.
+    double mean, variance;
+    if (!useWeights) {
+        sumw = sumw2 = n;
+    }
+
+    for (int bit = 0, nBits = maskPropagationThresholds.size(); bit < nBits; ++bit) {
+        double hypotheticalTotalWeight = sumw + rejectedWeightsByBit[bit];
+        rejectedWeightsByBit[bit] /= hypotheticalTotalWeight;
+        if (rejectedWeightsByBit[bit] > maskPropagationThresholds[bit]) {
+            allPixelOrMask |= (1 << bit);
+        }
+    }
+
+    // N.b. if sumw == 0 or sumw*sumw == sumw2 (e.g. n == 1) we'll get NaNs
+    // N.b. the estimator of the variance assumes that the sample points all have the same variance;
+    // otherwise, what is it that we're estimating?
+    mean = sumx / sumw;
+    variance = sumx2 / sumw - ::pow(mean, 2);         // biased estimator
+    variance *= sumw * sumw / (sumw * sumw - sumw2);  // debias
+
+    double meanVar;  // (standard error of mean)^2
+    if (calcErrorFromInputVariance) {
+        meanVar = sumvw2 / (sumw * sumw);
+    } else {
+        meanVar = variance * sumw2 / (sumw * sumw);
+    }
+
+    double varVar = varianceError(variance, n);  // error in variance; incorrect if useWeights is true
+
+    sumx += sumw * meanCrude;
+    mean += meanCrude;
+
+    return StandardReturn(n, sumx, Statistics::Value(mean, meanVar), Statistics::Value(variance, varVar), min,
+                          max, allPixelOrMask);
+}
+
 /*
  * Functions which convert the booleans into calls to the proper templated types, one type per
  * recursion level
@@ -255,46 +324,127 @@ StandardReturn processPixels(ImageT const &img, MaskT const &msk, VarianceT cons
             }
         }
     }
-    if (n == 0) {
-        min = NaN;
-        max = NaN;
-    }
+    return makeStandardReturn(useWeights, n, sumw, sumw2, sumx, sumx2, sumvw2, min, max, allPixelOrMask,
+                              rejectedWeightsByBit, meanCrude, calcErrorFromInputVariance,
+                              maskPropagationThresholds);
+}
 
-    // estimate of population mean and variance.
-    double mean, variance;
-    if (!useWeights) {
-        sumw = sumw2 = n;
-    }
+/**
+ * @internal The unweighted equivalent of processPixels for images whose rows are contiguous arrays
+ *
+ * All the sums are accumulated in a single pass over each row by a detail::MomentAccumulator.
+ *
+ * @param width     number of pixels in each row
+ * @param height    number of rows
+ * @param getImageRow   callable returning a pointer to the first pixel of row y
+ * @param getMaskRow    callable returning a pointer to the first mask pixel of row y (or nullptr)
+ *
+ * The other arguments are as for processPixels (but there is no stride).
+ */
+template <typename IsFinite, typename HasValueLtMin, typename InClipRange, typename GetImageRow,
+          typename GetMaskRow>
+StandardReturn processContiguousPixels(int const width, int const height, GetImageRow const &getImageRow,
+                                       GetMaskRow const &getMaskRow, int const nCrude, double const meanCrude,
+                                       double const cliplimit, int const andMask,
+                                       std::vector<double> const &maskPropagationThresholds) {
+    bool const checkFinite = std::is_same<IsFinite, CheckFinite>::value;
+    bool const doMinMax = std::is_same<HasValueLtMin, CheckValueLtMin>::value;
+    bool const doClip = std::is_same<InClipRange, CheckClipRange>::value;
+
+    detail::MomentAccumulator moments(meanCrude, cliplimit, andMask, (nCrude) ? meanCrude : MAX_DOUBLE,
+                                      (nCrude) ? meanCrude : -MAX_DOUBLE);
+    std::vector<double> rejectedWeightsByBit(maskPropagationThresholds.size(), 0.0);
 
-    for (int bit = 0, nBits = maskPropagationThresholds.size(); bit < nBits; ++bit) {
-        double hypotheticalTotalWeight = sumw + rejectedWeightsByBit[bit];
-        rejectedWeightsByBit[bit] /= hypotheticalTotalWeight;
-        if (rejectedWeightsByBit[bit] > maskPropagationThresholds[bit]) {
-            allPixelOrMask |= (1 << bit);
-        }
+    for (int iY = 0; iY < height; ++iY) {
+        auto const values = getImageRow(iY);
+        image::MaskPixel const *masks = getMaskRow(iY);
+        moments.accumulate<checkFinite, doClip, doMinMax>(values, masks, width);
+        moments.countRejected<checkFinite, doClip>(values, masks, width, rejectedWeightsByBit);
     }
 
-    // N.b. if sumw == 0 or sumw*sumw == sumw2 (e.g. n == 1) we'll get NaNs
-    // N.b. the estimator of the variance assumes that the sample points all have the same variance;
-    // otherwise, what is it that we're estimating?
-    mean = sumx / sumw;
-    variance = sumx2 / sumw - ::pow(mean, 2);         // biased estimator
-    variance *= sumw * sumw / (sumw * sumw - sumw2);  // debias
+    // sumw, sumw2 and sumvw2 are unused as we're neither weighting nor using the input variance
+    return makeStandardReturn(false, moments.getN(), 0.0, 0.0, moments.getSum(), moments.getSumSq(), 0.0,
+                              moments.getMin(), moments.getMax(), moments.getOrMask(), rejectedWeightsByBit,
+                              meanCrude, false, maskPropagationThresholds);
+}
 
-    double meanVar;  // (standard error of mean)^2
+/**
+ * @internal Dispatch unweighted statistics to processPixels or, when possible, processContiguousPixels
+ *
+ * This is the general case, which always uses processPixels
+ */
+template <typename IsFinite, typename HasValueLtMin, typename HasValueGtMax, typename InClipRange,
+          typename ImageT, typename MaskT, typename VarianceT, typename WeightT>
+StandardReturn processUnweightedPixels(ImageT const &img, MaskT const &msk, VarianceT const &var,
+                                       WeightT const &weights, int const flags, int const nCrude,
+                                       double const meanCrude, double const cliplimit,
+                                       bool const weightsAreMultiplicative, int const andMask,
+                                       bool const calcErrorFromInputVariance,
+                                       std::vector<double> const &maskPropagationThresholds) {
+    return processPixels<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange, false>(
+            img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative, andMask,
+            calcErrorFromInputVariance, maskPropagationThresholds);
+}
+
+/// @internal Floating-point Images with a Mask
+template <typename IsFinite, typename HasValueLtMin, typename HasValueGtMax, typename InClipRange,
+          typename PixelT, typename VarianceT, typename WeightT>
+typename std::enable_if<std::is_floating_point<PixelT>::value, StandardReturn>::type processUnweightedPixels(
+        image::Image<PixelT> const &img, image::Mask<image::MaskPixel> const &msk, VarianceT const &var,
+        WeightT const &weights, int const flags, int const nCrude, double const meanCrude,
+        double const cliplimit, bool const weightsAreMultiplicative, int const andMask,
+        bool const calcErrorFromInputVariance, std::vector<double> const &maskPropagationThresholds) {
     if (calcErrorFromInputVariance) {
-        meanVar = sumvw2 / (sumw * sumw);
-    } else {
-        meanVar = variance * sumw2 / (sumw * sumw);
+        return processPixels<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange, false>(
+                img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative,
+                andMask, calcErrorFromInputVariance, maskPropagationThresholds);
     }
+    auto const imgArray = img.getArray();
+    auto const mskArray = msk.getArray();
+    return processContiguousPixels<IsFinite, HasValueLtMin, InClipRange>(
+            img.getWidth(), img.getHeight(), [&imgArray](int y) { return imgArray[y].getData(); },
+            [&mskArray](int y) { return mskArray[y].getData(); }, nCrude, meanCrude, cliplimit, andMask,
+            maskPropagationThresholds);
+}
 
-    double varVar = varianceError(variance, n);  // error in variance; incorrect if useWeights is true
-
-    sumx += sumw * meanCrude;
-    mean += meanCrude;
+/// @internal Floating-point Images without a Mask
+template <typename IsFinite, typename HasValueLtMin, typename HasValueGtMax, typename InClipRange,
+          typename PixelT, typename VarianceT, typename WeightT>
+typename std::enable_if<std::is_floating_point<PixelT>::value, StandardReturn>::type processUnweightedPixels(
+        image::Image<PixelT> const &img, MaskImposter<image::MaskPixel> const &msk, VarianceT const &var,
+        WeightT const &weights, int const flags, int const nCrude, double const meanCrude,
+        double const cliplimit, bool const weightsAreMultiplicative, int const andMask,
+        bool const calcErrorFromInputVariance, std::vector<double> const &maskPropagationThresholds) {
+    if (calcErrorFromInputVariance || *msk.row_begin(0) != 0x0) {
+        return processPixels<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange, false>(
+                img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative,
+                andMask, calcErrorFromInputVariance, maskPropagationThresholds);
+    }
+    auto const imgArray = img.getArray();
+    return processContiguousPixels<IsFinite, HasValueLtMin, InClipRange>(
+            img.getWidth(), img.getHeight(), [&imgArray](int y) { return imgArray[y].getData(); },
+            [](int) { return static_cast<image::MaskPixel const *>(nullptr); }, nCrude, meanCrude, cliplimit,
+            andMask, maskPropagationThresholds);
+}
 
-    return StandardReturn(n, sumx, Statistics::Value(mean, meanVar), Statistics::Value(variance, varVar), min,
-                          max, allPixelOrMask);
+/// @internal Floating-point std::vectors
+template <typename IsFinite, typename HasValueLtMin, typename HasValueGtMax, typename InClipRange,
+          typename PixelT, typename VarianceT, typename WeightT>
+typename std::enable_if<std::is_floating_point<PixelT>::value, StandardReturn>::type processUnweightedPixels(
+        ImageImposter<PixelT> const &img, MaskImposter<image::MaskPixel> const &msk, VarianceT const &var,
+        WeightT const &weights, int const flags, int const nCrude, double const meanCrude,
+        double const cliplimit, bool const weightsAreMultiplicative, int const andMask,
+        bool const calcErrorFromInputVariance, std::vector<double> const &maskPropagationThresholds) {
+    if (calcErrorFromInputVariance || *msk.row_begin(0) != 0x0 || img.empty()) {
+        return processPixels<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange, false>(
+                img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative,
+                andMask, calcErrorFromInputVariance, maskPropagationThresholds);
+    }
+    PixelT const *values = &*img.row_begin(0);
+    return processContiguousPixels<IsFinite, HasValueLtMin, InClipRange>(
+            img.getWidth(), 1, [values](int) { return values; },
+            [](int) { return static_cast<image::MaskPixel const *>(nullptr); }, nCrude, meanCrude, cliplimit,
+            andMask, maskPropagationThresholds);
 }
 
 template <typename IsFinite, typename HasValueLtMin, typename HasValueGtMax, typename InClipRange,
@@ -310,8 +460,8 @@ StandardReturn processPixels(ImageT const &img, MaskT const &msk, VarianceT cons
                 img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative,
                 andMask, calcErrorFromInputVariance, maskPropagationThresholds);
     } else {
-        return processPixels<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange, false>(
-                img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative,
+        return processUnweightedPixels<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange>(
+                img, msk, var, weights, flags, nCrude, meanCrude, cliplimit, weightsAreMultiplicative,
                 andMask, calcErrorFromInputVariance, maskPropagationThresholds);
     }
 }
@@ -448,252 +598,9 @@ StandardReturn getStandard(ImageT const &img, MaskT const &msk, VarianceT const
     }
 }
 
-/**
- * @internal A wrapper using the nth_element() built-in to compute percentiles for an image
- *
- * @param img       an afw::Image
- * @param fraction the desired percentile.
- *
- * Specialisation for non-integral types (where ties are not a problem)
- */
-template <typename Pixel>
-typename enable_if<!is_integral<Pixel>::value, double>::type 
-percentile(std::vector<Pixel> &img, double const fraction) {
-    assert(fraction >= 0.0 && fraction <= 1.0);
-
-    int const n = img.size();
-
-    if (n > 1) {
-        double const idx = fraction * (n - 1);
-
-        // interpolate linearly between the adjacent values
-        // For efficiency:
-        // - if we're asked for a fraction > 0.5,
-        //    we'll do the second partial sort on shorter (upper) portion
-        // - otherwise, the shorter portion will be the lower one, we'll partial-sort that.
-
-        int const q1 = static_cast<int>(idx);
-        int const q2 = q1 + 1;
-
-        auto mid1 = img.begin() + q1;
-        auto mid2 = img.begin() + q2;
-        if (fraction > 0.5) {
-            std::nth_element(img.begin(), mid1, img.end());
-            std::nth_element(mid1, mid2, img.end());
-        } else {
-            std::nth_element(img.begin(), mid2, img.end());
-            std::nth_element(img.begin(), mid1, mid2);
-        }
-
-        double val1 = static_cast<double>(*mid1);
-        double val2 = static_cast<double>(*mid2);
-        double w1 = (static_cast<double>(q2) - idx);
-        double w2 = (idx - static_cast<double>(q1));
-        return w1 * val1 + w2 * val2;
-
-    } else if (n == 1) {
-        return img[0];
-    } else {
-        return NaN;
-    }
-}
-
-namespace {
-    //
-    // Helper function to estimate a floating-point quantile from integer data
-    //
-    // The data has been partially sorted, using nth_element
-    //
-    // begin:   iterator to a point which we know to be below our median
-    // end:     iterator to a point which we know to be beyond our median
-    // naive:   the integer value of the desired quantile
-    // target:  the number of points that should be to the left of the quantile.
-    //          N.b. if begin isn't the start of the data, this may not be the
-    //          desired number of points.  Caveat Callor
-    template<typename T>
-    double
-    computeQuantile(typename std::vector<T>::const_iterator begin,
-                    typename std::vector<T>::const_iterator end,
-                    T const naive,
-                    double const target
-                   )
-    {
-        // investigate the cumulative histogram near naive
-        std::size_t left = 0;           // number of values less than naive
-        std::size_t middle = 0;         // number of values equal to naive
-
-        for (auto ptr = begin; ptr != end; ++ptr) {
-            auto const val = *ptr;
-            if (val < naive) {
-                ++left;
-            } else if (val == naive) {
-                ++middle;
-            }
-        }
-
-        return naive - 0.5 + (target - left)/middle;
-    }
-
-    /**
-     * A wrapper using the nth_element() built-in to compute percentiles for a vector
-     *
-     * @param img       an afw::Image
-     * @param fraction the desired percentile.
-     *
-     * This is the specialisation for integral types where we have to handle ties carefully.
-     */
-    template <typename Pixel>
-    typename enable_if<is_integral<Pixel>::value, double>::type 
-    percentile(std::vector<Pixel> &img, double const fraction) {
-        assert(fraction >= 0.0 && fraction <= 1.0);
-
-        auto const n = img.size();
-
-        if (n == 0) {
-            return NaN;
-        } else if (n == 1) {
-            return img[0];
-        } else {
-            // We need to handle ties.  The proper way to do this is to analyse the cumulative curve after
-            // building the histograms (which is faster than a generic partitioning algorithm), but it's a
-            // nuisance as we don't know the range of values
-            //
-            // This code looks clean enough, but actually the call to nth_element is expensive
-            // and we *still* have to go through the array a second time
-
-            double const idx = fraction*(n - 1);
-
-            auto midP = img.begin() + static_cast<int>(idx);
-            std::nth_element(img.begin(), midP, img.end());
-            auto const naiveP = *midP;           // value of desired element
-
-            return computeQuantile(img.begin(), img.end(), naiveP, fraction*n);
-        }
-    }
-}
-
-typedef std::tuple<double, double, double> MedianQuartileReturn;
-namespace {
-    /**
-     * A wrapper using the nth_element() built-in to compute median and Quartiles for an image
-     *
-     * @param img       an afw::Image
-     *
-     * Specialisation for non-integral types (where ties are not a problem)
-     */
-    template <typename Pixel>
-    typename enable_if<!is_integral<Pixel>::value, MedianQuartileReturn>::type
-    medianAndQuartiles(std::vector<Pixel> &img) {
-        int const n = img.size();
-
-        if (n > 1) {
-            double const idx50 = 0.50 * (n - 1);
-            double const idx25 = 0.25 * (n - 1);
-            double const idx75 = 0.75 * (n - 1);
-
-            // For efficiency:
-            // - partition at 50th, then partition the two half further to get 25th and 75th
-            // - to get the adjacent points (for interpolation), partition between 25/50, 50/75, 75/end
-            //   these should be much smaller partitions
-
-            int const q50a = static_cast<int>(idx50);
-            int const q50b = q50a + 1;
-            int const q25a = static_cast<int>(idx25);
-            int const q25b = q25a + 1;
-            int const q75a = static_cast<int>(idx75);
-            int const q75b = q75a + 1;
-
-            auto mid50a = img.begin() + q50a;
-            auto mid50b = img.begin() + q50b;
-            auto mid25a = img.begin() + q25a;
-            auto mid25b = img.begin() + q25b;
-            auto mid75a = img.begin() + q75a;
-            auto mid75b = img.begin() + q75b;
-
-            // get the 50th percentile, then get the 25th and 75th on the smaller partitions
-            std::nth_element(img.begin(), mid50a, img.end());
-            std::nth_element(mid50a, mid75a, img.end());
-            std::nth_element(img.begin(), mid25a, mid50a);
-
-            // and the adjacent points for each ... use the smallest segments available.
-            std::nth_element(mid50a, mid50b, mid75a);
-            std::nth_element(mid25a, mid25b, mid50a);
-            std::nth_element(mid75a, mid75b, img.end());
-
-            // interpolate linearly between the adjacent values
-            double val50a = static_cast<double>(*mid50a);
-            double val50b = static_cast<double>(*mid50b);
-            double w50a = (static_cast<double>(q50b) - idx50);
-            double w50b = (idx50 - static_cast<double>(q50a));
-            double median = w50a * val50a + w50b * val50b;
-
-            double val25a = static_cast<double>(*mid25a);
-            double val25b = static_cast<double>(*mid25b);
-            double w25a = (static_cast<double>(q25b) - idx25);
-            double w25b = (idx25 - static_cast<double>(q25a));
-            double q1 = w25a * val25a + w25b * val25b;
-
-            double val75a = static_cast<double>(*mid75a);
-            double val75b = static_cast<double>(*mid75b);
-            double w75a = (static_cast<double>(q75b) - idx75);
-            double w75b = (idx75 - static_cast<double>(q75a));
-            double q3 = w75a * val75a + w75b * val75b;
-
-            return MedianQuartileReturn(median, q1, q3);
-        } else if (n == 1) {
-            return MedianQuartileReturn(img[0], img[0], img[0]);
-        } else {
-            return MedianQuartileReturn(NaN, NaN, NaN);
-        }
-    }
-
-    /**
-     * A wrapper using the nth_element() built-in to compute median and Quartiles for an image
-     *
-     * @param img       an afw::Image
-     *
-     * This is the specialisation for integral types where we have to handle ties carefully.
-     */
-    template <typename Pixel>
-    typename enable_if<is_integral<Pixel>::value, MedianQuartileReturn>::type
-    medianAndQuartiles(std::vector<Pixel> &img) {
-        auto const n = img.size();
-
-        if (n == 0) {
-            return MedianQuartileReturn(NaN, NaN, NaN);
-        } else if (n == 1) {
-            return MedianQuartileReturn(img[0], img[0], img[0]);
-        } else {
-            // We need to handle ties.  The proper way to do this is to analyse the cumulative curve after
-            // building the histograms (which is faster than a generic partitioning algorithm), but it's a
-            // nuisance as we don't know the range of values
-            //
-            // This code looks clean enough, but actually the call to nth_element is expensive
-            // and we *still* have to go through the array a second time.
-        
-            // For efficiency:
-            // - partition at 50th, then partition the two halves further to get 25th and 75th
-
-            auto mid25 = img.begin() + static_cast<int>(0.25*(n - 1));
-            auto mid50 = img.begin() + static_cast<int>(0.50*(n - 1));
-            auto mid75 = img.begin() + static_cast<int>(0.75*(n - 1));
-
-            // get the 50th percentile, then get the 25th and 75th on the smaller partitions
-            std::nth_element(img.begin(), mid50, img.end());
-            std::nth_element(img.begin(), mid25, mid50);
-            std::nth_element(mid50,       mid75, img.end());
-
-            double const q1     = computeQuantile(img.begin(), mid50,     *mid25,
-                                                  0.25*n);
-            double const median = computeQuantile(mid25,       mid75,     *mid50,
-                                                  0.50*n - (mid25 - img.begin()));
-            double const q3     = computeQuantile(mid50,       img.end(), *mid75,
-                                                  0.75*n - (mid50 - img.begin()));
-
-            return MedianQuartileReturn(median, q1, q3);
-        }
-    }
-}
+using detail::MedianQuartileReturn;
+using detail::medianAndQuartiles;
+using detail::percentile;
 
 /**
  * @internal A function to copy an image into a vector
@@ -722,6 +629,107 @@ std::shared_ptr<std::vector<typename ImageT::Pixel> > makeVectorCopy(ImageT cons
 
     return imgcp;
 }
+
+/**
+ * @internal A functor to pass the value of each finite, unmasked pixel of an image to a function
+ *
+ * This lets detail::radixQuantiles() make several passes over the pixels without copying them
+ */
+template <typename ImageT, typename MaskT>
+class GoodPixelVisitor {
+public:
+    GoodPixelVisitor(ImageT const &img, MaskT const &msk, int const andMask)
+            : _img(img), _msk(msk), _andMask(andMask) {}
+
+    template <typename Function>
+    void operator()(Function &&fn) const {
+        for (int i_y = 0; i_y < _img.getHeight(); ++i_y) {
+            typename MaskT::x_iterator mptr = _msk.row_begin(i_y);
+            for (typename ImageT::x_iterator ptr = _img.row_begin(i_y), end = _img.row_end(i_y); ptr != end;
+                 ++ptr) {
+                if (ChkFin()(*ptr) && !(*mptr & _andMask)) {
+                    fn(*ptr);
+                }
+                ++mptr;
+            }
+        }
+    }
+
+private:
+    ImageT const &_img;
+    MaskT const &_msk;
+    int const _andMask;
+};
+
+/**
+ * @internal Calculate the median and (unless onlyMedian) the quartiles by copying the values
+ */
+template <typename ImageT, typename MaskT, typename VarianceT>
+MedianQuartileReturn copyMedianAndQuartiles(ImageT const &img, MaskT const &msk, VarianceT const &var,
+                                            bool const onlyMedian, StatisticsControl const &sctrl) {
+    // make a vector copy of the image to get the median and quartiles (will move values)
+    std::shared_ptr<std::vector<typename ImageT::Pixel> > imgcp;
+    if (sctrl.getNanSafe()) {
+        imgcp = makeVectorCopy<ChkFin>(img, msk, var, sctrl.getAndMask());
+    } else {
+        imgcp = makeVectorCopy<AlwaysT>(img, msk, var, sctrl.getAndMask());
+    }
+
+    // if we *only* want the median, just use percentile(), otherwise use medianAndQuartiles()
+    if (onlyMedian) {
+        return MedianQuartileReturn(percentile(*imgcp, 0.5), NaN, NaN);
+    } else {
+        return medianAndQuartiles(*imgcp);
+    }
+}
+
+/**
+ * @internal Calculate the median and (unless onlyMedian) the quartiles
+ *
+ * Large floating-point images, and any image if a quantile tolerance is set, use
+ * detail::radixQuantiles(), which doesn't copy the pixels.  The bound on the error
+ * in each quantile is returned in errorBound.
+ *
+ * n is the number of good pixels
+ */
+template <typename ImageT, typename MaskT, typename VarianceT>
+typename std::enable_if<std::is_floating_point<typename ImageT::Pixel>::value, MedianQuartileReturn>::type
+getMedianAndQuartiles(ImageT const &img, MaskT const &msk, VarianceT const &var, bool const onlyMedian,
+                      StatisticsControl const &sctrl, int const n, double &errorBound) {
+    // Below this many pixels copying them is cheap, so we may as well use nth_element
+    int const MIN_RADIX_PIXELS = 1 << 16;
+
+    errorBound = 0.0;
+    if (!sctrl.getNanSafe() ||  // radixQuantiles can't handle NaNs
+        (sctrl.getQuantileTolerance() == 0.0 && n < MIN_RADIX_PIXELS)) {
+        return copyMedianAndQuartiles(img, msk, var, onlyMedian, sctrl);
+    }
+
+    std::vector<double> fractions = {0.5};
+    if (!onlyMedian) {
+        fractions.push_back(0.25);
+        fractions.push_back(0.75);
+    }
+    auto const quantiles = detail::radixQuantiles<typename ImageT::Pixel>(
+            GoodPixelVisitor<ImageT, MaskT>(img, msk, sctrl.getAndMask()), fractions,
+            sctrl.getQuantileTolerance());
+
+    if (onlyMedian) {
+        errorBound = quantiles[0].second;
+        return MedianQuartileReturn(quantiles[0].first, NaN, NaN);
+    } else {
+        errorBound = std::max({quantiles[0].second, quantiles[1].second, quantiles[2].second});
+        return MedianQuartileReturn(quantiles[0].first, quantiles[1].first, quantiles[2].first);
+    }
+}
+
+template <typename ImageT, typename MaskT, typename VarianceT>
+typename std::enable_if<!std::is_floating_point<typename ImageT::Pixel>::value, MedianQuartileReturn>::type
+getMedianAndQuartiles(ImageT const &img, MaskT const &msk, VarianceT const &var, bool const onlyMedian,
+                      StatisticsControl const &sctrl, int const, double &errorBound) {
+    errorBound = 0.0;
+    return copyMedianAndQuartiles(img, msk, var, onlyMedian, sctrl);
+}
 }  // namespace
 
 double StatisticsControl::getMaskPropagationThreshold(int bit) const {
@@ -784,6 +792,7 @@ Statistics::Statistics(ImageT const &img, MaskT const &msk, VarianceT const &var
           _nClipped(0),
           _nMasked(0),
           _iqrange(NaN),
+          _quantileErrorBound(0.0),
           _sctrl(sctrl),
           _weightsAreMultiplicative(false) {
     doStatistics(img, msk, var, var, _flags, _sctrl);
@@ -833,6 +842,7 @@ Statistics::Statistics(ImageT const &img, MaskT const &msk, VarianceT const &var
           _nClipped(0),
           _nMasked(0),
           _iqrange(NaN),
+          _quantileErrorBound(0.0),
           _sctrl(sctrl),
           _weightsAreMultiplicative(true) {
     if (!isEmpty(weights)) {
@@ -884,22 +894,15 @@ void Statistics::doStatistics(ImageT const &img, MaskT const &msk, VarianceT con
         _nMasked = num - _n;
     }
 
-    // copy the image for any routines that will use median or quantiles
+    // calculate the median and quantiles for any routines that will use them
     if (flags & (MEDIAN | IQRANGE | MEANCLIP | STDEVCLIP | VARIANCECLIP)) {
-        // make a vector copy of the image to get the median and quartiles (will move values)
-        std::shared_ptr<std::vector<typename ImageT::Pixel> > imgcp;
-        if (_sctrl.getNanSafe()) {
-            imgcp = makeVectorCopy<ChkFin>(img, msk, var, _sctrl.getAndMask());
-        } else {
-            imgcp = makeVectorCopy<AlwaysT>(img, msk, var, _sctrl.getAndMask());
-        }
-
-        // if we *only* want the median, just use percentile(), otherwise use medianAndQuartiles()
-        if ((flags & (MEDIAN)) && !(flags & (IQRANGE | MEANCLIP | STDEVCLIP | VARIANCECLIP))) {
-            _median = Value(percentile(*imgcp, 0.5), NaN);
-        } else {
-            MedianQuartileReturn mq = medianAndQuartiles(*imgcp);
-            _median = Value(std::get<0>(mq), NaN);
+        // if we *only* want the median, don't bother with the quartiles
+        bool const onlyMedian =
+                (flags & (MEDIAN)) && !(flags & (IQRANGE | MEANCLIP | STDEVCLIP | VARIANCECLIP));
+        MedianQuartileReturn mq =
+                getMedianAndQuartiles(img, msk, var, onlyMedian, _sctrl, _n, _quantileErrorBound);
+        _median = Value(std::get<0>(mq), NaN);
+        if (!onlyMedian) {
             _iqrange = std::get<2>(mq) - std::get<1>(mq);
         }
 
@@ -1080,6 +1083,7 @@ Statistics::Statistics(image::Mask<image::MaskPixel> const &msk, image::Mask<ima
           _median(NaN, NaN),
           _nClipped(0),
           _iqrange(NaN),
+          _quantileErrorBound(0.0),
           _sctrl(sctrl) {
     if ((flags & ~(NPOINT | SUM)) != 0x0) {
         throw LSST_EXCEPT(pexExceptions::InvalidParameterError,
@@ -23,21 +23,31 @@
  */
 
 /*
- * Definition of basicConvolve and convolveWithBruteForce functions declared in detail/ConvolveImage.h
+ * Definition of basicConvolve, convolveWithBruteForce, convolveWithFft and convolveWithBasisKernels
+ * functions declared in detail/ConvolveImage.h
  */
 #include <algorithm>
 #include <cmath>
+#include <complex>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
+#include "fftw3.h"
+
 #include "lsst/pex/exceptions.h"
 #include "lsst/log/Log.h"
 #include "lsst/geom.h"
+#include "lsst/afw/image/ImageUtils.h"
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/afw/math/ConvolveImage.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/math/detail/Convolve.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace pexExcept = lsst::pex::exceptions;
 
@@ -131,6 +141,730 @@ inline OutPixelT kernelDotProduct(
     }
     return outPixel;
 }
+
+/**
+ * @internal Convolve some rows of an %image with a spatially invariant separable kernel
+ *
+ * The basic sequence:
+ * - For each output row:
+ * - Compute x-convolved data: a kernel height's strip of input image convolved with kernel x vector
+ * - Compute one row of output by dotting each column of x-convolved data with the kernel y vector
+ * The x-convolved data is stored in a kernel-height by good-width buffer.
+ * This is circular buffer along y (to avoid shifting pixels before setting each new row);
+ * so for each new row the kernel y vector is rotated to match the order of the x-convolved data.
+ *
+ * Input row inY is always stored in row inY % kernel height of the buffer, so the terms of each
+ * output pixel are summed in the same order however the rows are split between calls.
+ *
+ * @param[out] convolvedImage  convolved %image
+ * @param[in] inImage  %image to convolve
+ * @param[in] goodBBox  the pixels of convolvedImage that can be computed
+ * @param[in] kernelXVec  kernel x vector
+ * @param[in] kernelYVec  kernel y vector
+ * @param[in] rowBegin  first row to compute, relative to goodBBox
+ * @param[in] rowEnd  last row to compute + 1, relative to goodBBox
+ */
+template <typename OutImageT, typename InImageT>
+void convolveSeparableRows(OutImageT& convolvedImage, InImageT const& inImage,
+                           lsst::geom::Box2I const& goodBBox,
+                           std::vector<lsst::afw::math::Kernel::Pixel> const& kernelXVec,
+                           std::vector<lsst::afw::math::Kernel::Pixel> const& kernelYVec, int const rowBegin,
+                           int const rowEnd) {
+    typedef typename lsst::afw::math::Kernel::Pixel KernelPixel;
+    typedef typename std::vector<KernelPixel> KernelVector;
+    typedef KernelVector::const_iterator KernelIterator;
+    typedef typename InImageT::const_x_iterator InXIterator;
+    typedef typename OutImageT::x_iterator OutXIterator;
+    typedef typename OutImageT::y_iterator OutYIterator;
+    typedef typename OutImageT::SinglePixel OutPixel;
+
+    int const kWidth = kernelXVec.size();
+    int const kHeight = kernelYVec.size();
+    int const goodWidth = goodBBox.getWidth();
+
+    // buffer for x-convolved data
+    OutImageT buffer(lsst::geom::Extent2I(goodWidth, kHeight));
+    auto fillBufferRow = [&](int const inY) {
+        OutXIterator bufXIter = buffer.x_at(0, inY % kHeight);
+        OutXIterator const bufXEnd = buffer.x_at(goodWidth, inY % kHeight);
+        InXIterator inXIter = inImage.x_at(0, inY);
+        for (; bufXIter != bufXEnd; ++bufXIter, ++inXIter) {
+            *bufXIter = kernelDotProduct<OutPixel, InXIterator, KernelIterator, KernelPixel>(
+                    inXIter, kernelXVec.begin(), kWidth);
+        }
+    };
+
+    // pre-fill x-convolved data buffer with all but one row of data
+    for (int inY = rowBegin; inY < rowBegin + kHeight - 1; ++inY) {
+        fillBufferRow(inY);
+    }
+
+    // the kernel y vector, rotated to match the buffer
+    KernelVector rotatedYVec(kernelYVec);
+    std::rotate(rotatedYVec.begin(), rotatedYVec.end() - rowBegin % kHeight, rotatedYVec.end());
+
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        fillBufferRow(row + kHeight - 1);
+
+        OutXIterator cnvXIter = convolvedImage.x_at(goodBBox.getMinX(), goodBBox.getMinY() + row);
+        for (int bufX = 0; bufX < goodWidth; ++bufX, ++cnvXIter) {
+            OutYIterator bufYIter = buffer.y_at(bufX, 0);
+            *cnvXIter = kernelDotProduct<OutPixel, OutYIterator, KernelIterator, KernelPixel>(
+                    bufYIter, rotatedYVec.begin(), kHeight);
+        }
+
+        std::rotate(rotatedYVec.begin(), rotatedYVec.end() - 1, rotatedYVec.end());
+    }
+}
+
+/**
+ * @internal Convolve some rows of an Image with a spatially invariant separable kernel
+ *
+ * This is the same algorithm (and gives identical results) as the general version, but works
+ * on whole rows of pixels at a time, one kernel element after another, so that the compiler
+ * can vectorise the inner loops.
+ */
+template <typename OutPixelT, typename InPixelT>
+void convolveSeparableRows(lsst::afw::image::Image<OutPixelT>& convolvedImage,
+                           lsst::afw::image::Image<InPixelT> const& inImage,
+                           lsst::geom::Box2I const& goodBBox,
+                           std::vector<lsst::afw::math::Kernel::Pixel> const& kernelXVec,
+                           std::vector<lsst::afw::math::Kernel::Pixel> const& kernelYVec, int const rowBegin,
+                           int const rowEnd) {
+    typedef typename lsst::afw::math::Kernel::Pixel KernelPixel;
+
+    int const kWidth = kernelXVec.size();
+    int const kHeight = kernelYVec.size();
+    int const goodWidth = goodBBox.getWidth();
+    auto const inArray = inImage.getArray();
+    auto const cnvArray = convolvedImage.getArray();
+
+    // buffer for x-convolved data
+    std::vector<OutPixelT> buffer(static_cast<std::size_t>(goodWidth) * kHeight);
+    auto fillBufferRow = [&](int const inY) {
+        OutPixelT* const bufRow = buffer.data() + static_cast<std::size_t>(inY % kHeight) * goodWidth;
+        InPixelT const* const inRow = inArray[inY].getData();
+        std::fill(bufRow, bufRow + goodWidth, OutPixelT(0));
+        for (int kX = 0; kX < kWidth; ++kX) {
+            KernelPixel const kVal = kernelXVec[kX];
+            if (kVal != 0) {  // as in kernelDotProduct
+                InPixelT const* const inPtr = inRow + kX;
+                for (int x = 0; x < goodWidth; ++x) {
+                    bufRow[x] += static_cast<OutPixelT>(inPtr[x] * kVal);
+                }
+            }
+        }
+    };
+
+    // pre-fill x-convolved data buffer with all but one row of data
+    for (int inY = rowBegin; inY < rowBegin + kHeight - 1; ++inY) {
+        fillBufferRow(inY);
+    }
+
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        fillBufferRow(row + kHeight - 1);
+
+        // sum over the rows of the buffer in order, with the kernel y vector rotated to match
+        OutPixelT* const cnvRow = cnvArray[goodBBox.getMinY() + row].getData() + goodBBox.getMinX();
+        std::fill(cnvRow, cnvRow + goodWidth, OutPixelT(0));
+        for (int bufY = 0; bufY < kHeight; ++bufY) {
+            KernelPixel const kVal = kernelYVec[((bufY - row) % kHeight + kHeight) % kHeight];
+            if (kVal != 0) {
+                OutPixelT const* const bufRow = buffer.data() + static_cast<std::size_t>(bufY) * goodWidth;
+                for (int x = 0; x < goodWidth; ++x) {
+                    cnvRow[x] += static_cast<OutPixelT>(bufRow[x] * kVal);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @internal Should a kernel be convolved using FFTs, according to ConvolutionControl::getMinFftKernelArea?
+ */
+bool isFftPreferred(lsst::afw::math::Kernel const& kernel,
+                    lsst::afw::math::ConvolutionControl const& convolutionControl) {
+    int const minArea = convolutionControl.getMinFftKernelArea();
+    return minArea > 0 && !kernel.isSpatiallyVarying() && kernel.getWidth() * kernel.getHeight() >= minArea;
+}
+
+/**
+ * @internal Return the smallest integer >= n whose only prime factors are 2, 3, 5 and 7
+ *
+ * FFTW is fastest for transforms of these sizes.
+ */
+int getFftSize(int n) {
+    for (;; ++n) {
+        int m = n;
+        for (int const factor : {2, 3, 5, 7}) {
+            while (m % factor == 0) {
+                m /= factor;
+            }
+        }
+        if (m == 1) {
+            return n;
+        }
+    }
+}
+
+/**
+ * @internal Return the size of the overlap-save FFTs along one axis
+ *
+ * Each tile yields fftSize + 1 - kernelSize output pixels, so the tiles should be several times
+ * the size of the kernel; but there is no point in them being larger than the image.
+ */
+int getFftTileSize(int kernelSize, int imageSize) {
+    return getFftSize(std::min(std::max(4 * kernelSize, 256), imageSize));
+}
+
+/// @internal FFTW's planner is not thread-safe (executing plans is)
+std::mutex fftwPlannerMutex;
+
+/// @internal Release memory allocated by fftw_malloc
+struct FftwDeleter {
+    void operator()(void* ptr) const { fftw_free(ptr); }
+};
+
+/// @internal Allocate an array suitably aligned for FFTW
+template <typename T>
+std::unique_ptr<T[], FftwDeleter> allocateFftwArray(std::size_t size) {
+    T* ptr = static_cast<T*>(fftw_malloc(sizeof(T) * size));
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return std::unique_ptr<T[], FftwDeleter>(ptr);
+}
+
+/**
+ * @internal Correlate Images with a kernel %image using overlap-save FFTs
+ *
+ * The good region of the output is divided into tiles of
+ * (fftWidth + 1 - kernel width) x (fftHeight + 1 - kernel height) pixels. Each tile is computed by
+ * multiplying the transform of the fftWidth x fftHeight input pixels that it depends upon by the
+ * transform of the (flipped) kernel, and discarding the pixels of the inverse transform that wrapped
+ * around. The input pixels are transformed in double precision.
+ */
+class FftCorrelator {
+public:
+    typedef lsst::afw::image::Image<lsst::afw::math::Kernel::Pixel> KernelImage;
+    typedef std::vector<std::complex<double>> KernelTransform;
+
+    FftCorrelator(lsst::geom::Extent2I const& kernelDimensions, int fftWidth, int fftHeight)
+            : _kWidth(kernelDimensions.getX()),
+              _kHeight(kernelDimensions.getY()),
+              _fftWidth(fftWidth),
+              _fftHeight(fftHeight),
+              _nReal(static_cast<std::size_t>(fftWidth) * fftHeight),
+              _nComplex(static_cast<std::size_t>(fftWidth / 2 + 1) * fftHeight) {
+        // plans made with these arrays may be executed on any arrays from fftw_malloc
+        auto real = allocateFftwArray<double>(_nReal);
+        auto transform = allocateFftwArray<fftw_complex>(_nComplex);
+        std::lock_guard<std::mutex> lock(fftwPlannerMutex);
+        _forward = fftw_plan_dft_r2c_2d(_fftHeight, _fftWidth, real.get(), transform.get(), FFTW_ESTIMATE);
+        _inverse = fftw_plan_dft_c2r_2d(_fftHeight, _fftWidth, transform.get(), real.get(), FFTW_ESTIMATE);
+        if (!_forward || !_inverse) {
+            destroyPlans();
+            throw LSST_EXCEPT(pexExcept::RuntimeError, "Could not plan FFTs for convolution");
+        }
+    }
+
+    FftCorrelator(FftCorrelator const&) = delete;
+    FftCorrelator& operator=(FftCorrelator const&) = delete;
+
+    ~FftCorrelator() {
+        std::lock_guard<std::mutex> lock(fftwPlannerMutex);
+        destroyPlans();
+    }
+
+    /**
+     * @internal Return the transform of a kernel %image for use by correlate
+     *
+     * @param[in] kernelImage  the kernel %image
+     * @param[in] doSquare  transform the square of the kernel (to convolve a variance plane)?
+     */
+    KernelTransform transformKernel(KernelImage const& kernelImage, bool doSquare) const {
+        auto real = allocateFftwArray<double>(_nReal);
+        auto transform = allocateFftwArray<fftw_complex>(_nComplex);
+        std::fill(real.get(), real.get() + _nReal, 0.0);
+        // flip the kernel, as convolve correlates the image with the kernel;
+        // and include the normalization of FFTW's unnormalized inverse transform
+        double const scale = 1.0 / _nReal;
+        for (int y = 0; y < _kHeight; ++y) {
+            double* const realRow = real.get() + static_cast<std::size_t>(_kHeight - 1 - y) * _fftWidth;
+            for (int x = 0; x < _kWidth; ++x) {
+                double const value = kernelImage(x, y);
+                realRow[_kWidth - 1 - x] = scale * (doSquare ? value * value : value);
+            }
+        }
+        fftw_execute_dft_r2c(_forward, real.get(), transform.get());
+        auto const* const begin = reinterpret_cast<std::complex<double> const*>(transform.get());
+        return KernelTransform(begin, begin + _nComplex);
+    }
+
+    /**
+     * @internal Correlate an %image with a kernel, setting the pixels of convolvedImage in goodBBox
+     *
+     * @param[out] convolvedImage  convolved %image
+     * @param[in] inImage  %image to convolve
+     * @param[in] goodBBox  the pixels of convolvedImage that can be computed
+     * @param[in] kernelTransform  transform of the kernel, from transformKernel
+     * @param[in] nThreads  number of threads to use; rows of tiles are computed in parallel
+     */
+    template <typename OutPixelT, typename InPixelT>
+    void correlate(lsst::afw::image::Image<OutPixelT>& convolvedImage,
+                   lsst::afw::image::Image<InPixelT> const& inImage, lsst::geom::Box2I const& goodBBox,
+                   KernelTransform const& kernelTransform, int nThreads) const {
+        int const inWidth = inImage.getWidth();
+        int const inHeight = inImage.getHeight();
+        int const goodWidth = goodBBox.getWidth();
+        int const goodHeight = goodBBox.getHeight();
+        int const tileWidth = _fftWidth + 1 - _kWidth;
+        int const tileHeight = _fftHeight + 1 - _kHeight;
+        int const nTileX = (goodWidth + tileWidth - 1) / tileWidth;
+        int const nTileY = (goodHeight + tileHeight - 1) / tileHeight;
+        auto const inArray = inImage.getArray();
+        auto const cnvArray = convolvedImage.getArray();
+
+        parallelFor(0, nTileY, nThreads, [&](int const tileYBegin, int const tileYEnd) {
+            auto real = allocateFftwArray<double>(_nReal);
+            auto transform = allocateFftwArray<fftw_complex>(_nComplex);
+            auto* const product = reinterpret_cast<std::complex<double>*>(transform.get());
+
+            for (int tileY = tileYBegin; tileY < tileYEnd; ++tileY) {
+                for (int tileX = 0; tileX < nTileX; ++tileX) {
+                    // the input pixels start at (x0, y0), as does the output relative to goodBBox
+                    int const x0 = tileX * tileWidth;
+                    int const y0 = tileY * tileHeight;
+
+                    std::fill(real.get(), real.get() + _nReal, 0.0);
+                    int const inXEnd = std::min(x0 + _fftWidth, inWidth);
+                    int const inYEnd = std::min(y0 + _fftHeight, inHeight);
+                    for (int y = y0; y < inYEnd; ++y) {
+                        InPixelT const* const inRow = inArray[y].getData();
+                        double* const realRow = real.get() + static_cast<std::size_t>(y - y0) * _fftWidth;
+                        for (int x = x0; x < inXEnd; ++x) {
+                            realRow[x - x0] = inRow[x];
+                        }
+                    }
+
+                    fftw_execute_dft_r2c(_forward, real.get(), transform.get());
+                    for (std::size_t i = 0; i < _nComplex; ++i) {
+                        product[i] *= kernelTransform[i];
+                    }
+                    fftw_execute_dft_c2r(_inverse, transform.get(), real.get());
+
+                    int const cnvXEnd = std::min(x0 + tileWidth, goodWidth);
+                    int const cnvYEnd = std::min(y0 + tileHeight, goodHeight);
+                    for (int y = y0; y < cnvYEnd; ++y) {
+                        double const* const realRow =
+                                real.get() + static_cast<std::size_t>(y - y0 + _kHeight - 1) * _fftWidth +
+                                _kWidth - 1;
+                        OutPixelT* const cnvRow =
+                                cnvArray[goodBBox.getMinY() + y].getData() + goodBBox.getMinX();
+                        for (int x = x0; x < cnvXEnd; ++x) {
+                            cnvRow[x] = static_cast<OutPixelT>(realRow[x - x0]);
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+private:
+    void destroyPlans() {
+        if (_forward) {
+            fftw_destroy_plan(_forward);
+        }
+        if (_inverse) {
+            fftw_destroy_plan(_inverse);
+        }
+    }
+
+    int const _kWidth;
+    int const _kHeight;
+    int const _fftWidth;
+    int const _fftHeight;
+    std::size_t const _nReal;     ///< number of real values in a tile
+    std::size_t const _nComplex;  ///< number of complex values in the transform of a tile
+    fftw_plan _forward;
+    fftw_plan _inverse;
+};
+
+/**
+ * @internal Set the pixels of a mask in goodBBox to the OR of the input mask pixels under the non-zero
+ * kernel pixels, as convolveWithBruteForce does
+ *
+ * Each row of the kernel is split into runs of non-zero pixels. The OR of the input mask over every
+ * window the length of a run is computed a row at a time using the van Herk/Gil-Werman algorithm,
+ * which takes three operations per pixel however long the window is.
+ */
+template <typename MaskPixelT>
+void smearMask(lsst::afw::image::Mask<MaskPixelT>& convolvedMask,
+               lsst::afw::image::Mask<MaskPixelT> const& inMask,
+               FftCorrelator::KernelImage const& kernelImage, lsst::geom::Box2I const& goodBBox,
+               int nThreads) {
+    struct Run {
+        int kernelY;  ///< kernel row
+        int begin;    ///< kernel column of first pixel
+        int length;   ///< number of pixels
+    };
+    std::vector<Run> runs;
+    for (int y = 0; y < kernelImage.getHeight(); ++y) {
+        for (int x = 0; x < kernelImage.getWidth(); ++x) {
+            if (kernelImage(x, y) != 0) {
+                if (runs.empty() || runs.back().kernelY != y || runs.back().begin + runs.back().length != x) {
+                    runs.push_back(Run{y, x, 0});
+                }
+                ++runs.back().length;
+            }
+        }
+    }
+
+    int const inWidth = inMask.getWidth();
+    int const goodWidth = goodBBox.getWidth();
+    auto const inArray = inMask.getArray();
+    auto const cnvArray = convolvedMask.getArray();
+
+    parallelFor(0, goodBBox.getHeight(), nThreads, [&](int const rowBegin, int const rowEnd) {
+        // OR of the input from each pixel to the end of its block, and from the start of its block
+        std::vector<MaskPixelT> toBlockEnd(inWidth);
+        std::vector<MaskPixelT> fromBlockBegin(inWidth);
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            MaskPixelT* const cnvRow = cnvArray[goodBBox.getMinY() + row].getData() + goodBBox.getMinX();
+            std::fill(cnvRow, cnvRow + goodWidth, 0x0);
+            for (Run const& run : runs) {
+                MaskPixelT const* const inRow = inArray[row + run.kernelY].getData();
+                int const length = run.length;
+                int const inEnd = run.begin + goodWidth + length - 1;
+                for (int blockBegin = run.begin; blockBegin < inEnd; blockBegin += length) {
+                    int const blockEnd = std::min(blockBegin + length, inEnd);
+                    fromBlockBegin[blockBegin] = inRow[blockBegin];
+                    for (int x = blockBegin + 1; x < blockEnd; ++x) {
+                        fromBlockBegin[x] = fromBlockBegin[x - 1] | inRow[x];
+                    }
+                    toBlockEnd[blockEnd - 1] = inRow[blockEnd - 1];
+                    for (int x = blockEnd - 2; x >= blockBegin; --x) {
+                        toBlockEnd[x] = toBlockEnd[x + 1] | inRow[x];
+                    }
+                }
+                // a window of length pixels spans at most two blocks
+                MaskPixelT const* const toEnd = toBlockEnd.data() + run.begin;
+                MaskPixelT const* const fromBegin = fromBlockBegin.data() + run.begin + length - 1;
+                for (int x = 0; x < goodWidth; ++x) {
+                    cnvRow[x] |= toEnd[x] | fromBegin[x];
+                }
+            }
+        }
+    });
+}
+
+/// @internal Are all the pixels of an Image finite?
+template <typename PixelT>
+bool isAllFinite(lsst::afw::image::Image<PixelT> const& image) {
+    auto const array = image.getArray();
+    for (int y = 0; y < image.getHeight(); ++y) {
+        PixelT const* const row = array[y].getData();
+        for (int x = 0; x < image.getWidth(); ++x) {
+            if (!std::isfinite(static_cast<double>(row[x]))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @internal Convolve the planes of an Image or MaskedImage using FFTs, setting the pixels in goodBBox
+ *
+ * @returns false (having done nothing) if FFTs cannot be used: the output pixels must be floating point
+ * and the input %image and variance pixels must all be finite
+ */
+template <typename OutImageT, typename InImageT>
+bool convolvePlanesWithFft(OutImageT&, InImageT const&, FftCorrelator::KernelImage const&,
+                           lsst::geom::Box2I const&, int) {
+    return false;
+}
+
+template <typename OutPixelT, typename InPixelT>
+typename std::enable_if<std::is_floating_point<OutPixelT>::value, bool>::type convolvePlanesWithFft(
+        lsst::afw::image::Image<OutPixelT>& convolvedImage, lsst::afw::image::Image<InPixelT> const& inImage,
+        FftCorrelator::KernelImage const& kernelImage, lsst::geom::Box2I const& goodBBox, int nThreads) {
+    if (!isAllFinite(inImage)) {
+        return false;
+    }
+    FftCorrelator correlator(kernelImage.getDimensions(),
+                             getFftTileSize(kernelImage.getWidth(), inImage.getWidth()),
+                             getFftTileSize(kernelImage.getHeight(), inImage.getHeight()));
+    correlator.correlate(convolvedImage, inImage, goodBBox, correlator.transformKernel(kernelImage, false),
+                         nThreads);
+    return true;
+}
+
+template <typename OutPixelT, typename InPixelT>
+typename std::enable_if<std::is_floating_point<OutPixelT>::value, bool>::type convolvePlanesWithFft(
+        lsst::afw::image::MaskedImage<OutPixelT>& convolvedImage,
+        lsst::afw::image::MaskedImage<InPixelT> const& inImage, FftCorrelator::KernelImage const& kernelImage,
+        lsst::geom::Box2I const& goodBBox, int nThreads) {
+    if (!isAllFinite(*inImage.getImage()) || !isAllFinite(*inImage.getVariance())) {
+        return false;
+    }
+    FftCorrelator correlator(kernelImage.getDimensions(),
+                             getFftTileSize(kernelImage.getWidth(), inImage.getWidth()),
+                             getFftTileSize(kernelImage.getHeight(), inImage.getHeight()));
+    correlator.correlate(*convolvedImage.getImage(), *inImage.getImage(), goodBBox,
+                         correlator.transformKernel(kernelImage, false), nThreads);
+    correlator.correlate(*convolvedImage.getVariance(), *inImage.getVariance(), goodBBox,
+                         correlator.transformKernel(kernelImage, true), nThreads);
+    smearMask(*convolvedImage.getMask(), *inImage.getMask(), kernelImage, goodBBox, nThreads);
+    return true;
+}
+/**
+ * @internal The basis kernels of a spatially varying LinearCombinationKernel, for convolveWithBasisKernels
+ *
+ * The kernels and spatial functions are copies, as computing their images or values is not thread-safe.
+ */
+struct BasisKernels {
+    typedef lsst::afw::math::Kernel Kernel;
+    typedef lsst::afw::image::Image<Kernel::Pixel> KernelImage;
+
+    /// A product of two basis kernels, with which to convolve the variance
+    struct CrossTerm {
+        int i;
+        int j;
+        std::shared_ptr<Kernel> kernelPtr;
+    };
+
+    /**
+     * @param[in] kernel  the kernel
+     * @param[in] doCrossTerms  compute the products of the basis kernels?
+     */
+    BasisKernels(lsst::afw::math::LinearCombinationKernel const& kernel, bool doCrossTerms)
+            : kernelSums(kernel.getKernelSumList()), spatialFunctions(kernel.getSpatialFunctionList()) {
+        std::vector<KernelImage> images;
+        for (auto const& basisKernelPtr : kernel.getKernelList()) {
+            // convolve with the basis kernels as they are combined: unnormalized, with the kernel's center
+            kernels.push_back(basisKernelPtr->clone());
+            kernels.back()->setCtr(kernel.getCtr());
+            if (doCrossTerms) {
+                images.emplace_back(kernel.getDimensions());
+                (void)kernels.back()->computeImage(images.back(), false);
+            }
+        }
+        // only products of basis kernels that overlap (e.g. not delta functions) contribute
+        for (std::size_t i = 0; i < images.size(); ++i) {
+            for (std::size_t j = i + 1; j < images.size(); ++j) {
+                KernelImage product(images[i], true);
+                product *= images[j];
+                bool isZero = true;
+                for (int y = 0; y < product.getHeight() && isZero; ++y) {
+                    for (auto ptr = product.row_begin(y), end = product.row_end(y); ptr != end; ++ptr) {
+                        isZero = isZero && (*ptr == 0);
+                    }
+                }
+                if (!isZero) {
+                    auto productKernelPtr = std::make_shared<lsst::afw::math::FixedKernel>(product);
+                    productKernelPtr->setCtr(kernel.getCtr());
+                    crossTerms.push_back(
+                            CrossTerm{static_cast<int>(i), static_cast<int>(j), productKernelPtr});
+                }
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<Kernel>> kernels;
+    std::vector<double> kernelSums;
+    std::vector<Kernel::SpatialFunctionPtr> spatialFunctions;
+    std::vector<CrossTerm> crossTerms;
+};
+
+/**
+ * @internal A band of rows of the good region of the output of convolveWithBasisKernels
+ *
+ * Pixel (x, y) of the band, which is element y*width + x of the per-pixel vectors, is pixel
+ * (goodBBox.getMinX() + x, goodBBox.getMinY() + rowBegin + y) of the output.
+ */
+class BasisChunk {
+public:
+    /**
+     * @param[in] kernel  the kernel
+     * @param[in] goodBBox  the pixels of the output that can be computed
+     * @param[in] xy0  xy0 of the input image
+     * @param[in] rowBegin  first row of the band, relative to goodBBox
+     * @param[in] rowEnd  last row of the band + 1, relative to goodBBox
+     */
+    BasisChunk(lsst::afw::math::Kernel const& kernel, lsst::geom::Box2I const& goodBBox,
+               lsst::geom::Point2I const& xy0, int rowBegin, int rowEnd)
+            : _ctr(kernel.getCtr()),
+              _outBBox(lsst::geom::Point2I(goodBBox.getMinX(), goodBBox.getMinY() + rowBegin),
+                       lsst::geom::Extent2I(goodBBox.getWidth(), rowEnd - rowBegin)),
+              _inBBox(lsst::geom::Point2I(goodBBox.getMinX() - _ctr.getX(), _outBBox.getMinY() - _ctr.getY()),
+                      kernel.growBBox(_outBBox).getDimensions()),
+              _xPos(_outBBox.getWidth()),
+              _yPos(_outBBox.getHeight()) {
+        for (int x = 0; x < _outBBox.getWidth(); ++x) {
+            _xPos[x] = lsst::afw::image::indexToPosition(_outBBox.getMinX() + x + xy0.getX());
+        }
+        for (int y = 0; y < _outBBox.getHeight(); ++y) {
+            _yPos[y] = lsst::afw::image::indexToPosition(_outBBox.getMinY() + y + xy0.getY());
+        }
+    }
+
+    /// The input pixels the band depends upon, in LOCAL coordinates
+    lsst::geom::Box2I const& getInBBox() const { return _inBBox; }
+
+    /// Number of pixels in the band
+    std::size_t size() const { return _xPos.size() * _yPos.size(); }
+
+    /// Evaluate a spatial function at each pixel of the band
+    void computeWeights(lsst::afw::math::Kernel::SpatialFunction const& function,
+                        std::vector<double>& weights) const {
+        auto weightIter = weights.begin();
+        for (double const yPos : _yPos) {
+            for (double const xPos : _xPos) {
+                *weightIter++ = function(xPos, yPos);
+            }
+        }
+    }
+
+    /// Add weights * the pixels of a plane convolved from the input band to sum
+    template <typename PixelT>
+    void addWeighted(std::vector<double>& sum, std::vector<double> const& weights,
+                     lsst::afw::image::Image<PixelT> const& convolved) const {
+        auto const array = convolved.getArray();
+        int const width = _outBBox.getWidth();
+        for (int y = 0, i = 0; y < _outBBox.getHeight(); ++y) {
+            PixelT const* const row = array[_ctr.getY() + y].getData() + _ctr.getX();
+            for (int x = 0; x < width; ++x, ++i) {
+                sum[i] += weights[i] * row[x];
+            }
+        }
+    }
+
+    /// OR the pixels of a mask convolved from the input band into mask, where weights are non-zero
+    template <typename MaskPixelT>
+    void orMask(std::vector<MaskPixelT>& mask, std::vector<double> const& weights,
+                lsst::afw::image::Mask<MaskPixelT> const& convolved) const {
+        auto const array = convolved.getArray();
+        int const width = _outBBox.getWidth();
+        for (int y = 0, i = 0; y < _outBBox.getHeight(); ++y) {
+            MaskPixelT const* const row = array[_ctr.getY() + y].getData() + _ctr.getX();
+            for (int x = 0; x < width; ++x, ++i) {
+                mask[i] |= (weights[i] != 0) ? row[x] : 0x0;
+            }
+        }
+    }
+
+    /// Set the band of an output plane to sum / norm^normPower (or to sum, if norm is empty)
+    template <typename PixelT>
+    void setPlane(lsst::afw::image::Image<PixelT>& convolved, std::vector<double> const& sum,
+                  std::vector<double> const& norm, int normPower) const {
+        auto const array = convolved.getArray();
+        int const width = _outBBox.getWidth();
+        for (int y = 0, i = 0; y < _outBBox.getHeight(); ++y) {
+            PixelT* const row = array[_outBBox.getMinY() + y].getData() + _outBBox.getMinX();
+            for (int x = 0; x < width; ++x, ++i) {
+                double value = sum[i];
+                if (!norm.empty()) {
+                    value /= (normPower == 1) ? norm[i] : norm[i] * norm[i];
+                }
+                row[x] = static_cast<PixelT>(value);
+            }
+        }
+    }
+
+    /// Set the band of an output mask
+    template <typename MaskPixelT>
+    void setMask(lsst::afw::image::Mask<MaskPixelT>& convolved, std::vector<MaskPixelT> const& mask) const {
+        auto const array = convolved.getArray();
+        for (int y = 0; y < _outBBox.getHeight(); ++y) {
+            std::copy_n(mask.begin() + static_cast<std::size_t>(y) * _outBBox.getWidth(), _outBBox.getWidth(),
+                        array[_outBBox.getMinY() + y].getData() + _outBBox.getMinX());
+        }
+    }
+
+private:
+    lsst::geom::Point2I const _ctr;
+    lsst::geom::Box2I const _outBBox;
+    lsst::geom::Box2I const _inBBox;
+    std::vector<double> _xPos;  ///< position of each column of the band
+    std::vector<double> _yPos;  ///< position of each row of the band
+};
+
+/**
+ * @internal Compute one band of convolveWithBasisKernels for an Image
+ */
+template <typename OutPixelT, typename InPixelT>
+void convolveChunkWithBasisKernels(lsst::afw::image::Image<OutPixelT>& convolvedImage,
+                                   lsst::afw::image::Image<InPixelT> const& inImage,
+                                   BasisKernels const& basis, BasisChunk const& chunk,
+                                   lsst::afw::math::ConvolutionControl const& basisControl,
+                                   bool doNormalize) {
+    lsst::afw::image::Image<InPixelT> const inChunk(inImage, chunk.getInBBox(), lsst::afw::image::LOCAL);
+    lsst::afw::image::Image<double> basisConvolved(inChunk.getDimensions());
+    std::vector<double> weights(chunk.size());
+    std::vector<double> sum(chunk.size(), 0.0);
+    std::vector<double> norm(doNormalize ? chunk.size() : 0, 0.0);
+
+    for (std::size_t i = 0; i < basis.kernels.size(); ++i) {
+        chunk.computeWeights(*basis.spatialFunctions[i], weights);
+        lsst::afw::math::detail::basicConvolve(basisConvolved, inChunk, *basis.kernels[i], basisControl);
+        chunk.addWeighted(sum, weights, basisConvolved);
+        for (std::size_t k = 0; k < norm.size(); ++k) {
+            norm[k] += weights[k] * basis.kernelSums[i];
+        }
+    }
+    chunk.setPlane(convolvedImage, sum, norm, 1);
+}
+
+/**
+ * @internal Compute one band of convolveWithBasisKernels for a MaskedImage
+ */
+template <typename OutPixelT, typename InPixelT>
+void convolveChunkWithBasisKernels(lsst::afw::image::MaskedImage<OutPixelT>& convolvedImage,
+                                   lsst::afw::image::MaskedImage<InPixelT> const& inImage,
+                                   BasisKernels const& basis, BasisChunk const& chunk,
+                                   lsst::afw::math::ConvolutionControl const& basisControl,
+                                   bool doNormalize) {
+    typedef lsst::afw::image::MaskPixel MaskPixel;
+    lsst::afw::image::MaskedImage<InPixelT> const inChunk(inImage, chunk.getInBBox(),
+                                                          lsst::afw::image::LOCAL);
+    lsst::afw::image::MaskedImage<double> basisConvolved(inChunk.getDimensions());
+    std::vector<double> weights(chunk.size());
+    std::vector<double> weightsSq(chunk.size());
+    std::vector<double> sum(chunk.size(), 0.0);
+    std::vector<double> variance(chunk.size(), 0.0);
+    std::vector<double> norm(doNormalize ? chunk.size() : 0, 0.0);
+    std::vector<MaskPixel> mask(chunk.size(), 0x0);
+
+    // the variance is sum_ij w_i w_j (variance convolved with basis_i basis_j); first the terms i == j
+    for (std::size_t i = 0; i < basis.kernels.size(); ++i) {
+        chunk.computeWeights(*basis.spatialFunctions[i], weights);
+        lsst::afw::math::detail::basicConvolve(basisConvolved, inChunk, *basis.kernels[i], basisControl);
+        chunk.addWeighted(sum, weights, *basisConvolved.getImage());
+        std::transform(weights.begin(), weights.end(), weightsSq.begin(), [](double w) { return w * w; });
+        chunk.addWeighted(variance, weightsSq, *basisConvolved.getVariance());
+        chunk.orMask(mask, weights, *basisConvolved.getMask());
+        for (std::size_t k = 0; k < norm.size(); ++k) {
+            norm[k] += weights[k] * basis.kernelSums[i];
+        }
+    }
+
+    // then the terms i != j, using weightsSq for 2 w_i w_j
+    lsst::afw::image::Image<double> varianceConvolved(inChunk.getDimensions());
+    for (auto const& crossTerm : basis.crossTerms) {
+        chunk.computeWeights(*basis.spatialFunctions[crossTerm.i], weights);
+        chunk.computeWeights(*basis.spatialFunctions[crossTerm.j], weightsSq);
+        std::transform(weights.begin(), weights.end(), weightsSq.begin(), weightsSq.begin(),
+                       [](double wi, double wj) { return 2.0 * wi * wj; });
+        lsst::afw::math::detail::basicConvolve(varianceConvolved, *inChunk.getVariance(),
+                                               *crossTerm.kernelPtr, basisControl);
+        chunk.addWeighted(variance, weightsSq, varianceConvolved);
+    }
+
+    chunk.setPlane(*convolvedImage.getImage(), sum, norm, 1);
+    chunk.setPlane(*convolvedImage.getVariance(), variance, norm, 2);
+    chunk.setMask(*convolvedImage.getMask(), mask);
+}
 }  // anonymous namespace
 
 namespace lsst {
@@ -171,6 +905,9 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Ker
                    "generic basicConvolve: using linear interpolation");
         convolveWithInterpolation(convolvedImage, inImage, kernel, convolutionControl);
 
+    } else if (isFftPreferred(kernel, convolutionControl)) {
+        LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve", "generic basicConvolve: using FFTs");
+        convolveWithFft(convolvedImage, inImage, kernel, convolutionControl);
     } else {
         // use brute force
         LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve", "generic basicConvolve: using brute force");
@@ -210,7 +947,15 @@ template <typename OutImageT, typename InImageT>
 void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage,
                    math::LinearCombinationKernel const& kernel,
                    math::ConvolutionControl const& convolutionControl) {
-    if (!kernel.isSpatiallyVarying()) {
+    if (isFftPreferred(kernel, convolutionControl)) {
+        LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
+                   "basicConvolve for LinearCombinationKernel: spatially invariant; using FFTs");
+        return convolveWithFft(convolvedImage, inImage, kernel, convolutionControl);
+    } else if (kernel.isSpatiallyVarying() && convolutionControl.getDoBasisConvolution()) {
+        LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
+                   "basicConvolve for LinearCombinationKernel: convolving each basis kernel");
+        return convolveWithBasisKernels(convolvedImage, inImage, kernel, convolutionControl);
+    } else if (!kernel.isSpatiallyVarying()) {
         // use the standard algorithm for the spatially invariant case
         LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
                    "basicConvolve for LinearCombinationKernel: spatially invariant; using brute force");
@@ -248,12 +993,8 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Sep
                    math::ConvolutionControl const& convolutionControl) {
     typedef typename math::Kernel::Pixel KernelPixel;
     typedef typename std::vector<KernelPixel> KernelVector;
-    typedef KernelVector::const_iterator KernelIterator;
-    typedef typename InImageT::const_x_iterator InXIterator;
     typedef typename InImageT::const_xy_locator InXYLocator;
     typedef typename OutImageT::x_iterator OutXIterator;
-    typedef typename OutImageT::y_iterator OutYIterator;
-    typedef typename OutImageT::SinglePixel OutPixel;
 
     assertDimensionsOK(convolvedImage, inImage, kernel);
 
@@ -287,68 +1028,17 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Sep
             }
         }
     } else {
-        // kernel is spatially invariant
-        // The basic sequence:
-        // - For each output row:
-        // - Compute x-convolved data: a kernel height's strip of input image convolved with kernel x vector
-        // - Compute one row of output by dotting each column of x-convolved data with the kernel y vector
-        // The x-convolved data is stored in a kernel-height by good-width buffer.
-        // This is circular buffer along y (to avoid shifting pixels before setting each new row);
-        // so for each new row the kernel y vector is rotated to match the order of the x-convolved data.
-
+        // kernel is spatially invariant; compute bands of rows in parallel
         LOGL_DEBUG("TRACE2.afw.math.convolve.basicConvolve",
                    "SeparableKernel basicConvolve: kernel is spatially invariant");
 
         kernel.computeVectors(kernelXVec, kernelYVec, convolutionControl.getDoNormalize());
-        KernelIterator const kernelXVecBegin = kernelXVec.begin();
-        KernelIterator const kernelYVecBegin = kernelYVec.begin();
-
-        // buffer for x-convolved data
-        OutImageT buffer(lsst::geom::Extent2I(goodBBox.getWidth(), kernel.getHeight()));
-
-        // pre-fill x-convolved data buffer with all but one row of data
-        int yInd = 0;  // during initial fill bufY = inImageY
-        int const yPrefillEnd = buffer.getHeight() - 1;
-        for (; yInd < yPrefillEnd; ++yInd) {
-            OutXIterator bufXIter = buffer.x_at(0, yInd);
-            OutXIterator const bufXEnd = buffer.x_at(goodBBox.getWidth(), yInd);
-            InXIterator inXIter = inImage.x_at(0, yInd);
-            for (; bufXIter != bufXEnd; ++bufXIter, ++inXIter) {
-                *bufXIter = kernelDotProduct<OutPixel, InXIterator, KernelIterator, KernelPixel>(
-                        inXIter, kernelXVecBegin, kernel.getWidth());
-            }
-        }
-
-        // compute output pixels using the sequence described above
-        int inY = yPrefillEnd;
-        int bufY = yPrefillEnd;
-        int cnvY = goodBBox.getMinY();
-        while (true) {
-            // fill next buffer row and compute output row
-            InXIterator inXIter = inImage.x_at(0, inY);
-            OutXIterator bufXIter = buffer.x_at(0, bufY);
-            OutXIterator cnvXIter = convolvedImage.x_at(goodBBox.getMinX(), cnvY);
-            for (int bufX = 0; bufX < goodBBox.getWidth(); ++bufX, ++cnvXIter, ++bufXIter, ++inXIter) {
-                // note: bufXIter points to the row of the buffer that is being updated,
-                // whereas bufYIter points to row 0 of the buffer
-                *bufXIter = kernelDotProduct<OutPixel, InXIterator, KernelIterator, KernelPixel>(
-                        inXIter, kernelXVecBegin, kernel.getWidth());
-
-                OutYIterator bufYIter = buffer.y_at(bufX, 0);
-                *cnvXIter = kernelDotProduct<OutPixel, OutYIterator, KernelIterator, KernelPixel>(
-                        bufYIter, kernelYVecBegin, kernel.getHeight());
-            }
 
-            // test for done now, instead of the start of the loop,
-            // to avoid an unnecessary extra rotation of the kernel Y vector
-            if (cnvY >= goodBBox.getMaxY()) break;
-
-            // update y indices, including bufY, and rotate the kernel y vector to match
-            ++inY;
-            bufY = (bufY + 1) % kernel.getHeight();
-            ++cnvY;
-            std::rotate(kernelYVec.begin(), kernelYVec.end() - 1, kernelYVec.end());
-        }
+        parallelFor(0, goodBBox.getHeight(), convolutionControl.getNumThreads(),
+                    [&](int const rowBegin, int const rowEnd) {
+                        convolveSeparableRows(convolvedImage, inImage, goodBBox, kernelXVec, kernelYVec,
+                                              rowBegin, rowEnd);
+                    });
     }
 }
 
@@ -429,6 +1119,69 @@ void convolveWithBruteForce(OutImageT& convolvedImage, InImageT const& inImage,
     }
 }
 
+template <typename OutImageT, typename InImageT>
+void convolveWithFft(OutImageT& convolvedImage, InImageT const& inImage, math::Kernel const& kernel,
+                     math::ConvolutionControl const& convolutionControl) {
+    if (kernel.isSpatiallyVarying()) {
+        LOGL_DEBUG("TRACE4.afw.math.convolve.convolveWithFft",
+                   "convolveWithFft: kernel is spatially varying; using brute force");
+        convolveWithBruteForce(convolvedImage, inImage, kernel, convolutionControl);
+        return;
+    }
+
+    assertDimensionsOK(convolvedImage, inImage, kernel);
+
+    FftCorrelator::KernelImage kernelImage(kernel.getDimensions());
+    (void)kernel.computeImage(kernelImage, convolutionControl.getDoNormalize());
+    lsst::geom::Box2I const goodBBox = kernel.shrinkBBox(inImage.getBBox(image::LOCAL));
+
+    if (convolvePlanesWithFft(convolvedImage, inImage, kernelImage, goodBBox,
+                              convolutionControl.getNumThreads())) {
+        LOGL_DEBUG("TRACE4.afw.math.convolve.convolveWithFft", "convolveWithFft: used FFTs");
+    } else {
+        LOGL_DEBUG("TRACE4.afw.math.convolve.convolveWithFft",
+                   "convolveWithFft: integer output or non-finite input; using brute force");
+        convolveWithBruteForce(convolvedImage, inImage, kernel, convolutionControl);
+    }
+}
+
+template <typename OutImageT, typename InImageT>
+void convolveWithBasisKernels(OutImageT& convolvedImage, InImageT const& inImage,
+                              math::LinearCombinationKernel const& kernel,
+                              math::ConvolutionControl const& convolutionControl) {
+    assertDimensionsOK(convolvedImage, inImage, kernel);
+    if (!kernel.isSpatiallyVarying()) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, "kernel is not spatially varying");
+    }
+
+    // only a MaskedImage's variance needs the products of the basis kernels
+    bool const doCrossTerms = std::is_same<typename image::detail::image_traits<OutImageT>::image_category,
+                                           image::detail::MaskedImage_tag>::value;
+    // the basis kernels are convolved one band at a time, so there's no point in threading them too
+    math::ConvolutionControl basisControl(convolutionControl);
+    basisControl.setDoNormalize(false);
+    basisControl.setNumThreads(1);
+
+    // The bands are tall enough to make the extra input rows they need cheap, short enough to keep
+    // their pixels in cache, and independent of the number of threads
+    lsst::geom::Box2I const goodBBox = kernel.shrinkBBox(inImage.getBBox(image::LOCAL));
+    int const bandHeight = std::max(64, 4 * kernel.getHeight());
+    int const nBand = (goodBBox.getHeight() + bandHeight - 1) / bandHeight;
+
+    LOGL_DEBUG("TRACE4.afw.math.convolve.convolveWithBasisKernels",
+               "convolveWithBasisKernels: %d basis kernels, %d bands", kernel.getNBasisKernels(), nBand);
+
+    parallelFor(0, nBand, convolutionControl.getNumThreads(), [&](int const bandBegin, int const bandEnd) {
+        BasisKernels const basis(kernel, doCrossTerms);
+        for (int band = bandBegin; band < bandEnd; ++band) {
+            BasisChunk const chunk(kernel, goodBBox, inImage.getXY0(), band * bandHeight,
+                                   std::min((band + 1) * bandHeight, goodBBox.getHeight()));
+            convolveChunkWithBasisKernels(convolvedImage, inImage, basis, chunk, basisControl,
+                                          convolutionControl.getDoNormalize());
+        }
+    });
+}
+
 /*
  * Explicit instantiation
  */
@@ -447,7 +1200,12 @@ void convolveWithBruteForce(OutImageT& convolvedImage, InImageT const& inImage,
     NL template void basicConvolve(IMGMACRO(OUTPIXTYPE)&, IMGMACRO(INPIXTYPE) const &,                     \
                                    math::SeparableKernel const&, math::ConvolutionControl const&);         \
     NL template void convolveWithBruteForce(IMGMACRO(OUTPIXTYPE)&, IMGMACRO(INPIXTYPE) const &,            \
-                                            math::Kernel const&, math::ConvolutionControl const&);
+                                            math::Kernel const&, math::ConvolutionControl const&);         \
+    NL template void convolveWithFft(IMGMACRO(OUTPIXTYPE)&, IMGMACRO(INPIXTYPE) const &,                   \
+                                     math::Kernel const&, math::ConvolutionControl const&);                \
+    NL template void convolveWithBasisKernels(IMGMACRO(OUTPIXTYPE)&, IMGMACRO(INPIXTYPE) const &,          \
+                                              math::LinearCombinationKernel const&,                        \
+                                              math::ConvolutionControl const&);
 // Instantiate both Image and MaskedImage versions
 #define INSTANTIATE(OUTPIXTYPE, INPIXTYPE)             \
     INSTANTIATE_IM_OR_MI(IMAGE, OUTPIXTYPE, INPIXTYPE) \
@@ -38,6 +38,7 @@
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/math/detail/Convolve.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace pexExcept = lsst::pex::exceptions;
 
@@ -76,17 +77,22 @@ void convolveWithInterpolation(OutImageT &outImage, InImageT const &inImage, mat
     LOGL_DEBUG("TRACE3.afw.math.convolve.convolveWithInterpolation",
                "convolveWithInterpolation: divide into %d x %d subregions", nx, ny);
 
-    ConvolveWithInterpolationWorkingImages workingImages(kernel.getDimensions());
     RowOfKernelImagesForRegion regionRow(nx, ny);
     while (goodRegion.computeNextRow(regionRow)) {
-        for (RowOfKernelImagesForRegion::ConstIterator rgnIter = regionRow.begin(), rgnEnd = regionRow.end();
-             rgnIter != rgnEnd; ++rgnIter) {
-            LOGL_DEBUG("TRACE5.afw.math.convolve.convolveWithInterpolation",
-                       "convolveWithInterpolation: bbox minimum=(%d, %d), extent=(%d, %d)",
-                       (*rgnIter)->getBBox().getMinX(), (*rgnIter)->getBBox().getMinY(),
-                       (*rgnIter)->getBBox().getWidth(), (*rgnIter)->getBBox().getHeight());
-            convolveRegionWithInterpolation(outImage, inImage, **rgnIter, workingImages);
-        }
+        // computeNextRow computes all the kernel images of the row, and convolveRegionWithInterpolation
+        // only reads them and writes the pixels of its own region, so the regions of a row are independent
+        parallelFor(0, regionRow.getNX(), convolutionControl.getNumThreads(),
+                    [&](int const regionBegin, int const regionEnd) {
+                        ConvolveWithInterpolationWorkingImages workingImages(kernel.getDimensions());
+                        for (int i = regionBegin; i < regionEnd; ++i) {
+                            KernelImagesForRegion const &region = *regionRow.getRegion(i);
+                            LOGL_DEBUG("TRACE5.afw.math.convolve.convolveWithInterpolation",
+                                       "convolveWithInterpolation: bbox minimum=(%d, %d), extent=(%d, %d)",
+                                       region.getBBox().getMinX(), region.getBBox().getMinY(),
+                                       region.getBBox().getWidth(), region.getBBox().getHeight());
+                            convolveRegionWithInterpolation(outImage, inImage, region, workingImages);
+                        }
+                    });
     }
 }
 
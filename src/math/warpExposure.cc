@@ -25,6 +25,7 @@
  * Support for warping an %image to a new Wcs.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
@@ -48,6 +49,7 @@
 #include "lsst/afw/geom.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/image/PhotoCalib.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/math/detail/WarpAtOnePoint.h"
 
 namespace pexExcept = lsst::pex::exceptions;
@@ -95,7 +97,9 @@ static inline void checkWarpingKernelParameter(const SeparableKernel *p, unsigne
 }
 
 std::shared_ptr<Kernel> LanczosWarpingKernel::clone() const {
-    return std::shared_ptr<Kernel>(new LanczosWarpingKernel(this->getOrder()));
+    std::shared_ptr<LanczosWarpingKernel> retPtr(new LanczosWarpingKernel(this->getOrder()));
+    retPtr->copyCtrAndCache(*this);
+    return retPtr;
 }
 
 int LanczosWarpingKernel::getOrder() const { return this->getWidth() / 2; }
@@ -106,7 +110,9 @@ void LanczosWarpingKernel::setKernelParameter(unsigned int ind, double value) co
 }
 
 std::shared_ptr<Kernel> BilinearWarpingKernel::clone() const {
-    return std::shared_ptr<Kernel>(new BilinearWarpingKernel());
+    std::shared_ptr<BilinearWarpingKernel> retPtr(new BilinearWarpingKernel());
+    retPtr->copyCtrAndCache(*this);
+    return retPtr;
 }
 
 Kernel::Pixel BilinearWarpingKernel::BilinearFunction1::operator()(double x) const {
@@ -138,7 +144,9 @@ std::string BilinearWarpingKernel::BilinearFunction1::toString(std::string const
 }
 
 std::shared_ptr<Kernel> NearestWarpingKernel::clone() const {
-    return std::make_shared<NearestWarpingKernel>();
+    auto retPtr = std::make_shared<NearestWarpingKernel>();
+    retPtr->copyCtrAndCache(*this);
+    return retPtr;
 }
 
 Kernel::Pixel NearestWarpingKernel::NearestFunction1::operator()(double x) const {
@@ -277,6 +285,91 @@ inline double computeRelativeArea(
     return std::abs(dSrcA.getX() * dSrcB.getY() - dSrcA.getY() * dSrcB.getX());
 }
 
+// Smallest interpolation length tried when choosing one to meet WarpingControl::getMaxInterpError
+int const MIN_ADAPTIVE_INTERP_LENGTH = 4;
+
+/*
+ * Return the edges of the interpolation bands along one axis of the destination image:
+ * -1, -1 + interpLength, -1 + 2 interpLength, ..., size - 1 (the last band may be narrower)
+ */
+std::vector<int> computeInterpEdges(int size, int interpLength) {
+    std::vector<int> edgeList;
+    edgeList.reserve(2 + (size - 1) / interpLength);
+    for (int edge = -1; edge < size - 1; edge += interpLength) {
+        edgeList.push_back(edge);
+    }
+    edgeList.push_back(size - 1);
+    return edgeList;
+}
+
+/*
+ * Return the largest error (source pixels) of bilinearly interpolating the source position over the cells
+ * of an interpolation grid, as warpImage does, measured at the center of each cell
+ *
+ * Return NaN if the transform is not finite at any of the points.
+ */
+double computeMaxInterpError(geom::TransformPoint2ToPoint2 const &localDestToParentSrc, int destWidth,
+                             int destHeight, int interpLength) {
+    std::vector<int> const edgeColList = computeInterpEdges(destWidth, interpLength);
+    std::vector<int> const edgeRowList = computeInterpEdges(destHeight, interpLength);
+    int const numCols = edgeColList.size();
+    int const numRows = edgeRowList.size();
+
+    std::vector<lsst::geom::Point2D> cornerList;
+    cornerList.reserve(numCols * numRows);
+    for (int const edgeRow : edgeRowList) {
+        for (int const edgeCol : edgeColList) {
+            cornerList.emplace_back(edgeCol, edgeRow);
+        }
+    }
+    std::vector<lsst::geom::Point2D> centerList;
+    centerList.reserve((numCols - 1) * (numRows - 1));
+    for (int i = 1; i < numRows; ++i) {
+        for (int j = 1; j < numCols; ++j) {
+            centerList.emplace_back(0.5 * (edgeColList[j - 1] + edgeColList[j]),
+                                    0.5 * (edgeRowList[i - 1] + edgeRowList[i]));
+        }
+    }
+    auto const srcCornerList = localDestToParentSrc.applyForward(cornerList);
+    auto const srcCenterList = localDestToParentSrc.applyForward(centerList);
+
+    double maxError = 0;
+    for (int i = 1, center = 0; i < numRows; ++i) {
+        for (int j = 1; j < numCols; ++j, ++center) {
+            lsst::geom::Extent2D const cornerSum =
+                    lsst::geom::Extent2D(srcCornerList[(i - 1) * numCols + j - 1]) +
+                    lsst::geom::Extent2D(srcCornerList[(i - 1) * numCols + j]) +
+                    lsst::geom::Extent2D(srcCornerList[i * numCols + j - 1]) +
+                    lsst::geom::Extent2D(srcCornerList[i * numCols + j]);
+            lsst::geom::Extent2D const interpSrcPos = cornerSum * 0.25;
+            double const error = (lsst::geom::Extent2D(srcCenterList[center]) - interpSrcPos).computeNorm();
+            if (!std::isfinite(error)) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            maxError = std::max(maxError, error);
+        }
+    }
+    return maxError;
+}
+
+/*
+ * Return the largest interpolation length, found by repeatedly halving maxInterpLength, for which
+ * interpolating the source position is accurate to maxInterpError; 0 (no interpolation) if none is
+ * at least MIN_ADAPTIVE_INTERP_LENGTH
+ */
+int chooseInterpLength(geom::TransformPoint2ToPoint2 const &localDestToParentSrc, int destWidth,
+                       int destHeight, int maxInterpLength, double maxInterpError) {
+    for (int interpLength = maxInterpLength; interpLength >= MIN_ADAPTIVE_INTERP_LENGTH; interpLength /= 2) {
+        double const error = computeMaxInterpError(localDestToParentSrc, destWidth, destHeight, interpLength);
+        LOGL_DEBUG("TRACE3.afw.math.warp", "interpLength=%d has maximum interpolation error %g", interpLength,
+                   error);
+        if (error <= maxInterpError) {
+            return interpLength;
+        }
+    }
+    return 0;
+}
+
 }  // namespace
 
 template <typename DestImageT, typename SrcImageT>
@@ -333,13 +426,68 @@ int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
     int const destHeight = destImage.getHeight();
     LOGL_DEBUG("TRACE2.afw.math.warp", "remap image width=%d; height=%d", destWidth, destHeight);
 
+    if (interpLength > 0 && control.getMaxInterpError() > 0) {
+        interpLength = chooseInterpLength(*localDestToParentSrc, destWidth, destHeight, interpLength,
+                                          control.getMaxInterpError());
+        LOGL_DEBUG("TRACE2.afw.math.warp", "using interpLength=%d for maxInterpError=%g", interpLength,
+                   control.getMaxInterpError());
+    }
+
     // Set each pixel of destExposure's MaskedImage
     LOGL_DEBUG("TRACE3.afw.math.warp", "Remapping masked image");
 
     int const maxCol = destWidth - 1;
     int const maxRow = destHeight - 1;
 
-    detail::WarpAtOnePoint<DestImageT, SrcImageT> warpAtOnePoint(srcImage, control, padValue);
+    // Source positions and relative areas are computed on this thread (the transform's AST objects must
+    // not be shared between threads) one block of rows at a time; the rows of each block are then warped
+    // in parallel, each thread using its own WarpAtOnePoint. Blocks are whole interpolation bands.
+    int const nThreads = detail::getNumThreads(control.getNumThreads());
+    int const blockUnit = std::max(interpLength, 1);
+    int const blockHeight = std::min(blockUnit * ((16 * nThreads + blockUnit - 1) / blockUnit), destHeight);
+    LOGL_DEBUG("TRACE3.afw.math.warp", "Warping blocks of %d rows using %d threads", blockHeight, nThreads);
+
+    // Update the kernel caches, if necessary, before the threads clone the kernels
+    control.getMaskWarpingKernel();
+
+    std::vector<lsst::geom::Point2D> srcPosBlock(static_cast<std::size_t>(blockHeight) * destWidth);
+    std::vector<double> relativeAreaBlock(srcPosBlock.size());
+    std::vector<int> numGoodPixelsBlock(blockHeight);
+    int blockBegin = 0;
+
+    // Record the source position and relative area of one destination pixel
+    auto const setSrcPos = [&](int col, int row, lsst::geom::Point2D const &srcPos, double relativeArea) {
+        std::size_t const blockIndex = static_cast<std::size_t>(row - blockBegin) * destWidth + col;
+        srcPosBlock[blockIndex] = srcPos;
+        relativeAreaBlock[blockIndex] = relativeArea;
+    };
+
+    // Call once all the source positions of a row have been set; warps the block if the row ends it
+    auto const finishRow = [&](int row) {
+        if (row + 1 - blockBegin < blockHeight && row < maxRow) {
+            return;
+        }
+        detail::parallelFor(blockBegin, row + 1, nThreads, [&](int bandBegin, int bandEnd) {
+            detail::WarpAtOnePoint<DestImageT, SrcImageT> warpAtOnePoint(srcImage, control, padValue);
+            for (int bandRow = bandBegin; bandRow < bandEnd; ++bandRow) {
+                std::size_t const blockIndex = static_cast<std::size_t>(bandRow - blockBegin) * destWidth;
+                int numGoodRowPixels = 0;
+                typename DestImageT::x_iterator destXIter = destImage.row_begin(bandRow);
+                for (int col = 0; col < destWidth; ++col, ++destXIter) {
+                    if (warpAtOnePoint(destXIter, srcPosBlock[blockIndex + col],
+                                       relativeAreaBlock[blockIndex + col],
+                                       typename image::detail::image_traits<DestImageT>::image_category())) {
+                        ++numGoodRowPixels;
+                    }
+                }
+                numGoodPixelsBlock[bandRow - blockBegin] = numGoodRowPixels;
+            }
+        });
+        for (int blockRow = blockBegin; blockRow <= row; ++blockRow) {
+            numGoodPixels += numGoodPixelsBlock[blockRow - blockBegin];
+        }
+        blockBegin = row + 1;
+    };
 
     if (interpLength > 0) {
         // Use interpolation. Note that 1 produces the same result as no interpolation
@@ -434,7 +582,6 @@ int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
             }
 
             for (int row = prevEndRow + 1; row <= endRow; ++row) {
-                typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
                 srcPosView[-1] += yDeltaSrcPosList[0];
                 for (int colBand = 1, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
                     // Next vertical interpolation band
@@ -449,20 +596,17 @@ int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
                     lsst::geom::Point2D rightSrcPos = srcPosView[endCol] + yDeltaSrcPosList[colBand];
                     lsst::geom::Extent2D xDeltaSrcPos = (rightSrcPos - leftSrcPos) * invWidthList[colBand];
 
-                    for (int col = prevEndCol + 1; col <= endCol; ++col, ++destXIter) {
+                    for (int col = prevEndCol + 1; col <= endCol; ++col) {
                         lsst::geom::Point2D leftSrcPos = srcPosView[col - 1];
                         lsst::geom::Point2D srcPos = leftSrcPos + xDeltaSrcPos;
                         double relativeArea = computeRelativeArea(srcPos, leftSrcPos, srcPosView[col]);
 
                         srcPosView[col] = srcPos;
 
-                        if (warpAtOnePoint(
-                                    destXIter, srcPos, relativeArea,
-                                    typename image::detail::image_traits<DestImageT>::image_category())) {
-                            ++numGoodPixels;
-                        }
+                        setSrcPos(col, row, srcPos, relativeArea);
                     }  // for col
                 }      // for col band
+                finishRow(row);
             }          // for row
         }              // while next row band
 
@@ -485,18 +629,15 @@ int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
             }
             auto srcPosList = localDestToParentSrc->applyForward(destPosList);
 
-            typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
-            for (int col = 0; col < destWidth; ++col, ++destXIter) {
+            for (int col = 0; col < destWidth; ++col) {
                 // column index = column + 1 because the first entry in srcPosList is for column -1
                 auto srcPos = srcPosList[col + 1];
                 double relativeArea =
                         computeRelativeArea(srcPos, prevSrcPosList[col], prevSrcPosList[col + 1]);
 
-                if (warpAtOnePoint(destXIter, srcPos, relativeArea,
-                                   typename image::detail::image_traits<DestImageT>::image_category())) {
-                    ++numGoodPixels;
-                }
+                setSrcPos(col, row, srcPos, relativeArea);
             }  // for col
+            finishRow(row);
             // move points from srcPosList to prevSrcPosList (we don't care about what ends up in srcPosList
             // because it will be reallocated anyway)
             swap(srcPosList, prevSrcPosList);
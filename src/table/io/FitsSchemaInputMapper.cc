@@ -4,7 +4,10 @@
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
+#include <map>
+#include <set>
 #include <string>
+#include <type_traits>
 #include <algorithm>
 #include <cctype>
 
@@ -19,6 +22,8 @@
 #include "lsst/geom.h"
 #include "lsst/afw/table/io/FitsSchemaInputMapper.h"
 #include "lsst/afw/table/aggregates.h"
+#include "lsst/afw/table/detail/BigEndian.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace lsst {
 namespace afw {
@@ -41,6 +46,55 @@ private:
     std::string const &_v;
 };
 
+// Set nBytes to the number of bytes a binary table column with the given TFORM occupies in each row,
+// returning false if we don't recognize the format.
+bool getColumnBytes(std::string const &tform, std::size_t &nBytes) {
+    static boost::regex const regex("(\\d+)?([PQ])?(\\u)\\(?(\\d)*\\)?", boost::regex::perl);
+    boost::smatch m;
+    if (!boost::regex_match(tform, m, regex)) {
+        return false;
+    }
+    std::size_t const repeat = m[1].matched ? std::stoul(m[1].str()) : 1;
+    if (m[2].matched) {
+        // variable-length columns hold a descriptor into the heap
+        nBytes = m[2].str() == "P" ? 8 : 16;
+        return true;
+    }
+    switch (m[3].str()[0]) {
+        case 'X':
+            nBytes = (repeat + 7) / 8;
+            return true;
+        case 'L':
+        case 'B':
+        case 'A':
+            nBytes = repeat;
+            return true;
+        case 'I':
+            nBytes = 2 * repeat;
+            return true;
+        case 'J':
+        case 'E':
+            nBytes = 4 * repeat;
+            return true;
+        case 'K':
+        case 'D':
+        case 'C':
+            nBytes = 8 * repeat;
+            return true;
+        case 'M':
+            nBytes = 16 * repeat;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// We only unpack unsigned 16-bit columns stored with TZERO=32768 (see RawColumnReader::getZero).
+using detail::unpackBigEndian;
+
+// Size of the blocks of raw rows read by FitsSchemaInputMapper::readRecords.
+std::size_t const RAW_READ_BYTES = 1 << 22;
+
 }  // namespace
 
 class FitsSchemaInputMapper::Impl {
@@ -93,10 +147,18 @@ public:
     std::shared_ptr<io::InputArchive> archive;
     InputContainer inputs;
     std::size_t nRowsToPrep = 1;
+    std::vector<std::string> selectedFields;
+    std::vector<std::size_t> columnOffsets;  // byte offset of each column in a row
+    std::vector<std::size_t> columnBytes;    // bytes each column occupies in a row
+    std::size_t rowBytes = 0;                // bytes in each row, or 0 if we don't understand the layout
+    std::map<int, double> columnZeros;       // TZEROn values, by column
+    std::map<int, double> columnScales;      // TSCALn values, by column
 };
 
 std::size_t FitsSchemaInputMapper::PREPPED_ROWS_FACTOR = 1 << 15;  // determined empirically; see DM-19461.
 
+int FitsSchemaInputMapper::NUM_READ_THREADS = 1;
+
 FitsSchemaInputMapper::FitsSchemaInputMapper(daf::base::PropertyList &metadata, bool stripMetadata)
         : _impl(std::make_shared<Impl>()) {
     // Set the table version.  If AFW_TABLE_VERSION tag exists, use that
@@ -244,10 +306,12 @@ FitsSchemaInputMapper::FitsSchemaInputMapper(daf::base::PropertyList &metadata,
                 metadata.remove(*key);
             }
         } else if (key->compare(0, 5, "TZERO") == 0) {
+            _impl->columnZeros[std::stoi(key->substr(5)) - 1] = metadata.getAsDouble(*key);
             if (stripMetadata) {
                 metadata.remove(*key);
             }
         } else if (key->compare(0, 5, "TSCAL") == 0) {
+            _impl->columnScales[std::stoi(key->substr(5)) - 1] = metadata.getAsDouble(*key);
             if (stripMetadata) {
                 metadata.remove(*key);
             }
@@ -262,6 +326,25 @@ FitsSchemaInputMapper::FitsSchemaInputMapper(daf::base::PropertyList &metadata,
         }
     }
 
+    // Compute the byte offset of each column in a row, so readRecords can unpack columns from raw rows.
+    // If any column is missing or has a format we don't recognize, readRecords won't try.
+    for (auto const &item : _impl->byColumn()) {
+        std::size_t nBytes = 0;
+        if (item.column < 0) {
+            continue;  // Flag field
+        }
+        if (static_cast<std::size_t>(item.column) != _impl->columnOffsets.size() ||
+            !getColumnBytes(item.tform, nBytes)) {
+            _impl->columnOffsets.clear();
+            _impl->columnBytes.clear();
+            _impl->rowBytes = 0;
+            break;
+        }
+        _impl->columnOffsets.push_back(_impl->rowBytes);
+        _impl->columnBytes.push_back(nBytes);
+        _impl->rowBytes += nBytes;
+    }
+
     // Find the column used to store flags, and setup the flag-handling data members from it.
     _impl->flagColumn = metadata.get("FLAGCOL", 0);
     if (_impl->flagColumn > 0) {
@@ -365,10 +448,37 @@ void FitsSchemaInputMapper::customize(std::unique_ptr<FitsColumnReader> reader)
     _impl->readers.push_back(std::move(reader));
 }
 
+void FitsSchemaInputMapper::selectFields(std::vector<std::string> const &names) {
+    _impl->selectedFields = names;
+}
+
 namespace {
 
+// Interface for the FitsColumnReaders that can unpack their column from raw binary table rows, which
+// lets readRecords read many rows with a single CFITSIO call.
+class RawColumnReader {
+public:
+    // Return the (0-indexed) column read by this reader.
+    virtual int getColumn() const = 0;
+
+    // Return the TZEROn value unpackCells expects; if the column has a different one, or a TSCALn
+    // other than 1, the column is read by CFITSIO instead.
+    virtual double getZero() const { return 0.0; }
+
+    // Return the number of bytes unpackCells expects the column to occupy in each row; if the column's
+    // TFORM says otherwise (e.g. a 64-bit integer array read into a float field), the column is read by
+    // CFITSIO instead.
+    virtual std::size_t getCellBytes() const = 0;
+
+    // Unpack the column at the given byte offset from nRows consecutive rows into records.
+    virtual void unpackCells(BaseRecord *const *records, std::size_t nRows, unsigned char const *rows,
+                             std::size_t rowBytes, std::size_t offset) const = 0;
+
+    virtual ~RawColumnReader() = default;
+};
+
 template <typename T>
-class StandardReader : public FitsColumnReader {
+class StandardReader : public FitsColumnReader, public RawColumnReader {
 public:
     static std::unique_ptr<FitsColumnReader> make(Schema &schema, FitsSchemaItem const &item,
                                                   FieldBase<T> const &base = FieldBase<T>()) {
@@ -404,6 +514,24 @@ public:
         }
     }
 
+    int getColumn() const override { return _column; }
+
+    double getZero() const override {
+        return std::is_same<typename FieldBase<T>::Element, std::uint16_t>::value ? 32768.0 : 0.0;
+    }
+
+    std::size_t getCellBytes() const override {
+        return sizeof(typename FieldBase<T>::Element) * _key.getElementCount();
+    }
+
+    void unpackCells(BaseRecord *const *records, std::size_t nRows, unsigned char const *rows,
+                     std::size_t rowBytes, std::size_t offset) const override {
+        for (std::size_t i = 0; i < nRows; ++i) {
+            unpackBigEndian(rows + i * rowBytes + offset, _key.getElementCount(),
+                            records[i]->getElement(_key));
+        }
+    }
+
 private:
     int _column;
     Key<T> _key;
@@ -412,7 +540,7 @@ private:
     std::size_t _nRowsToPrep;
 };
 
-class AngleReader : public FitsColumnReader {
+class AngleReader : public FitsColumnReader, public RawColumnReader {
 public:
     static std::unique_ptr<FitsColumnReader> make(
             Schema &schema, FitsSchemaItem const &item,
@@ -453,6 +581,19 @@ public:
         }
     }
 
+    int getColumn() const override { return _column; }
+
+    std::size_t getCellBytes() const override { return sizeof(double); }
+
+    void unpackCells(BaseRecord *const *records, std::size_t nRows, unsigned char const *rows,
+                     std::size_t rowBytes, std::size_t offset) const override {
+        for (std::size_t i = 0; i < nRows; ++i) {
+            double value = 0;
+            unpackBigEndian(rows + i * rowBytes + offset, 1, &value);
+            records[i]->set(_key, value * lsst::geom::radians);
+        }
+    }
+
 private:
     int _column;
     Key<lsst::geom::Angle> _key;
@@ -845,8 +986,18 @@ Schema FitsSchemaInputMapper::finalize() {
             }
         }
     }
+    // Resolve the selected field names (if any); we remove them from this set as we find them.
+    std::set<std::string> selected;
+    for (auto const &name : _impl->selectedFields) {
+        selected.insert(_impl->schema.getAliasMap()->apply(name));
+    }
+    bool const selectAll = selected.empty();
     for (auto iter = _impl->asList().begin(); iter != _impl->asList().end(); ++iter) {
+        bool const isSelected = selectAll || selected.erase(iter->ttype) > 0;
         if (iter->bit < 0) {  // not a Flag column
+            if (!isSelected) {
+                continue;
+            }
             std::unique_ptr<FitsColumnReader> reader = makeColumnReader(_impl->schema, *iter);
             if (reader) {
                 _impl->readers.push_back(std::move(reader));
@@ -862,10 +1013,17 @@ Schema FitsSchemaInputMapper::finalize() {
                                    iter->ttype % iter->bit % _impl->flagKeys.size())
                                           .str());
             }
-            _impl->flagKeys[iter->bit] = _impl->schema.addField<Flag>(iter->ttype, iter->doc);
+            if (isSelected) {  // unselected flags keep an invalid Key, so we don't read them
+                _impl->flagKeys[iter->bit] = _impl->schema.addField<Flag>(iter->ttype, iter->doc);
+            }
         }
     }
     _impl->asList().clear();
+    if (!selected.empty()) {
+        throw LSST_EXCEPT(pex::exceptions::NotFoundError,
+                          (boost::format("Selected field '%s' not found in FITS table") % *selected.begin())
+                                  .str());
+    }
     if (_impl->schema.getRecordSize() <= 0) {
         throw LSST_EXCEPT(
             pex::exceptions::LengthError,
@@ -881,7 +1039,9 @@ void FitsSchemaInputMapper::readRecord(BaseRecord &record, afw::fits::Fits &fits
     if (!_impl->flagKeys.empty()) {
         fits.readTableArray<bool>(row, _impl->flagColumn, _impl->flagKeys.size(), _impl->flagWorkspace.get());
         for (std::size_t bit = 0; bit < _impl->flagKeys.size(); ++bit) {
-            record.set(_impl->flagKeys[bit], _impl->flagWorkspace[bit]);
+            if (_impl->flagKeys[bit].isValid()) {
+                record.set(_impl->flagKeys[bit], _impl->flagWorkspace[bit]);
+            }
         }
     }
     if (_impl->nRowsToPrep != 1 && row % _impl->nRowsToPrep == 0) {
@@ -896,6 +1056,82 @@ void FitsSchemaInputMapper::readRecord(BaseRecord &record, afw::fits::Fits &fits
         reader->readCell(record, row, fits, _impl->archive);
     }
 }
+
+void FitsSchemaInputMapper::readRecords(std::vector<BaseRecord *> const &records, afw::fits::Fits &fits,
+                                        std::size_t firstRow) {
+    if (records.empty()) {
+        return;
+    }
+    // Sort the readers into those that can unpack their columns from raw rows and those that can't.
+    bool const haveLayout = _impl->rowBytes > 0 && _impl->rowBytes == fits.getTableRowBytes();
+    std::vector<RawColumnReader const *> rawReaders;
+    std::vector<FitsColumnReader *> otherReaders;
+    for (auto const &reader : _impl->readers) {
+        auto raw = haveLayout ? dynamic_cast<RawColumnReader const *>(reader.get()) : nullptr;
+        if (raw) {
+            int const column = raw->getColumn();
+            auto zero = _impl->columnZeros.find(column);
+            auto scale = _impl->columnScales.find(column);
+            if (_impl->columnBytes[column] != raw->getCellBytes() ||
+                (zero == _impl->columnZeros.end() ? 0.0 : zero->second) != raw->getZero() ||
+                (scale != _impl->columnScales.end() && scale->second != 1.0)) {
+                raw = nullptr;
+            }
+        }
+        if (raw) {
+            rawReaders.push_back(raw);
+        } else {
+            otherReaders.push_back(reader.get());
+        }
+    }
+    bool const rawFlags = haveLayout && !_impl->flagKeys.empty();
+    if (rawReaders.empty() && !rawFlags) {
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            readRecord(*records[i], fits, firstRow + i);
+        }
+        return;
+    }
+
+    std::size_t const rowBytes = _impl->rowBytes;
+    std::size_t const blockRows =
+            std::min(std::max<std::size_t>(1, RAW_READ_BYTES / rowBytes), records.size());
+    std::vector<unsigned char> buffer(blockRows * rowBytes);
+    int const nTasks = rawReaders.size() + (rawFlags ? 1 : 0);
+    for (std::size_t begin = 0; begin < records.size(); begin += blockRows) {
+        std::size_t const nRows = std::min(blockRows, records.size() - begin);
+        BaseRecord *const *block = records.data() + begin;
+        fits.readTableBytes(firstRow + begin, nRows * rowBytes, buffer.data());
+        // Each column (including the flags column) is unpacked into different parts of the records, so we
+        // can unpack them in parallel.
+        math::detail::parallelFor(0, nTasks, NUM_READ_THREADS, [&](int taskBegin, int taskEnd) {
+            for (int task = taskBegin; task < taskEnd; ++task) {
+                if (static_cast<std::size_t>(task) < rawReaders.size()) {
+                    RawColumnReader const *reader = rawReaders[task];
+                    reader->unpackCells(block, nRows, buffer.data(), rowBytes,
+                                        _impl->columnOffsets[reader->getColumn()]);
+                    continue;
+                }
+                std::size_t const offset = _impl->columnOffsets[_impl->flagColumn];
+                for (std::size_t i = 0; i < nRows; ++i) {
+                    unsigned char const *bits = buffer.data() + i * rowBytes + offset;
+                    for (std::size_t bit = 0; bit < _impl->flagKeys.size(); ++bit) {
+                        if (_impl->flagKeys[bit].isValid()) {
+                            block[i]->set(_impl->flagKeys[bit], (bits[bit / 8] & (0x80 >> (bit % 8))) != 0);
+                        }
+                    }
+                }
+            }
+        });
+        for (auto reader : otherReaders) {
+            reader->prepRead(firstRow + begin, nRows, fits);
+        }
+        for (std::size_t i = 0; i < nRows; ++i) {
+            for (auto reader : otherReaders) {
+                reader->readCell(*block[i], firstRow + begin + i, fits, _impl->archive);
+            }
+        }
+    }
+}
 }  // namespace io
 }  // namespace table
 }  // namespace afw
@@ -1,10 +1,16 @@
 // -*- lsst-c++ -*-
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 #include "lsst/afw/table/io/FitsWriter.h"
 #include "lsst/afw/table/BaseTable.h"
 #include "lsst/afw/table/BaseRecord.h"
+#include "lsst/afw/table/detail/BigEndian.h"
 
 namespace lsst {
 namespace afw {
@@ -97,6 +103,55 @@ void writeAliasMap(Fits& fits, AliasMap const& aliases) {
     }
 }
 
+//----- Code to pack records into FITS binary table rows ----------------------------------------------------
+
+// Size of the buffer of packed rows written in each call to Fits::writeTableBytes.
+std::size_t const PACK_BUFFER_BYTES = 1 << 22;
+
+using detail::packBigEndian;
+
+// Angles are stored as radians.
+unsigned char* packBigEndian(lsst::geom::Angle const* values, int n, unsigned char* out) {
+    for (int i = 0; i < n; ++i) {
+        double const value = values[i].asRadians();
+        out = packBigEndian(&value, 1, out);
+    }
+    return out;
+}
+
+// A Schema::forEach functor that computes the number of bytes in a binary table row written by
+// FitsWriter::PackRecords, or zero if the schema has variable-length fields.
+struct ComputeRowBytes {
+    template <typename T>
+    void operator()(SchemaItem<T> const& item) const {
+        nBytes += item.key.getElementCount() * sizeof(typename Field<T>::Element);
+    }
+
+    template <typename T>
+    void operator()(SchemaItem<Array<T> > const& item) const {
+        isVariableLength |= item.key.isVariableLength();
+        nBytes += item.key.getElementCount() * sizeof(T);
+    }
+
+    void operator()(SchemaItem<lsst::geom::Angle> const& item) const { nBytes += sizeof(double); }
+
+    void operator()(SchemaItem<std::string> const& item) const {
+        isVariableLength |= item.key.isVariableLength();
+        nBytes += item.key.getElementCount();
+    }
+
+    void operator()(SchemaItem<Flag> const& item) const {}
+
+    static std::size_t apply(Schema const& schema, int nFlags) {
+        ComputeRowBytes f = {(nFlags + 7) / 8, false};
+        schema.forEach(f);
+        return f.isVariableLength ? 0 : f.nBytes;
+    }
+
+    mutable std::size_t nBytes;
+    mutable bool isVariableLength;
+};
+
 }  // namespace
 
 // the driver for all the above machinery
@@ -122,7 +177,17 @@ void FitsWriter::_writeTable(std::shared_ptr<BaseTable const> const& table, std:
     metadata->remove("AFW_TABLE_VERSION");
     _row = -1;
     _fits->addRows(nRows);
-    _processor = std::make_shared<ProcessRecords>(_fits, schema, nFlags, _row);
+    // Pack the records into rows in memory and write them many at a time, unless there are
+    // variable-length fields (which go in the heap), or (as a precaution) our idea of the row
+    // layout doesn't match cfitsio's.
+    std::size_t const rowBytes = ComputeRowBytes::apply(schema, nFlags);
+    if (nRows > 0 && rowBytes > 0 && rowBytes == _fits->getTableRowBytes()) {
+        _processor.reset();
+        _packer = std::make_shared<PackRecords>(_fits, schema, nFlags, rowBytes, nRows);
+    } else {
+        _packer.reset();
+        _processor = std::make_shared<ProcessRecords>(_fits, schema, nFlags, _row);
+    }
 }
 
 //----- Code for writing FITS records -----------------------------------------------------------------------
@@ -186,9 +251,89 @@ struct FitsWriter::ProcessRecords {
     Schema schema;
 };
 
+// A Schema::forEach functor that packs records into a buffer of FITS binary table rows, which it
+// writes with a single call to Fits::writeTableBytes whenever the buffer is full.
+// Each row is the flag bits (if any) followed by each field, in the order ProcessSchema added
+// their columns, so this can only be used for schemas without variable-length fields.
+struct FitsWriter::PackRecords {
+    template <typename T>
+    void operator()(SchemaItem<T> const& item) const {
+        out = packBigEndian(record->getElement(item.key), item.key.getElementCount(), out);
+    }
+
+    void operator()(SchemaItem<std::string> const& item) const {
+        // Like cfitsio, truncate long strings and pad short ones with nulls
+        std::string const value = record->get(item.key);
+        std::size_t const size = item.key.getElementCount();
+        std::copy_n(value.c_str(), std::min(size, std::strlen(value.c_str())), out);
+        out += size;
+    }
+
+    void operator()(SchemaItem<Flag> const& item) const {
+        if (record->get(item.key)) {
+            rowBegin[bit / 8] |= 0x80 >> (bit % 8);
+        }
+        ++bit;
+    }
+
+    PackRecords(Fits* fits_, Schema const& schema_, int nFlags_, std::size_t rowBytes_, std::size_t nRows)
+            : rowBytes(rowBytes_),
+              maxRows(std::min(nRows, std::max<std::size_t>(1, PACK_BUFFER_BYTES / rowBytes_))),
+              nBuffered(0),
+              firstRow(0),
+              nFlags(nFlags_),
+              fits(fits_),
+              buffer(maxRows * rowBytes),
+              schema(schema_) {}
+
+    void apply(BaseRecord const* r) {
+        record = r;
+        rowBegin = &buffer[nBuffered * rowBytes];
+        std::fill(rowBegin, rowBegin + rowBytes, 0);
+        out = rowBegin + (nFlags + 7) / 8;
+        bit = 0;
+        schema.forEach(*this);
+        assert(out == rowBegin + rowBytes);
+        if (++nBuffered == maxRows) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (nBuffered > 0) {
+            fits->writeTableBytes(firstRow, nBuffered * rowBytes, buffer.data());
+            firstRow += nBuffered;
+            nBuffered = 0;
+        }
+    }
+
+    std::size_t rowBytes;         // bytes in each row
+    std::size_t maxRows;          // rows in the buffer
+    std::size_t nBuffered;        // rows in the buffer not yet written
+    std::size_t firstRow;         // row index of the first row in the buffer
+    int nFlags;
+    Fits* fits;
+    std::vector<unsigned char> buffer;
+    unsigned char* rowBegin;      // start of the row being packed
+    mutable unsigned char* out;   // where to pack the next field
+    mutable int bit;              // index of the next flag bit
+    BaseRecord const* record;
+    Schema schema;
+};
+
 void FitsWriter::_writeRecord(BaseRecord const& record) {
     ++_row;
-    _processor->apply(&record);
+    if (_packer) {
+        _packer->apply(&record);
+    } else {
+        _processor->apply(&record);
+    }
+}
+
+void FitsWriter::_flushRecords() {
+    if (_packer) {
+        _packer->flush();
+    }
 }
 }  // namespace io
 }  // namespace table
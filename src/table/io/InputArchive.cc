@@ -1,5 +1,7 @@
 // -*- lsst-c++ -*-
 
+#include <algorithm>
+
 #include "boost/format.hpp"
 
 #include "lsst/pex/exceptions.h"
@@ -31,6 +33,24 @@ struct IndexSortCompare {
     }
 };
 
+// Read the data catalog with the given archive catalog number from the current HDU
+BaseCatalog readDataCatalog(fits::Fits& fitsfile, int catArchive) {
+    BaseCatalog catalog = BaseCatalog::readFits(fitsfile);
+    std::shared_ptr<daf::base::PropertyList> metadata = catalog.getTable()->popMetadata();
+    if (metadata->get<std::string>("EXTTYPE") != "ARCHIVE_DATA") {
+        throw LSST_FITS_EXCEPT(fits::FitsError, fitsfile,
+                               boost::format("Wrong value for archive data EXTTYPE: '%s'") %
+                                       metadata->get<std::string>("EXTTYPE"));
+    }
+    if (metadata->get<int>("AR_CATN") != catArchive) {
+        throw LSST_FITS_EXCEPT(
+                fits::FitsError, fitsfile,
+                boost::format("Incorrect order for archive catalogs: AR_CATN=%d found at position %d") %
+                        metadata->get<int>("AR_CATN") % catArchive);
+    }
+    return catalog;
+}
+
 }  // namespace
 
 // ----- InputArchive::Impl ---------------------------------------------------------------------------------
@@ -82,7 +102,7 @@ public:
                              indexIter->get(indexKeys.id) % catN % _catalogs.size())
                                     .str());
                 }
-                BaseCatalog& fullCatalog = _catalogs[catN];
+                BaseCatalog& fullCatalog = getCatalog(catN);
                 std::size_t i1 = indexIter->get(indexKeys.row0);
                 std::size_t i2 = i1 + indexIter->get(indexKeys.nRows);
                 if (i2 > fullCatalog.size()) {
@@ -134,6 +154,17 @@ public:
         return _map;
     }
 
+    // Return the data catalog with the given (zero-based) number, reading it first if we're lazy
+    BaseCatalog& getCatalog(std::size_t catN) {
+        BaseCatalog& catalog = _catalogs[catN];
+        if (!catalog.getTable()) {
+            assert(_fits);  // only lazy archives have catalogs that haven't been read
+            fits::HduMoveGuard guard(*_fits, _indexHdu + catN + 1);
+            catalog = readDataCatalog(*_fits, catN + 1);
+        }
+        return catalog;
+    }
+
     Impl() : _index(ArchiveIndexSchema::get().schema) {}
 
     Impl(BaseCatalog const& index, CatalogVector const& catalogs) : _index(index), _catalogs(catalogs) {
@@ -144,6 +175,15 @@ public:
         _index.sort(IndexSortCompare());
     }
 
+    // Lazy archive: the data catalogs are placeholders without tables, to be read from the HDUs
+    // following the index HDU when first needed.
+    Impl(BaseCatalog const& index, std::size_t nDataCatalogs, fits::Fits& fitsfile, int indexHdu)
+            : Impl(index, CatalogVector()) {
+        _catalogs.resize(nDataCatalogs);
+        _fits = &fitsfile;
+        _indexHdu = indexHdu;
+    }
+
     // No copying
     Impl(const Impl&) = delete;
     Impl& operator=(const Impl&) = delete;
@@ -155,6 +195,8 @@ public:
     Map _map;
     BaseCatalog _index;
     CatalogVector _catalogs;
+    fits::Fits* _fits = nullptr;  // file to read data catalogs from, if lazy
+    int _indexHdu = 0;            // HDU of the index, if lazy
 };
 
 // ----- InputArchive ---------------------------------------------------------------------------------------
@@ -183,7 +225,8 @@ std::shared_ptr<Persistable> InputArchive::get(int id) const { return _impl->get
 
 InputArchive::Map const& InputArchive::getAll() const { return _impl->getAll(*this); }
 
-InputArchive InputArchive::readFits(fits::Fits& fitsfile) {
+InputArchive InputArchive::readFits(fits::Fits& fitsfile, bool lazy) {
+    int const indexHdu = fitsfile.getHdu();
     BaseCatalog index = BaseCatalog::readFits(fitsfile);
     std::shared_ptr<daf::base::PropertyList> metadata = index.getTable()->popMetadata();
     assert(metadata);  // BaseCatalog::readFits should always read metadata, even if there's nothing there
@@ -193,23 +236,15 @@ InputArchive InputArchive::readFits(fits::Fits& fitsfile) {
                                        metadata->get<std::string>("EXTTYPE"));
     }
     int nCatalogs = metadata->get<int>("AR_NCAT");
+    if (lazy) {
+        std::shared_ptr<Impl> impl(new Impl(index, std::max(nCatalogs - 1, 0), fitsfile, indexHdu));
+        return InputArchive(impl);
+    }
     CatalogVector catalogs;
     catalogs.reserve(nCatalogs);
     for (int n = 1; n < nCatalogs; ++n) {
         fitsfile.setHdu(1, true);  // increment HDU by one
-        catalogs.push_back(BaseCatalog::readFits(fitsfile));
-        metadata = catalogs.back().getTable()->popMetadata();
-        if (metadata->get<std::string>("EXTTYPE") != "ARCHIVE_DATA") {
-            throw LSST_FITS_EXCEPT(fits::FitsError, fitsfile,
-                                   boost::format("Wrong value for archive data EXTTYPE: '%s'") %
-                                           metadata->get<std::string>("EXTTYPE"));
-        }
-        if (metadata->get<int>("AR_CATN") != n) {
-            throw LSST_FITS_EXCEPT(
-                    fits::FitsError, fitsfile,
-                    boost::format("Incorrect order for archive catalogs: AR_CATN=%d found at position %d") %
-                            metadata->get<int>("AR_CATN") % n);
-        }
+        catalogs.push_back(readDataCatalog(fitsfile, n));
     }
     std::shared_ptr<Impl> impl(new Impl(index, catalogs));
     return InputArchive(impl);
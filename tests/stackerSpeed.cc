@@ -0,0 +1,132 @@
+// -*- LSST-C++ -*-
+
+/*
+ * LSST Data Management System
+ * Copyright 2008-2019 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE StackerSpeed
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-variable"
+#include "boost/test/unit_test.hpp"
+#pragma clang diagnostic pop
+
+#include "lsst/geom.h"
+#include "lsst/afw/image/MaskedImage.h"
+#include "lsst/afw/math/Stack.h"
+
+namespace image = lsst::afw::image;
+namespace math = lsst::afw::math;
+
+typedef image::MaskedImage<float> MImageF;
+
+namespace {
+
+std::vector<std::shared_ptr<MImageF>> makeInputs(int nImg, int nX, int nY) {
+    std::mt19937 rng(12345);
+    std::normal_distribution<float> noise(10.0, 1.0);
+    std::uniform_real_distribution<float> uniform(0.0, 1.0);
+    image::MaskPixel const bad = image::Mask<>::getPlaneBitMask("BAD");
+
+    std::vector<std::shared_ptr<MImageF>> mimgList;
+    for (int iImg = 0; iImg < nImg; ++iImg) {
+        auto mimg = std::make_shared<MImageF>(lsst::geom::Extent2I(nX, nY));
+        for (int y = 0; y != nY; ++y) {
+            for (MImageF::x_iterator ptr = mimg->row_begin(y), end = mimg->row_end(y); ptr != end; ++ptr) {
+                float value = noise(rng);
+                if (uniform(rng) < 0.01) {
+                    value += 1000.0;  // an outlier for the clipping to find
+                }
+                ptr.image() = value;
+                ptr.mask() = (uniform(rng) < 0.02) ? bad : 0x0;
+                ptr.variance() = 1.0;
+            }
+        }
+        mimgList.push_back(mimg);
+    }
+    return mimgList;
+}
+
+/// Time one stack, returning the output and the elapsed seconds
+std::pair<std::shared_ptr<MImageF>, double> timeStack(std::vector<std::shared_ptr<MImageF>> &mimgList,
+                                                      math::Property flags,
+                                                      math::StatisticsControl const &sctrl) {
+    auto const start = std::chrono::steady_clock::now();
+    std::shared_ptr<MImageF> stack = math::statisticsStack<float>(mimgList, flags, sctrl);
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+    return std::make_pair(stack, elapsed.count());
+}
+
+void checkIdentical(MImageF const &lhs, MImageF const &rhs) {
+    for (int y = 0; y != lhs.getHeight(); ++y) {
+        MImageF::x_iterator rptr = rhs.row_begin(y);
+        for (MImageF::x_iterator lptr = lhs.row_begin(y), end = lhs.row_end(y); lptr != end; ++lptr, ++rptr) {
+            // compare bit patterns; NaN == NaN here
+            BOOST_REQUIRE_EQUAL(std::memcmp(&lptr.image(), &rptr.image(), sizeof(float)), 0);
+            BOOST_REQUIRE_EQUAL(lptr.mask(), rptr.mask());
+            BOOST_REQUIRE_EQUAL(std::memcmp(&lptr.variance(), &rptr.variance(), sizeof(float)), 0);
+        }
+    }
+}
+
+}  // namespace
+
+/*
+ * Report how statisticsStack scales with the number of threads, for both the per-pixel and the
+ * batched engines, and check that all the outputs are bit-identical to the serial per-pixel result.
+ *
+ * The timings are only reported, not checked, as they depend on the machine.
+ */
+BOOST_AUTO_TEST_CASE(StackerScaling) { /* parasoft-suppress  LsstDm-3-2a LsstDm-3-4a LsstDm-4-6 LsstDm-5-25
+                                          "Boost non-Std" */
+    int const nImg = 32;
+    int const nX = 512;
+    int const nY = 512;
+    std::vector<std::shared_ptr<MImageF>> mimgList = makeInputs(nImg, nX, nY);
+
+    math::StatisticsControl sctrl;
+    sctrl.setAndMask(image::Mask<>::getPlaneBitMask("BAD"));
+
+    for (math::Property flags : {math::MEAN, math::MEANCLIP, math::MEDIAN}) {
+        sctrl.setBatchedStack(false);
+        sctrl.setNumThreads(1);
+        auto const reference = timeStack(mimgList, flags, sctrl);
+
+        for (bool batched : {false, true}) {
+            sctrl.setBatchedStack(batched);
+            for (int nThreads : {1, 2, 4, 8}) {
+                sctrl.setNumThreads(nThreads);
+                auto const result = timeStack(mimgList, flags, sctrl);
+                checkIdentical(*reference.first, *result.first);
+
+                std::cout << "flags=0x" << std::hex << flags << std::dec << " batched=" << batched
+                          << " nThreads=" << nThreads << ": " << result.second << "s (speedup "
+                          << reference.second / result.second << ")" << std::endl;
+            }
+        }
+    }
+}
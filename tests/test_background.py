@@ -676,6 +676,98 @@ class BackgroundTestCase(lsst.utils.tests.TestCase):
 
         self.assertEqual(np.mean(bkgdImage2.getArray()), self.val)
 
+    def testGetImageMatchesInterpolate(self):
+        """Check that getImage matches interpolating the statistics image
+        with Interpolate, first along columns and then along rows, and that
+        repeated calls reflect changes to the statistics image
+        """
+        width, height, nx, ny = 63, 48, 5, 6
+        image = afwImage.ImageF(width, height)
+        image.array[:] = np.random.normal(100.0, 1.0, size=image.array.shape)
+        image.array[:] += np.linspace(0.0, 30.0, width)[np.newaxis, :]**1.5
+        bkgd = afwMath.makeBackground(image, afwMath.BackgroundControl(nx, ny))
+
+        def getCenters(size, n):
+            # as in Background::_setCenOrigSize
+            ends = [min(((i + 1)*size + n//2)//n, size) for i in range(n)]
+            origins = [0] + ends[:-1]
+            return [orig + 0.5*(end - orig) - 0.5 for orig, end in zip(origins, ends)]
+
+        xcen = getCenters(width, nx)
+        ycen = getCenters(height, ny)
+
+        def interpolate(statsArray, style):
+            columns = np.empty((height, nx))
+            for iX in range(nx):
+                interp = afwMath.makeInterpolate(ycen, statsArray[:, iX].astype(float), style)
+                columns[:, iX] = [interp.interpolate(y) for y in range(height)]
+            expect = np.empty((height, width))
+            for y in range(height):
+                interp = afwMath.makeInterpolate(xcen, columns[y, :], style)
+                expect[y, :] = [interp.interpolate(x) for x in range(width)]
+            return expect
+
+        for style in (afwMath.Interpolate.CONSTANT, afwMath.Interpolate.LINEAR,
+                      afwMath.Interpolate.NATURAL_SPLINE, afwMath.Interpolate.AKIMA_SPLINE):
+            with self.subTest(style=style):
+                statsArray = bkgd.getStatsImage().getImage().getArray()
+                bkgdImage = bkgd.getImageF(style)
+                self.assertFloatsAlmostEqual(bkgdImage.getArray(), interpolate(statsArray, style),
+                                             rtol=1e-6)
+                self.assertImagesEqual(bkgd.getImageF(style), bkgdImage)
+                subBBox = lsst.geom.Box2I(lsst.geom.Point2I(7, 5), lsst.geom.Extent2I(40, 30))
+                self.assertImagesEqual(bkgd.getImageF(subBBox, style), bkgdImage[subBBox])
+
+                # getImage must notice changes to the statistics image
+                statsArray[2, 3] += 10.0
+                self.assertFloatsAlmostEqual(bkgd.getImageF(style).getArray(),
+                                             interpolate(statsArray, style), rtol=1e-6)
+                bkgd -= 2.5
+                self.assertFloatsAlmostEqual(bkgd.getImageF(style).getArray(),
+                                             interpolate(statsArray, style), rtol=1e-6)
+
+    def testNumThreadsAndSharedHistogram(self):
+        """Check that the statistics image doesn't depend on the number of
+        threads, and that the shared-histogram medians are close to the
+        exact ones
+        """
+        width, height, nx, ny = 250, 200, 7, 5
+        rng = np.random.RandomState(42)
+        mi = afwImage.MaskedImageF(width, height)
+        mi.image.array[:] = rng.normal(1000.0, 30.0, size=mi.image.array.shape)
+        mi.image.array[:] += np.linspace(0.0, 200.0, width)[np.newaxis, :]
+        mi.image.array[::17, ::13] = 1e6  # "stars", to stretch the range of the pixel values
+        mi.image.array[5:9, 100:120] = np.nan
+        mi.mask.array[50:60, :] = mi.mask.getPlaneBitMask("BAD")
+
+        sctrl = afwMath.StatisticsControl()
+        sctrl.setAndMask(mi.mask.getPlaneBitMask("BAD"))
+        for prop in (afwMath.MEANCLIP, afwMath.MEDIAN):
+            with self.subTest(prop=prop):
+                bctrl = afwMath.BackgroundControl(nx, ny, sctrl, prop)
+                self.assertEqual(bctrl.getNumThreads(), 1)
+                self.assertFalse(bctrl.getSharedHistogram())
+                expect = afwMath.makeBackground(mi, bctrl).getStatsImage()
+                for numThreads in (0, 3, 64):
+                    bctrl.setNumThreads(numThreads)
+                    self.assertEqual(bctrl.getNumThreads(), numThreads)
+                    self.assertMaskedImagesEqual(afwMath.makeBackground(mi, bctrl).getStatsImage(), expect)
+
+                bctrl.setSharedHistogram(True)
+                statsImage = afwMath.makeBackground(mi, bctrl).getStatsImage()
+                if prop == afwMath.MEANCLIP:
+                    self.assertMaskedImagesEqual(statsImage, expect)  # not used for MEANCLIP
+                else:
+                    self.assertFloatsAlmostEqual(statsImage.image.array, expect.image.array, atol=0.2)
+                    self.assertFloatsAlmostEqual(statsImage.variance.array, expect.variance.array,
+                                                 rtol=1e-5)
+                    bctrl.setNumThreads(1)
+                    self.assertMaskedImagesEqual(afwMath.makeBackground(mi, bctrl).getStatsImage(),
+                                                 statsImage)
+
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            afwMath.BackgroundControl(nx, ny).setNumThreads(-1)
+
     def testBackgroundList(self):
         """Test that a BackgroundLists behaves like a list"""
         bgCtrl = afwMath.BackgroundControl(10, 10)
@@ -224,6 +224,39 @@ class CameraGeomTestCase(lsst.utils.tests.TestCase):
             for dets in detList:
                 self.assertEqual(len(dets), 1)
 
+    def testFindDetectorsMatchesBruteForce(self):
+        """Check that the detector index doesn't change the results of
+        findDetectors and findDetectorsList, including near detector edges
+        and outside the focal plane
+        """
+        for cw in self.cameraList:
+            camera = cw.camera
+            fpBBox = camera.getFpBBox()
+            fpBBox.grow(0.1*max(fpBBox.getWidth(), fpBBox.getHeight()))
+            pointList = [lsst.geom.Point2D(x, y)
+                         for x in np.linspace(fpBBox.getMinX(), fpBBox.getMaxX(), 41)
+                         for y in np.linspace(fpBBox.getMinY(), fpBBox.getMaxY(), 37)]
+            for det in camera:
+                bbox = lsst.geom.Box2D(det.getBBox())
+                for corner in bbox.getCorners():
+                    for offset in (-1e-3, 1e-3):
+                        pixels = lsst.geom.Point2D(corner.getX() + offset, corner.getY() - offset)
+                        pointList.append(det.transform(pixels, PIXELS, FOCAL_PLANE))
+
+            # iterating over a camera, like findDetectors, visits the detectors in ID order
+            expectList = []
+            for point in pointList:
+                expectList.append([det.getName() for det in camera
+                                   if lsst.geom.Box2D(det.getBBox()).contains(
+                                       det.transform(point, FOCAL_PLANE, PIXELS))])
+            self.assertGreater(sum(len(names) for names in expectList), 0)
+
+            for point, expect in zip(pointList, expectList):
+                self.assertEqual([det.getName() for det in camera.findDetectors(point, FOCAL_PLANE)],
+                                 expect)
+            detLists = camera.findDetectorsList(pointList, FOCAL_PLANE)
+            self.assertEqual([[det.getName() for det in dets] for dets in detLists], expectList)
+
     def testFpBbox(self):
         for cw in self.cameraList:
             camera = cw.camera
@@ -148,6 +148,27 @@ class ChebyshevBoundedFieldTestCase(lsst.utils.tests.TestCase):
             self.assertFloatsEqual(
                 scaled.getCoefficients(), factor*field.getCoefficients())
 
+    def testEvaluateGrid(self):
+        """Test that evaluateGrid matches the vectorized evaluate method.
+        """
+        for ctrl, coefficients in self.cases:
+            field = lsst.afw.math.ChebyshevBoundedField(self.bbox, coefficients)
+            z1 = field.evaluateGrid(self.x1d, self.y1d)
+            self.assertEqual(z1.shape, self.x2d.shape)
+            z2 = field.evaluate(self.xFlat, self.yFlat).reshape(self.x2d.shape)
+            self.assertFloatsAlmostEqual(z1, z2, rtol=1E-12, atol=1E-12)
+
+    def testProductEvaluateGrid(self):
+        """Test that ProductBoundedField.evaluateGrid is equivalent to multiplying
+        the grids of its nested BoundedFields.
+        """
+        z1 = self.product.evaluateGrid(self.x1d, self.y1d)
+        self.assertEqual(z1.shape, self.x2d.shape)
+        z2 = np.ones(z1.shape, dtype=float)
+        for field in self.fields:
+            z2 *= field.evaluateGrid(self.x1d, self.y1d)
+        self.assertFloatsAlmostEqual(z1, z2)
+
     def testProductEvaluate(self):
         """Test that ProductBoundedField.evaluate is equivalent to multiplying
         its nested BoundedFields.
@@ -383,6 +383,201 @@ class ConvolveTestCase(lsst.utils.tests.TestCase):
             self.assertEqual(
                 convControl.getMaxInterpolationDistance(), maxInterpDist)
 
+        self.assertEqual(convControl.getNumThreads(), 1)
+        for numThreads in (0, 1, 4):
+            convControl.setNumThreads(numThreads)
+            self.assertEqual(convControl.getNumThreads(), numThreads)
+
+        self.assertEqual(convControl.getMinFftKernelArea(), 1024)
+        for minFftKernelArea in (0, 1, 400):
+            convControl.setMinFftKernelArea(minFftKernelArea)
+            self.assertEqual(convControl.getMinFftKernelArea(), minFftKernelArea)
+
+        self.assertFalse(convControl.getDoBasisConvolution())
+        for doBasisConvolution in (True, False):
+            convControl.setDoBasisConvolution(doBasisConvolution)
+            self.assertEqual(convControl.getDoBasisConvolution(), doBasisConvolution)
+
+    def testFftConvolve(self):
+        """Test that convolving using FFTs matches convolving directly
+        """
+        rng = numpy.random.RandomState(54321)
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(3, 5), lsst.geom.Extent2I(301, 277))
+        maskedImage = afwImage.MaskedImageF(bbox)
+        maskedImage.image.array[:] = rng.normal(100.0, 10.0, maskedImage.image.array.shape)
+        maskedImage.mask.array[:] = numpy.where(rng.uniform(size=maskedImage.mask.array.shape) < 0.01,
+                                                rng.randint(1, 16, maskedImage.mask.array.shape), 0)
+        maskedImage.variance.array[:] = rng.uniform(5.0, 15.0, maskedImage.variance.array.shape)
+
+        gaussFunc = afwMath.GaussianFunction2D(4.0, 3.0, 0.5)
+        analyticKernel = afwMath.AnalyticKernel(41, 37, gaussFunc)
+        # a kernel with holes in it, to check smearing of the mask
+        kernelImage = afwImage.ImageD(lsst.geom.Extent2I(33, 35))
+        analyticKernel.computeImage(kernelImage, False)
+        kernelImage.array[::3, ::4] = 0.0
+        kernelImage.array[:, 16] = 0.0
+        fixedKernel = afwMath.FixedKernel(kernelImage)
+        basisKernelList = makeGaussianKernelList(35, 35, [(3.0, 3.0, 0.0), (5.0, 3.0, 0.3)])
+        lcKernel = afwMath.LinearCombinationKernel(basisKernelList, [0.7, 0.3])
+
+        for kernel in (analyticKernel, fixedKernel, lcKernel):
+            for doCopyEdge in (False, True):
+                directControl = afwMath.ConvolutionControl()
+                directControl.setDoCopyEdge(doCopyEdge)
+                directControl.setMinFftKernelArea(0)
+                fftControl = afwMath.ConvolutionControl()
+                fftControl.setDoCopyEdge(doCopyEdge)
+                fftControl.setMinFftKernelArea(1)
+                msg = "kernel=%s, doCopyEdge=%s" % (type(kernel).__name__, doCopyEdge)
+
+                refMaskedImage = afwImage.MaskedImageF(bbox)
+                afwMath.convolve(refMaskedImage, maskedImage, kernel, directControl)
+                for numThreads in (1, 3):
+                    fftControl.setNumThreads(numThreads)
+                    cnvMaskedImage = afwImage.MaskedImageF(bbox)
+                    afwMath.convolve(cnvMaskedImage, maskedImage, kernel, fftControl)
+                    self.assertMasksEqual(cnvMaskedImage.mask, refMaskedImage.mask, msg=msg)
+                    self.assertMaskedImagesAlmostEqual(cnvMaskedImage, refMaskedImage, rtol=1e-6, msg=msg)
+
+                refImage = afwImage.ImageD(bbox)
+                afwMath.convolve(refImage, maskedImage.image, kernel, directControl)
+                image = afwImage.ImageD(bbox)
+                afwMath.convolve(image, maskedImage.image, kernel, fftControl)
+                self.assertImagesAlmostEqual(image, refImage, rtol=1e-6, msg=msg)
+
+        # non-finite pixels and integer images are convolved directly, so the results are identical
+        fftControl = afwMath.ConvolutionControl()
+        fftControl.setMinFftKernelArea(1)
+        directControl = afwMath.ConvolutionControl()
+        directControl.setMinFftKernelArea(0)
+        maskedImage.image[150, 140, afwImage.LOCAL] = numpy.nan
+        refMaskedImage = afwImage.MaskedImageF(bbox)
+        afwMath.convolve(refMaskedImage, maskedImage, analyticKernel, directControl)
+        cnvMaskedImage = afwImage.MaskedImageF(bbox)
+        afwMath.convolve(cnvMaskedImage, maskedImage, analyticKernel, fftControl)
+        self.assertMaskedImagesEqual(cnvMaskedImage, refMaskedImage)
+
+        intImage = afwImage.ImageI(bbox)
+        intImage.array[:] = rng.randint(0, 1000, intImage.array.shape)
+        refImage = afwImage.ImageI(bbox)
+        afwMath.convolve(refImage, intImage, analyticKernel, directControl)
+        image = afwImage.ImageI(bbox)
+        afwMath.convolve(image, intImage, analyticKernel, fftControl)
+        self.assertImagesEqual(image, refImage)
+
+    def testSeparableConvolveThreads(self):
+        """Test that convolving with a separable kernel doesn't depend on the number of threads
+        """
+        rng = numpy.random.RandomState(12345)
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(3, 5), lsst.geom.Extent2I(73, 61))
+        maskedImage = afwImage.MaskedImageF(bbox)
+        maskedImage.image.array[:] = rng.normal(100.0, 10.0, maskedImage.image.array.shape)
+        maskedImage.mask.array[:] = rng.randint(0, 4, maskedImage.mask.array.shape)
+        maskedImage.variance.array[:] = 10.0
+        maskedImage.image[10, 10, afwImage.LOCAL] = numpy.nan
+
+        gaussFunc = afwMath.GaussianFunction1D(1.5)
+        kernel = afwMath.SeparableKernel(7, 5, gaussFunc, gaussFunc)
+
+        for doCopyEdge in (False, True):
+            convControl = afwMath.ConvolutionControl()
+            convControl.setDoCopyEdge(doCopyEdge)
+            refImage = afwImage.ImageF(maskedImage.getBBox())
+            afwMath.convolve(refImage, maskedImage.image, kernel, convControl)
+            refMaskedImage = afwImage.MaskedImageF(maskedImage.getBBox())
+            afwMath.convolve(refMaskedImage, maskedImage, kernel, convControl)
+
+            for numThreads in (0, 2, 7, 100):
+                convControl.setNumThreads(numThreads)
+                image = afwImage.ImageF(maskedImage.getBBox())
+                afwMath.convolve(image, maskedImage.image, kernel, convControl)
+                self.assertImagesEqual(image, refImage)
+                cnvMaskedImage = afwImage.MaskedImageF(maskedImage.getBBox())
+                afwMath.convolve(cnvMaskedImage, maskedImage, kernel, convControl)
+                self.assertMaskedImagesEqual(cnvMaskedImage, refMaskedImage)
+
+    def testSpatiallyVaryingConvolveThreads(self):
+        """Test that convolving with a spatially varying kernel using interpolation doesn't depend
+        on the number of threads
+        """
+        rng = numpy.random.RandomState(23456)
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(3, 5), lsst.geom.Extent2I(97, 83))
+        maskedImage = afwImage.MaskedImageF(bbox)
+        maskedImage.image.array[:] = rng.normal(100.0, 10.0, maskedImage.image.array.shape)
+        maskedImage.mask.array[:] = rng.randint(0, 4, maskedImage.mask.array.shape)
+        maskedImage.variance.array[:] = 10.0
+        maskedImage.image[10, 10, afwImage.LOCAL] = numpy.nan
+
+        width, height = bbox.getDimensions()
+        basisKernelList = makeGaussianKernelList(7, 7, [(1.5, 1.5, 0.0), (2.5, 1.5, 0.0), (2.5, 2.5, 0.0)])
+        kernel = afwMath.LinearCombinationKernel(basisKernelList, afwMath.PolynomialFunction2D(1))
+        kernel.setSpatialParameters([
+            (1.0, -0.01/width, -0.01/height),
+            (0.0, 0.01/width, 0.0),
+            (0.0, 0.0, 0.01/height),
+        ])
+
+        convControl = afwMath.ConvolutionControl()
+        convControl.setMaxInterpolationDistance(10)
+        refImage = afwImage.ImageF(bbox)
+        afwMath.convolve(refImage, maskedImage.image, kernel, convControl)
+        refMaskedImage = afwImage.MaskedImageF(bbox)
+        afwMath.convolve(refMaskedImage, maskedImage, kernel, convControl)
+
+        for numThreads in (0, 2, 7, 100):
+            convControl.setNumThreads(numThreads)
+            image = afwImage.ImageF(bbox)
+            afwMath.convolve(image, maskedImage.image, kernel, convControl)
+            self.assertImagesEqual(image, refImage)
+            cnvMaskedImage = afwImage.MaskedImageF(bbox)
+            afwMath.convolve(cnvMaskedImage, maskedImage, kernel, convControl)
+            self.assertMaskedImagesEqual(cnvMaskedImage, refMaskedImage)
+
+    def testBasisConvolution(self):
+        """Test that convolving a spatially varying LinearCombinationKernel basis kernel by basis kernel
+        matches brute force convolution
+        """
+        rng = numpy.random.RandomState(34567)
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(3, 5), lsst.geom.Extent2I(91, 157))
+        maskedImage = afwImage.MaskedImageF(bbox)
+        maskedImage.image.array[:] = rng.normal(100.0, 10.0, maskedImage.image.array.shape)
+        maskedImage.mask.array[:] = numpy.where(rng.uniform(size=maskedImage.mask.array.shape) < 0.02,
+                                                rng.randint(1, 16, maskedImage.mask.array.shape), 0)
+        maskedImage.variance.array[:] = rng.uniform(5.0, 15.0, maskedImage.variance.array.shape)
+
+        width, height = bbox.getDimensions()
+        sFunc = afwMath.PolynomialFunction2D(1)
+        gaussianKernel = afwMath.LinearCombinationKernel(
+            makeGaussianKernelList(9, 7, [(1.5, 1.5, 0.0), (2.5, 1.5, 0.0), (2.5, 2.5, 0.0)]), sFunc)
+        gaussianKernel.setSpatialParameters([
+            (1.0, -0.3/width, -0.3/height),
+            (0.0, 0.3/width, 0.0),
+            (0.0, 0.0, 0.3/height),
+        ])
+        deltaKernel = afwMath.LinearCombinationKernel(makeDeltaFunctionKernelList(3, 3), sFunc)
+        deltaKernel.setSpatialParameters([(1.0 + i, (i - 4)/width, (4 - i)/height) for i in range(9)])
+
+        for kernel in (gaussianKernel, deltaKernel):
+            for doNormalize in (False, True):
+                msg = "nBasis=%d, doNormalize=%s" % (kernel.getNBasisKernels(), doNormalize)
+                convControl = afwMath.ConvolutionControl(doNormalize)
+                convControl.setMaxInterpolationDistance(0)
+                refImage = afwImage.ImageF(bbox)
+                afwMath.convolve(refImage, maskedImage.image, kernel, convControl)
+                refMaskedImage = afwImage.MaskedImageF(bbox)
+                afwMath.convolve(refMaskedImage, maskedImage, kernel, convControl)
+
+                convControl.setDoBasisConvolution(True)
+                for numThreads in (1, 3):
+                    convControl.setNumThreads(numThreads)
+                    image = afwImage.ImageF(bbox)
+                    afwMath.convolve(image, maskedImage.image, kernel, convControl)
+                    self.assertImagesAlmostEqual(image, refImage, rtol=1e-6, msg=msg)
+                    cnvMaskedImage = afwImage.MaskedImageF(bbox)
+                    afwMath.convolve(cnvMaskedImage, maskedImage, kernel, convControl)
+                    self.assertMasksEqual(cnvMaskedImage.mask, refMaskedImage.mask, msg=msg)
+                    self.assertMaskedImagesAlmostEqual(cnvMaskedImage, refMaskedImage, rtol=1e-6, msg=msg)
+
     @unittest.skipIf(dataDir is None, "afwdata not setup")
     def testUnityConvolution(self):
         """Verify that convolution with a centered delta function reproduces the original.
@@ -26,6 +26,7 @@ import numpy as np
 import lsst.utils.tests
 import lsst.pex.exceptions
 import lsst.geom
+import lsst.afw.geom as afwGeom
 import lsst.afw.image as afwImage
 import lsst.afw.detection as afwDetect
 import lsst.afw.table as afwTable
@@ -338,6 +339,86 @@ class FootprintMergeCatalogTestCase(lsst.utils.tests.TestCase):
             for peak in record.getFootprint().getPeaks():
                 self.assertTrue(isPeakInCatalog(peak, merge))
 
+    def testSpatialIndex(self):
+        """Test merging footprints spread over many cells of the index used
+        by addCatalog, including negative coordinates.
+        """
+        schema = afwTable.SourceTable.makeMinimalSchema()
+        idFactory = afwTable.IdFactory.makeSimple()
+        table = afwTable.SourceTable.make(schema, idFactory)
+
+        def makeCatalog(boxes):
+            catalog = afwTable.SourceCatalog(table)
+            for box in boxes:
+                footprint = afwDetect.Footprint(afwGeom.SpanSet(box))
+                footprint.addPeak(box.getMinX(), box.getMinY(), 1.0)
+                catalog.addNew().setFootprint(footprint)
+            return catalog
+
+        # A row of small boxes, then a long bar that connects boxes 5-12 and an isolated box
+        small = [lsst.geom.Box2I(lsst.geom.Point2I(-600 + 60*i, -5), lsst.geom.Extent2I(3, 3))
+                 for i in range(20)]
+        bar = lsst.geom.Box2I(lsst.geom.Point2I(-299, -4), lsst.geom.Point2I(121, -4))
+        isolated = lsst.geom.Box2I(lsst.geom.Point2I(1000, 1000), lsst.geom.Extent2I(3, 3))
+        catalog1 = makeCatalog(small)
+        catalog2 = makeCatalog([bar, isolated])
+
+        merge, nob, npeaks = mergeCatalogs([catalog1, catalog2], ["1", "2"], [-1, -1], idFactory)
+        self.assertEqual(nob, 14)
+        self.assertEqual(npeaks, 14)
+        self.assertEqual([record.getFootprint().getArea() for record in merge],
+                         [9]*5 + [8*9 + 421 - 22] + [9]*8)
+        self.assertEqual([record.getFootprint().getBBox().getMinX() for record in merge],
+                         [box.getMinX() for box in small[:6]] + [box.getMinX() for box in small[13:]]
+                         + [isolated.getMinX()])
+        self.assertEqual([record.get("merge_footprint_2") for record in merge],
+                         [False]*5 + [True] + [False]*7 + [True])
+
+    def testManyPeaks(self):
+        """Test peak merging for footprints with many peaks against a
+        brute-force nearest-peak search.
+        """
+        schema = afwTable.SourceTable.makeMinimalSchema()
+        idFactory = afwTable.IdFactory.makeSimple()
+        table = afwTable.SourceTable.make(schema, idFactory)
+        rng = np.random.RandomState(7)
+        box = lsst.geom.Box2I(lsst.geom.Point2I(-20, 10), lsst.geom.Extent2I(200, 150))
+        positions = []
+        catalogs = []
+        for n in (150, 200):
+            points = [(int(x), int(y)) for x, y in zip(rng.randint(-20, 180, size=n),
+                                                       rng.randint(10, 160, size=n))]
+            footprint = afwDetect.Footprint(afwGeom.SpanSet(box))
+            for x, y in points:
+                footprint.addPeak(x, y, 1.0)
+            catalog = afwTable.SourceCatalog(table)
+            catalog.addNew().setFootprint(footprint)
+            positions.append(points)
+            catalogs.append(catalog)
+
+        minNewPeakDist = 6
+        maxSamePeakDist = 3
+        merge, nob, npeaks = mergeCatalogs(catalogs, ["1", "2"], [minNewPeakDist, minNewPeakDist],
+                                           idFactory, samePeakDist=maxSamePeakDist)
+        self.assertEqual(nob, 1)
+
+        # Brute-force version of FootprintMerge's peak merging
+        sameAs = set()
+        added = []
+        for x, y in positions[1]:
+            dist2 = [(x - x1)**2 + (y - y1)**2 for x1, y1 in positions[0]]
+            nearest = int(np.argmin(dist2))
+            if dist2[nearest] < maxSamePeakDist**2:
+                sameAs.add(nearest)
+            elif dist2[nearest] > minNewPeakDist**2:
+                added.append((x, y))
+        peaks = merge[0].getFootprint().getPeaks()
+        self.assertEqual(len(peaks), len(positions[0]) + len(added))
+        self.assertEqual([(peak.getIx(), peak.getIy()) for peak in peaks], positions[0] + added)
+        for i, peak in enumerate(peaks):
+            self.assertEqual(peak.get("merge_peak_1"), i < len(positions[0]))
+            self.assertEqual(peak.get("merge_peak_2"), i >= len(positions[0]) or i in sameAs)
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
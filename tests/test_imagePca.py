@@ -207,6 +207,63 @@ class ImagePcaTestCase(lsst.utils.tests.TestCase):
             mos = afwDisplay.utils.Mosaic(background=-10)
             afwDisplay.Display(frame=0).mtv(mos.makeMosaic(eImages), title="testPcaNaN")
 
+    def testPcaMaskedImages(self):
+        """Test the inner products, eigen images, variances and masks of a PCA
+        of MaskedImages, computed with one and several threads
+        """
+        # more than one block of pixels, and small stamps (fewer blocks than threads)
+        for width, height, numInputs in ((70, 90, 5), (15, 12, 11)):
+            with self.subTest(width=width, height=height, numInputs=numInputs):
+                self.checkPcaMaskedImages(width, height, numInputs)
+
+        imageSet = afwImage.ImagePcaMF()
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            imageSet.setNumThreads(-1)
+
+    def checkPcaMaskedImages(self, width, height, numInputs):
+        rng = np.random.RandomState(12345)
+
+        fluxes = rng.uniform(1.0, 2.0, size=numInputs)
+        arrays = rng.normal(size=(numInputs, height, width)).astype(np.float32)
+        variances = rng.uniform(0.5, 1.5, size=(numInputs, height, width)).astype(np.float32)
+        masks = np.zeros((numInputs, height, width), dtype=np.int32)
+        masks[1, 3, 4] = 0x1
+        masks[3, height - 5, width - 2] = 0x4
+
+        results = []
+        for numThreads in (1, 3, 8):
+            imageSet = afwImage.ImagePcaMF()
+            self.assertEqual(imageSet.getNumThreads(), 1)
+            imageSet.setNumThreads(numThreads)
+            self.assertEqual(imageSet.getNumThreads(), numThreads)
+            for array, variance, mask, flux in zip(arrays, variances, masks, fluxes):
+                im = afwImage.MaskedImageF(width, height)
+                im.image.array[:] = array
+                im.variance.array[:] = variance
+                im.mask.array[:] = mask
+                imageSet.addImage(im, flux)
+            imageSet.analyze()
+            results.append((np.array(imageSet.getEigenValues()),
+                            [eImage.clone() for eImage in imageSet.getEigenImages()]))
+
+        # the same decomposition, computed directly
+        scaled = arrays.reshape(numInputs, -1).astype(np.float64)/fluxes[:, np.newaxis]
+        lambdas, vectors = np.linalg.eigh(np.dot(scaled, scaled.T)/numInputs)
+        order = np.argsort(lambdas)[::-1]
+        weights = vectors[:, order]*(fluxes.mean()/fluxes)[:, np.newaxis]
+        expectImages = np.tensordot(weights, arrays.astype(np.float64), axes=(0, 0))
+        expectVariances = np.tensordot(weights**2, variances.astype(np.float64), axes=(0, 0))
+        expectMask = np.bitwise_or.reduce(masks, axis=0)
+
+        for eigenValues, eImages in results:
+            self.assertFloatsAlmostEqual(eigenValues, lambdas[order], rtol=1e-5)
+            self.assertEqual(len(eImages), numInputs)
+            for eImage, expectImage, expectVariance in zip(eImages, expectImages, expectVariances):
+                sign = np.sign(np.sum(eImage.image.array*expectImage))  # eigenvectors' signs are arbitrary
+                self.assertFloatsAlmostEqual(eImage.image.array, sign*expectImage, atol=1e-4, rtol=1e-4)
+                self.assertFloatsAlmostEqual(eImage.variance.array, expectVariance, atol=1e-4, rtol=1e-4)
+                np.testing.assert_array_equal(eImage.mask.array, expectMask)
+
 
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
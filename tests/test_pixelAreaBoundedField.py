@@ -26,6 +26,7 @@ import numpy as np
 import lsst.utils.tests
 import lsst.geom
 import lsst.afw.geom
+import lsst.afw.image
 from lsst.afw.math import PixelAreaBoundedField
 
 
@@ -82,6 +83,29 @@ class PixelAreaBoundedFieldTestCase(lsst.utils.tests.TestCase):
         result2 = product.evaluate(xv.flatten(), yv.flatten())
         self.assertFloatsAlmostEqual(expect*2.5, result2)
 
+    def testEvaluateGrid(self):
+        """Test grid evaluation, both on a grid spaced by one pixel (which
+        reuses neighboring points) and on an arbitrary grid.
+        """
+        for xx, yy in [(np.arange(20, 45, dtype=float), np.arange(-3, 12, dtype=float)),
+                       (np.linspace(self.bbox.getMinX(), self.bbox.getMaxX(), 17),
+                        np.linspace(self.bbox.getMinY(), self.bbox.getMaxY(), 13))]:
+            xv, yv = np.meshgrid(xx, yy)
+            result = self.boundedField.evaluateGrid(xx, yy)
+            self.assertEqual(result.shape, xv.shape)
+            expect = self.boundedField.evaluate(xv.flatten(), yv.flatten()).reshape(xv.shape)
+            self.assertFloatsEqual(result, expect)
+
+    def testFillImage(self):
+        """Test that fillImage matches vectorized evaluation.
+        """
+        image = lsst.afw.image.ImageD(self.bbox)
+        self.boundedField.fillImage(image)
+        xv, yv = np.meshgrid(np.arange(self.bbox.getBeginX(), self.bbox.getEndX(), dtype=float),
+                             np.arange(self.bbox.getBeginY(), self.bbox.getEndY(), dtype=float))
+        expect = self.boundedField.evaluate(xv.flatten(), yv.flatten()).reshape(xv.shape)
+        self.assertFloatsEqual(image.array, expect)
+
     def testEquality(self):
         """Test the implementation of operator== / __eq__.
         """
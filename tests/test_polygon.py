@@ -268,6 +268,58 @@ class PolygonTest(lsst.utils.tests.TestCase):
             self.assertAlmostEqual(
                 image.getArray().sum()/poly.calculateArea(), 1.0, 6)
 
+    def testImageHole(self):
+        """Test that Polygon.createImage excludes the holes of a polygon"""
+        outer = self.polygon(12, 30, 50.3, 49.6)
+        inner = self.square(8.2, 51.7, 48.4)
+        holes = outer.symDifference(inner)
+        self.assertEqual(len(holes), 1)
+        poly = holes[0]
+        self.assertAlmostEqual(poly.calculateArea(), outer.calculateArea() - inner.calculateArea())
+        box = lsst.geom.Box2I(lsst.geom.Point2I(10, 10), lsst.geom.Extent2I(80, 80))
+        image = poly.createImage(box)
+        self.assertAlmostEqual(image.getArray().sum()/poly.calculateArea(), 1.0, 6)
+        expected = outer.createImage(box).getArray() - inner.createImage(box).getArray()
+        self.assertFloatsAlmostEqual(image.getArray(), expected, atol=1e-6)
+        self.assertEqual(image[52, 48, lsst.afw.image.PARENT], 0.0)
+
+        coverage = afwGeom.Polygon.createCoverageImage([poly], box)
+        self.assertFloatsAlmostEqual(coverage.getArray(), image.getArray(), atol=0.0)
+        mask = lsst.afw.image.Mask(box)
+        afwGeom.Polygon.setCoverageMask([poly], mask, 0x2)
+        np.testing.assert_array_equal(mask.getArray() == 0x2, image.getArray() > 0)
+
+    def testImageFractions(self):
+        """Test the fractional pixel values from Polygon.createImage"""
+        poly = afwGeom.Polygon(lsst.geom.Box2D(lsst.geom.Point2D(0.25, 0.25),
+                                               lsst.geom.Point2D(2.75, 1.5)))
+        box = lsst.geom.Box2I(lsst.geom.Point2I(-1, -1), lsst.geom.Point2I(4, 3))
+        image = poly.createImage(box)
+        expected = np.zeros((5, 6), dtype=np.float32)
+        expected[1:3, 1:4] = np.outer([0.25, 1.0], [0.25, 1.0, 1.0])  # rows y=0,1; columns x=0,1,2
+        expected[1:3, 4] = [0.25*0.25, 0.25]  # column x=3
+        self.assertFloatsAlmostEqual(image.getArray(), expected, atol=1e-7)
+
+    def testCoverage(self):
+        """Test Polygon.createCoverageImage and Polygon.setCoverageMask"""
+        polygons = [self.polygon(num, 20, 40 + 3*num, 50 - 2*num) for num in (3, 5, 8)]
+        polygons.append(self.square(12.3, 30.2, 41.6))
+        box = lsst.geom.Box2I(lsst.geom.Point2I(5, 10), lsst.geom.Extent2I(80, 70))
+
+        coverage = afwGeom.Polygon.createCoverageImage(polygons, box)
+        self.assertEqual(coverage.getBBox(), box)
+        expected = sum(poly.createImage(box).getArray() for poly in polygons)
+        self.assertFloatsAlmostEqual(coverage.getArray(), expected, atol=1e-6)
+
+        mask = lsst.afw.image.Mask(box)
+        afwGeom.Polygon.setCoverageMask(polygons, mask, 0x2)
+        np.testing.assert_array_equal(mask.getArray() == 0x2, expected > 0)
+
+        mask = lsst.afw.image.Mask(box)
+        afwGeom.Polygon.setCoverageMask(polygons, mask, 0x4, minCoverage=0.5)
+        mostly = np.any([poly.createImage(box).getArray() >= 0.5 for poly in polygons], axis=0)
+        np.testing.assert_array_equal(mask.getArray() == 0x4, mostly)
+
     def testTransform(self):
         """Test constructor for Polygon involving transforms"""
         box = lsst.geom.Box2D(lsst.geom.Point2D(0.0, 0.0),
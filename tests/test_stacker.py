@@ -27,6 +27,9 @@ Run with:
 or
    pytest test_stacker.py
 """
+import itertools
+import os
+import tempfile
 import unittest
 from functools import reduce
 
@@ -403,6 +406,125 @@ class StackTestCase(lsst.utils.tests.TestCase):
         self.assertEqual(stack.mask[1, 1, afwImage.LOCAL], clipped)
         self.assertEqual(stack.mask[1, 2, afwImage.LOCAL], rejected)
 
+    def testBatchedStack(self):
+        """Test that the batched stacker gives the same answers as the per-pixel code"""
+        width, height = 300, 5      # wider than a single tile
+        bad = afwImage.Mask.getPlaneBitMask("BAD")
+        sat = afwImage.Mask.getPlaneBitMask("SAT")
+        clipped = 1 << afwImage.Mask().addMaskPlane("CLIPPED")
+        images = []
+        for i in range(7):
+            mi = afwImage.MaskedImageF(width, height)
+            imArr, maskArr, varArr = mi.getArrays()
+            imArr[:] = np.random.normal(10, 1, (height, width))
+            imArr[np.random.uniform(size=(height, width)) < 0.05] += 100
+            imArr[np.random.uniform(size=(height, width)) < 0.05] = np.nan
+            maskArr[np.random.uniform(size=(height, width)) < 0.1] |= bad
+            maskArr[np.random.uniform(size=(height, width)) < 0.1] |= sat
+            varArr[:] = np.random.uniform(1, 2, (height, width))
+            images.append(mi)
+
+        for weighted in (False, True):
+            for stat in (afwMath.MEAN, afwMath.MEDIAN, afwMath.MEANCLIP, afwMath.STDEVCLIP,
+                         afwMath.IQRANGE, afwMath.MIN, afwMath.MAX, afwMath.NPOINT):
+                statsCtrl = afwMath.StatisticsControl()
+                statsCtrl.setAndMask(bad)
+                statsCtrl.setWeighted(weighted)
+                statsCtrl.setMaskPropagationThreshold(afwImage.Mask.getMaskPlane("SAT"), 0.3)
+                expected = afwMath.statisticsStack(images, stat, statsCtrl, clipped=clipped)
+                statsCtrl.setBatchedStack(True)
+                self.assertTrue(statsCtrl.getBatchedStack())
+                stack = afwMath.statisticsStack(images, stat, statsCtrl, clipped=clipped)
+                self.assertImagesEqual(stack.image, expected.image)
+                self.assertMasksEqual(stack.mask, expected.mask)
+                self.assertImagesEqual(stack.variance, expected.variance)
+
+    def testThreadedStack(self):
+        """Test that the stack doesn't depend on the number of threads"""
+        width, height = 50, 37      # not a multiple of the number of threads
+        bad = afwImage.Mask.getPlaneBitMask("BAD")
+        images = []
+        for i in range(9):
+            mi = afwImage.MaskedImageF(width, height)
+            imArr, maskArr, varArr = mi.getArrays()
+            imArr[:] = np.random.normal(10, 1, (height, width))
+            imArr[np.random.uniform(size=(height, width)) < 0.05] += 100
+            maskArr[np.random.uniform(size=(height, width)) < 0.1] |= bad
+            varArr[:] = 1.0
+            images.append(mi)
+
+        for batched in (False, True):
+            for stat in (afwMath.MEAN, afwMath.MEDIAN, afwMath.MEANCLIP):
+                statsCtrl = afwMath.StatisticsControl()
+                statsCtrl.setAndMask(bad)
+                statsCtrl.setBatchedStack(batched)
+                self.assertEqual(statsCtrl.getNumThreads(), 1)
+                expected = afwMath.statisticsStack(images, stat, statsCtrl)
+                for numThreads in (0, 2, 4, 64):
+                    statsCtrl.setNumThreads(numThreads)
+                    self.assertEqual(statsCtrl.getNumThreads(), numThreads)
+                    stack = afwMath.statisticsStack(images, stat, statsCtrl)
+                    self.assertImagesEqual(stack.image, expected.image)
+                    self.assertMasksEqual(stack.mask, expected.mask)
+                    self.assertImagesEqual(stack.variance, expected.variance)
+
+                # and for a plain Image
+                statsCtrl.setNumThreads(1)
+                expected = afwMath.statisticsStack([mi.image for mi in images], stat, statsCtrl)
+                statsCtrl.setNumThreads(4)
+                stack = afwMath.statisticsStack([mi.image for mi in images], stat, statsCtrl)
+                self.assertImagesEqual(stack, expected)
+
+    def testStreamedStack(self):
+        """Test that stacking from FITS files a strip at a time matches the in-memory stack"""
+        width, height = 40, 23
+        bad = afwImage.Mask.getPlaneBitMask("BAD")
+        clipped = 1 << afwImage.Mask().addMaskPlane("CLIPPED")
+        images = []
+        for i in range(6):
+            # the inputs need only have the same dimensions
+            bbox = lsst.geom.Box2I(lsst.geom.Point2I(10*i, -5), lsst.geom.Extent2I(width, height))
+            mi = afwImage.MaskedImageF(bbox)
+            imArr, maskArr, varArr = mi.getArrays()
+            imArr[:] = np.random.normal(10, 1, (height, width))
+            imArr[np.random.uniform(size=(height, width)) < 0.05] += 100
+            maskArr[np.random.uniform(size=(height, width)) < 0.1] |= bad
+            varArr[:] = np.random.uniform(1, 2, (height, width))
+            images.append(mi)
+
+        with tempfile.TemporaryDirectory() as tempDir:
+            fileNames = []
+            for i, mi in enumerate(images):
+                fileNames.append(os.path.join(tempDir, f"input{i}.fits"))
+                afwImage.ExposureF(mi).writeFits(fileNames[-1])
+
+            for stat, excuse in itertools.product((afwMath.MEAN, afwMath.MEDIAN, afwMath.MEANCLIP), (0, bad)):
+                statsCtrl = afwMath.StatisticsControl()
+                statsCtrl.setAndMask(bad)
+                expected = afwMath.statisticsStack(images, stat, statsCtrl, clipped=clipped, excuse=excuse)
+                for stripHeight in (1, 5, height, 100):
+                    stack = afwImage.MaskedImageF(width, height)
+                    afwMath.statisticsStack(stack, fileNames, stat, statsCtrl, clipped=clipped, excuse=excuse,
+                                            stripHeight=stripHeight)
+                    self.assertMaskedImagesEqual(stack, expected)
+
+                    readers = [afwImage.ExposureFitsReader(fileName) for fileName in fileNames]
+                    stack = afwImage.MaskedImageF(width, height)
+                    afwMath.statisticsStack(stack, readers, stat, statsCtrl, clipped=clipped, excuse=excuse,
+                                            stripHeight=stripHeight)
+                    self.assertMaskedImagesEqual(stack, expected)
+
+                    stack = afwImage.MaskedImageF(width, height)
+                    afwMath.statisticsStack(stack, fileNames, stat, statsCtrl, [], clipped,
+                                            [(bad & ~excuse, clipped)], stripHeight=stripHeight)
+                    self.assertMaskedImagesEqual(stack, expected)
+
+            with self.assertRaises(pexEx.InvalidParameterError):
+                afwMath.statisticsStack(afwImage.MaskedImageF(width, height + 1), fileNames, afwMath.MEAN)
+            with self.assertRaises(pexEx.InvalidParameterError):
+                afwMath.statisticsStack(afwImage.MaskedImageF(width, height), fileNames, afwMath.MEAN,
+                                        stripHeight=0)
+
 #################################################################
 # Test suite boiler plate
 #################################################################
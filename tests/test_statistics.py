@@ -577,6 +577,71 @@ class StatisticsTestCase(lsst.utils.tests.TestCase):
             mask[1, 1] = maskVal
             self.assertEqual(afwMath.makeStatistics(image, mask, afwMath.NMASKED, ctrl).getValue(), 1)
 
+    def testUnweightedMoments(self):
+        """Test the unweighted moments of masked, non-finite, and odd-width images against numpy"""
+        rng = np.random.RandomState(12345)
+        maskVal = 0x4
+        ctrl = afwMath.StatisticsControl()
+        ctrl.setAndMask(maskVal)
+        flags = afwMath.NPOINT | afwMath.MEAN | afwMath.STDEV | afwMath.VARIANCE | afwMath.MIN | afwMath.MAX
+
+        for width in (1, 7, 8, 9, 101):  # exercise partial blocks of pixels
+            for ImageClass in (afwImage.ImageF, afwImage.ImageD):
+                image = ImageClass(lsst.geom.Extent2I(width, 13))
+                image.array[:] = rng.normal(1000.0, 10.0, image.array.shape)
+                image.array[rng.uniform(size=image.array.shape) < 0.05] = np.nan
+                image.array[rng.uniform(size=image.array.shape) < 0.05] = np.inf
+                mask = afwImage.Mask(image.getBBox())
+                mask.array[:] = np.where(rng.uniform(size=mask.array.shape) < 0.1, maskVal, 0x1)
+
+                good = np.isfinite(image.array) & (mask.array & maskVal == 0)
+                values = image.array[good].astype(np.float64)
+
+                stats = afwMath.makeStatistics(image, mask, flags, ctrl)
+                self.assertEqual(stats.getValue(afwMath.NPOINT), len(values))
+                self.assertEqual(stats.getValue(afwMath.MIN), values.min())
+                self.assertEqual(stats.getValue(afwMath.MAX), values.max())
+                self.assertFloatsAlmostEqual(stats.getValue(afwMath.MEAN), values.mean(), rtol=1e-12)
+                if len(values) > 1:
+                    self.assertFloatsAlmostEqual(stats.getValue(afwMath.VARIANCE), values.var(ddof=1),
+                                                 rtol=1e-10)
+                    self.assertFloatsAlmostEqual(stats.getValue(afwMath.STDEV), values.std(ddof=1),
+                                                 rtol=1e-10)
+
+    def testLargeImageQuantiles(self):
+        """Test the median and quartiles of images large enough not to be copied, exactly and approximately
+        """
+        rng = np.random.RandomState(12345)
+        maskVal = 0x4
+        for ImageClass in (afwImage.ImageF, afwImage.ImageD):
+            image = ImageClass(lsst.geom.Extent2I(400, 300))
+            image.array[:] = rng.normal(1000.0, 10.0, image.array.shape)
+            image.array[:, :10] = np.round(image.array[:, :10])  # some ties
+            image.array[rng.uniform(size=image.array.shape) < 0.01] = np.nan
+            image.array[rng.uniform(size=image.array.shape) < 0.01] = -1e30
+            mask = afwImage.Mask(image.getBBox())
+            mask.array[:] = np.where(rng.uniform(size=mask.array.shape) < 0.1, maskVal, 0x0)
+
+            good = np.isfinite(image.array) & (mask.array & maskVal == 0)
+            q1, median, q3 = np.percentile(image.array[good].astype(np.float64), [25, 50, 75])
+
+            ctrl = afwMath.StatisticsControl()
+            ctrl.setAndMask(maskVal)
+            stats = afwMath.makeStatistics(image, mask, afwMath.MEDIAN | afwMath.IQRANGE, ctrl)
+            self.assertFloatsAlmostEqual(stats.getValue(afwMath.MEDIAN), median, rtol=1e-14)
+            self.assertFloatsAlmostEqual(stats.getValue(afwMath.IQRANGE), q3 - q1, rtol=1e-12)
+            self.assertEqual(stats.getQuantileErrorBound(), 0.0)
+            stats = afwMath.makeStatistics(image, mask, afwMath.MEDIAN, ctrl)
+            self.assertFloatsAlmostEqual(stats.getValue(afwMath.MEDIAN), median, rtol=1e-14)
+
+            for tolerance in (1e-3, 0.1, 10.0):
+                ctrl.setQuantileTolerance(tolerance)
+                stats = afwMath.makeStatistics(image, mask, afwMath.MEDIAN | afwMath.IQRANGE, ctrl)
+                errorBound = stats.getQuantileErrorBound()
+                self.assertLessEqual(errorBound, tolerance)
+                self.assertLessEqual(abs(stats.getValue(afwMath.MEDIAN) - median), errorBound + 1e-10)
+                self.assertLessEqual(abs(stats.getValue(afwMath.IQRANGE) - (q3 - q1)), 2*errorBound + 1e-10)
+
 
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
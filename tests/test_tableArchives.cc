@@ -347,6 +347,22 @@ std::vector<ndarray::Vector<std::shared_ptr<Comparable>, M>> roundtripAndCompare
         outputs.back()[i] = outObj;
     }
 
+    // Round-trip and compare once more, reading the data catalogs from the FITS file only when needed
+    outputs.push_back(ndarray::Vector<std::shared_ptr<Comparable>, M>());
+    fits::Fits inFits3(manager, "r", fits::Fits::AUTO_CHECK);
+    inFits3.setHdu(fits::DEFAULT_HDU);
+    int const indexHdu = inFits3.getHdu();
+    InputArchive inArchive3 = InputArchive::readFits(inFits3, true);
+    BOOST_CHECK_EQUAL(inFits3.getHdu(), indexHdu);
+    for (int i = 0; i < M; ++i) {
+        std::shared_ptr<Comparable> outObj =
+                std::dynamic_pointer_cast<Comparable>(inArchive3.get(inputIds[i]));
+        BOOST_CHECK_EQUAL(*outObj, *inputs[i]);
+        BOOST_CHECK_EQUAL(inFits3.getHdu(), indexHdu);
+        outputs.back()[i] = outObj;
+    }
+    inFits3.closeFile();
+
     return outputs;
 }
 
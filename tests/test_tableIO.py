@@ -26,6 +26,7 @@ import numpy as np
 import astropy.io.fits
 
 import lsst.utils.tests
+import lsst.pex.exceptions
 import lsst.geom
 import lsst.afw.table
 import lsst.afw.image
@@ -102,6 +103,135 @@ class TableIoTestCase(lsst.utils.tests.TestCase):
             self.assertFloatsEqual(larger[bb], larger2[bb])
             self.assertFloatsEqual(larger[cc], larger2[cc])
 
+    def testPackedRows(self):
+        """Test that rows packed in memory by FitsWriter round-trip, and
+        agree with an independent FITS reader.
+        """
+        schema = lsst.afw.table.Schema()
+        keys = {
+            "u": schema.addField("u", type=np.uint16, doc="u"),
+            "i": schema.addField("i", type=np.int32, doc="i"),
+            "l": schema.addField("l", type=np.int64, doc="l"),
+            "f": schema.addField("f", type=np.float32, doc="f"),
+            "d": schema.addField("d", type=np.float64, doc="d"),
+            "b": schema.addField("b", type="ArrayB", doc="b", size=3),
+            "au": schema.addField("au", type="ArrayU", doc="au", size=2),
+            "ad": schema.addField("ad", type="ArrayD", doc="ad", size=4),
+        }
+        angleKey = schema.addField("a", type="Angle", doc="a")
+        stringKey = schema.addField("s", type=str, doc="s", size=5)
+        flagKeys = [schema.addField("flag%d" % i, type="Flag", doc="flag") for i in range(11)]
+        nRows = 1000
+        rng = np.random.RandomState(5)
+        cat = lsst.afw.table.BaseCatalog(schema)
+        cat.resize(nRows)
+        cat["u"] = rng.randint(0, 1 << 16, size=nRows)
+        cat["i"] = rng.randint(-1 << 31, 1 << 31, size=nRows)
+        cat["l"] = rng.randint(-1 << 62, 1 << 62, size=nRows, dtype=np.int64)
+        cat["f"] = rng.randn(nRows)
+        cat["d"] = rng.randn(nRows)
+        cat["b"] = rng.randint(0, 256, size=(nRows, 3))
+        cat["au"] = rng.randint(0, 1 << 16, size=(nRows, 2))
+        cat["ad"] = rng.randn(nRows, 4)
+        cat[angleKey] = rng.randn(nRows)
+        flags = rng.rand(nRows, len(flagKeys)) < 0.5
+        strings = ["", "a", "abcde", "xyz"]
+        for n, record in enumerate(cat):
+            record.set(stringKey, strings[n % len(strings)])
+            for key, value in zip(flagKeys, flags[n]):
+                record.set(key, bool(value))
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            cat.writeFits(tmpFile)
+            cat2 = lsst.afw.table.BaseCatalog.readFits(tmpFile)
+            with astropy.io.fits.open(tmpFile) as inFits:
+                data = inFits[1].data
+                for name in keys:
+                    self.assertFloatsEqual(data[name], cat[name])
+                self.assertFloatsEqual(data["a"], cat[angleKey])
+                self.assertEqual(list(data["s"]), [strings[n % len(strings)] for n in range(nRows)])
+                self.assertTrue(np.all(data["flags"] == flags))
+        for name, key in keys.items():
+            self.assertFloatsEqual(cat2[key], cat[key])
+        self.assertFloatsEqual(cat2[angleKey], cat[angleKey])
+        for n, record in enumerate(cat2):
+            self.assertEqual(record.get(stringKey), strings[n % len(strings)])
+            self.assertEqual([record.get(key) for key in flagKeys], list(flags[n]))
+
+    def testConvertedColumns(self):
+        """Test that columns whose FITS representation differs from what the
+        raw row unpacking expects are read by CFITSIO, alongside columns that
+        are unpacked from raw rows.
+        """
+        nRows = 50
+        rng = np.random.RandomState(7)
+        raw = rng.randn(nRows)
+        wide = rng.randint(-1000, 1000, size=(nRows, 2)).astype(np.int64)
+        signed = rng.randint(0, 1000, size=nRows).astype(np.int16)
+        scaled = rng.randint(-100, 100, size=nRows).astype(np.float32)
+        columns = [
+            astropy.io.fits.Column(name="raw", format="D", array=raw),
+            # 64-bit integer arrays are read into float array fields
+            astropy.io.fits.Column(name="wide", format="2K", array=wide),
+            # 16-bit integers are read as unsigned, but these have no TZERO
+            astropy.io.fits.Column(name="signed", format="I", array=signed),
+            astropy.io.fits.Column(name="scaled", format="E", bscale=0.5, bzero=3.0, array=scaled),
+        ]
+        nThreads = lsst.afw.table.io.getNumReadThreads()
+        lsst.afw.table.io.setNumReadThreads(4)
+        try:
+            with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+                astropy.io.fits.BinTableHDU.from_columns(columns).writeto(tmpFile)
+                cat = lsst.afw.table.BaseCatalog.readFits(tmpFile)
+        finally:
+            lsst.afw.table.io.setNumReadThreads(nThreads)
+        self.assertFloatsEqual(cat["raw"], raw)
+        self.assertFloatsEqual(cat["wide"], wide.astype(np.float32))
+        self.assertFloatsEqual(cat["signed"], signed)
+        self.assertFloatsAlmostEqual(cat["scaled"], scaled, atol=1E-6)
+
+    def testSelectedFields(self):
+        """Test reading a subset of the fields of a catalog, with raw rows
+        unpacked by multiple threads.
+        """
+        schema = lsst.afw.table.Schema()
+        aa = schema.addField("a", type=np.float64, doc="a")
+        bb = schema.addField("b", type=np.int32, doc="b")
+        cc = schema.addField("c", type="ArrayF", doc="c", size=3)
+        dd = schema.addField("d", type=np.uint16, doc="d")
+        flagKeys = [schema.addField("flag%d" % i, type="Flag", doc="flag") for i in range(10)]
+        schema.getAliasMap().set("e", "d")
+        nRows = 100
+        rng = np.random.RandomState(6)
+        cat = lsst.afw.table.BaseCatalog(schema)
+        cat.resize(nRows)
+        cat[aa] = rng.randn(nRows)
+        cat[bb] = rng.randint(-1000, 1000, size=nRows)
+        cat[cc] = rng.randn(nRows, 3)
+        cat[dd] = rng.randint(0, 1 << 16, size=nRows)
+        flags = rng.rand(nRows, len(flagKeys)) < 0.5
+        for record, values in zip(cat, flags):
+            for key, value in zip(flagKeys, values):
+                record.set(key, bool(value))
+        nThreads = lsst.afw.table.io.getNumReadThreads()
+        lsst.afw.table.io.setNumReadThreads(4)
+        try:
+            with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+                cat.writeFits(tmpFile)
+                full = lsst.afw.table.BaseCatalog.readFits(tmpFile)
+                selected = lsst.afw.table.BaseCatalog.readFits(tmpFile, ["c", "e", "flag3"])
+                with self.assertRaises(lsst.pex.exceptions.NotFoundError):
+                    lsst.afw.table.BaseCatalog.readFits(tmpFile, ["a", "nonexistent"])
+        finally:
+            lsst.afw.table.io.setNumReadThreads(nThreads)
+        self.assertEqual(full.schema, schema)
+        for name in ("a", "b", "c", "d"):
+            self.assertFloatsEqual(full[name], cat[name])
+        self.assertEqual([[record.get(key) for key in flagKeys] for record in full], flags.tolist())
+        self.assertEqual(selected.schema.getNames(), {"c", "d", "flag3"})
+        self.assertFloatsEqual(selected["c"], cat[cc])
+        self.assertFloatsEqual(selected["d"], cat[dd])
+        self.assertEqual([record.get("flag3") for record in selected], flags[:, 3].tolist())
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
@@ -174,6 +174,36 @@ class CameraTransformMapTestCase(lsst.utils.tests.TestCase):
                         fromPoint, fromSys, toSys)
                     self.assertPairsAlmostEqual(predToPoint, toPoint)
 
+    def testCachedTransforms(self):
+        """Test that transform gives the same results as getTransform for
+        affine, non-affine and composed transforms, on repeated calls
+        """
+        pixelSys = cameraGeom.CameraSys(cameraGeom.PIXELS, "det1")
+        affine = lsst.geom.AffineTransform(lsst.geom.LinearTransform.makeRotation(0.3*lsst.geom.radians)
+                                           * lsst.geom.LinearTransform.makeScaling(0.01),
+                                           lsst.geom.Extent2D(-20.0, 35.0))
+        transformMap = cameraGeom.TransformMap(
+            self.nativeSys,
+            {cameraGeom.FIELD_ANGLE: self.fieldTransform,
+             pixelSys: afwGeom.makeTransform(affine).inverted()})
+        pixelList = [lsst.geom.Point2D(x, y) for x in (-1500.0, 0.0, 25.3, 4000.0) for y in (-23.4, 2048.5)]
+
+        for fromSys in transformMap:
+            # stay within the domain where the inverse of the radial transform is defined
+            fromList = [transformMap.transform(point, pixelSys, fromSys) for point in pixelList]
+            for toSys in transformMap:
+                for _ in range(2):
+                    transform = transformMap.getTransform(fromSys, toSys)
+                    self.assertIsNot(transform, transformMap.getTransform(fromSys, toSys))
+                    toList = transformMap.transform(fromList, fromSys, toSys)
+                    for fromPoint, toPoint in zip(fromList, toList):
+                        self.assertPairsAlmostEqual(transform.applyForward(fromPoint), toPoint,
+                                                    maxDiff=1e-9*max(1.0, abs(toPoint[0]), abs(toPoint[1])))
+                        self.assertPairsAlmostEqual(transformMap.transform(fromPoint, fromSys, toSys),
+                                                    toPoint, maxDiff=0.0)
+        self.assertPairsAlmostEqual(transformMap.transform(pixelList[0], self.nativeSys, pixelSys),
+                                    affine.inverted()(pixelList[0]))
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
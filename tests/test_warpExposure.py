@@ -21,6 +21,7 @@
 
 """Test warpExposure
 """
+import itertools
 import os
 import unittest
 
@@ -233,6 +234,16 @@ class WarpExposureTestCase(lsst.utils.tests.TestCase):
                 self.assertEqual(
                     wc.getMaskWarpingKernel().getCacheSize(), newCacheSize)
 
+        wc = afwMath.WarpingControl("lanczos3")
+        self.assertEqual(wc.getMaxInterpError(), 0)
+        for maxInterpError in (0.01, 0.0):
+            wc.setMaxInterpError(maxInterpError)
+            self.assertEqual(wc.getMaxInterpError(), maxInterpError)
+        self.assertEqual(wc.getNumThreads(), 1)
+        for numThreads in (0, 1, 4):
+            wc.setNumThreads(numThreads)
+            self.assertEqual(wc.getNumThreads(), numThreads)
+
     def testWarpingControlError(self):
         """Test error handling of WarpingControl
         """
@@ -387,6 +398,139 @@ class WarpExposureTestCase(lsst.utils.tests.TestCase):
             self.assertImagesAlmostEqual(afwWarpedImage, swarpedImage,
                                          skipMask=noDataMaskArr, rtol=rtol, atol=atol)
 
+    def testWarpThreads(self):
+        """Test that warping with several threads gives exactly the same result as with one
+        """
+        srcWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(10, 11),
+            crval=lsst.geom.SpherePoint(41.7, 32.9, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.2*lsst.geom.degrees),
+        )
+        destWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(9, 10),
+            crval=lsst.geom.SpherePoint(41.65, 32.95, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.17*lsst.geom.degrees, orientation=20*lsst.geom.degrees),
+        )
+
+        srcMaskedImage = afwImage.MaskedImageF(100, 101)
+        srcArrays = srcMaskedImage.getArrays()
+        shape = srcArrays[0].shape
+        srcArrays[0][:] = np.random.normal(10000, 1000, size=shape)
+        srcArrays[1][:] = np.random.randint(0, 1 << 8, size=shape)
+        srcArrays[2][:] = np.random.normal(9000, 900, size=shape)
+        srcToDest = afwGeom.makeWcsPairTransform(srcWcs, destWcs)
+
+        for kernelName, maskKernelName, cacheSize, interpLength in (
+            ("lanczos3", "", 0, 0),
+            ("lanczos3", "bilinear", 10000, 10),
+            ("bilinear", "", 0, 7),
+        ):
+            warpingControl = afwMath.WarpingControl(kernelName, maskKernelName, cacheSize, interpLength)
+            serialMaskedImage = afwImage.MaskedImageF(110, 121)
+            serialNumGoodPix = afwMath.warpImage(serialMaskedImage, srcMaskedImage, srcToDest,
+                                                 warpingControl)
+            self.assertGreater(serialNumGoodPix, 0)
+            serialImage = afwImage.ImageF(110, 121)
+            afwMath.warpImage(serialImage, srcMaskedImage.getImage(), srcToDest, warpingControl)
+            for numThreads in (2, 3, 8):
+                warpingControl.setNumThreads(numThreads)
+                msg = f"kernelName={kernelName}; interpLength={interpLength}; numThreads={numThreads}"
+                with self.subTest(msg=msg):
+                    destMaskedImage = afwImage.MaskedImageF(110, 121)
+                    numGoodPix = afwMath.warpImage(destMaskedImage, srcMaskedImage, srcToDest,
+                                                   warpingControl)
+                    self.assertEqual(numGoodPix, serialNumGoodPix)
+                    self.assertMaskedImagesEqual(destMaskedImage, serialMaskedImage)
+
+                    destImage = afwImage.ImageF(110, 121)
+                    afwMath.warpImage(destImage, srcMaskedImage.getImage(), srcToDest, warpingControl)
+                    self.assertImagesEqual(destImage, serialImage)
+
+    def testMaxInterpError(self):
+        """Test that the interpolation length is reduced as needed to meet maxInterpError
+        """
+        srcWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(10, 11),
+            crval=lsst.geom.SpherePoint(41.7, 32.9, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.2*lsst.geom.degrees),
+        )
+        destWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(9, 10),
+            crval=lsst.geom.SpherePoint(41.65, 32.95, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.17*lsst.geom.degrees, orientation=20*lsst.geom.degrees),
+        )
+        srcToDest = afwGeom.makeWcsPairTransform(srcWcs, destWcs)
+
+        srcMaskedImage = afwImage.MaskedImageF(100, 101)
+        srcArrays = srcMaskedImage.getArrays()
+        shape = srcArrays[0].shape
+        srcArrays[0][:] = np.random.normal(10000, 1000, size=shape)
+        srcArrays[2][:] = np.random.normal(9000, 900, size=shape)
+
+        def warp(interpLength, maxInterpError=0):
+            warpingControl = afwMath.WarpingControl("lanczos3", "", 0, interpLength)
+            warpingControl.setMaxInterpError(maxInterpError)
+            destMaskedImage = afwImage.MaskedImageF(110, 121)
+            afwMath.warpImage(destMaskedImage, srcMaskedImage, srcToDest, warpingControl)
+            return destMaskedImage
+
+        # these WCS are far from linear over 8 pixels, so a tiny error bound forces exact evaluation
+        self.assertMaskedImagesEqual(warp(interpLength=8, maxInterpError=1e-10), warp(interpLength=0))
+        # a huge error bound accepts the maximum interpolation length
+        self.assertMaskedImagesEqual(warp(interpLength=8, maxInterpError=1e10), warp(interpLength=8))
+        # a reasonable error bound gives a result close to exact
+        self.assertMaskedImagesAlmostEqual(warp(interpLength=32, maxInterpError=1e-3), warp(interpLength=0),
+                                           rtol=1e-2)
+
+    def testSpecializedWarpingKernels(self):
+        """Test that the code specialized for Lanczos and bilinear warping kernels gives exactly the same
+        result as the generic code used for other separable kernels, with and without a mask warping kernel
+        """
+        srcWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(10, 11),
+            crval=lsst.geom.SpherePoint(41.7, 32.9, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.2*lsst.geom.degrees),
+        )
+        destWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(9, 10),
+            crval=lsst.geom.SpherePoint(41.65, 32.95, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.17*lsst.geom.degrees, orientation=20*lsst.geom.degrees),
+        )
+        srcToDest = afwGeom.makeWcsPairTransform(srcWcs, destWcs)
+
+        srcMaskedImage = afwImage.MaskedImageF(100, 101)
+        srcArrays = srcMaskedImage.getArrays()
+        shape = srcArrays[0].shape
+        srcArrays[0][:] = np.random.normal(10000, 1000, size=shape)
+        srcArrays[1][:] = np.random.randint(0, 1 << 8, size=shape)
+        srcArrays[2][:] = np.random.normal(9000, 900, size=shape)
+        srcArrays[0][50, 40] = np.nan
+
+        kernels = {"bilinear": (2, afwMath.BilinearWarpingKernel.BilinearFunction1(0.0))}
+        for order in (2, 3, 5):
+            kernels[f"lanczos{order}"] = (2*order, afwMath.LanczosFunction1D(order))
+        for kernelName, (size, function) in kernels.items():
+            for cacheSize, maskKernelName in itertools.product((0, 10000), ("", "bilinear", "nearest")):
+                specializedControl = afwMath.WarpingControl(kernelName, maskKernelName, cacheSize, 5)
+                genericControl = afwMath.WarpingControl(kernelName, maskKernelName, cacheSize, 5)
+                genericControl.setWarpingKernel(afwMath.SeparableKernel(size, size, function, function))
+                with self.subTest(kernelName=kernelName, cacheSize=cacheSize, maskKernelName=maskKernelName):
+                    specializedMaskedImage = afwImage.MaskedImageF(110, 121)
+                    genericMaskedImage = afwImage.MaskedImageF(110, 121)
+                    numGoodPix = afwMath.warpImage(specializedMaskedImage, srcMaskedImage, srcToDest,
+                                                   specializedControl)
+                    self.assertGreater(numGoodPix, 0)
+                    self.assertEqual(afwMath.warpImage(genericMaskedImage, srcMaskedImage, srcToDest,
+                                                       genericControl), numGoodPix)
+                    self.assertMaskedImagesEqual(specializedMaskedImage, genericMaskedImage)
+
+                    specializedImage = afwImage.ImageF(110, 121)
+                    genericImage = afwImage.ImageF(110, 121)
+                    afwMath.warpImage(specializedImage, srcMaskedImage.getImage(), srcToDest,
+                                      specializedControl)
+                    afwMath.warpImage(genericImage, srcMaskedImage.getImage(), srcToDest, genericControl)
+                    self.assertImagesEqual(specializedImage, genericImage)
+
     def testTicket2441(self):
         """Test ticket 2441: warpExposure sometimes mishandles zero-extent dest exposures"""
         fromWcs = afwGeom.makeSkyWcs(